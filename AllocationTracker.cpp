@@ -0,0 +1,163 @@
+#include "AllocationTracker.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    /*
+    The counters. They are constant initialized, so they are ready before the first
+    allocation of the program (which may come before any constructor has run).
+    */
+    std::atomic<uint64_t> process_allocations{0};
+    std::atomic<uint64_t> process_deallocations{0};
+    std::atomic<uint64_t> process_bytes{0};
+    std::atomic<uint64_t> process_violations{0};
+    thread_local AllocationTracker::Counts thread_counts;
+
+    // The name of the innermost NO_ALLOC_SCOPE the thread is in, if any
+    thread_local const char* forbidden_scope = nullptr;
+
+#ifdef CHESS_TRACK_ALLOCATIONS
+    void countAllocation(const std::size_t& size) {
+        process_allocations.fetch_add(1, std::memory_order_relaxed);
+        process_bytes.fetch_add(size, std::memory_order_relaxed);
+        thread_counts.allocations++;
+        thread_counts.bytes += size;
+
+        if (forbidden_scope) {
+            process_violations.fetch_add(1, std::memory_order_relaxed);
+            thread_counts.violations++;
+#ifndef NDEBUG
+            // stdio, as a stream could allocate while reporting
+            const char* scope = forbidden_scope;
+            forbidden_scope = nullptr;
+            std::fprintf(stderr, "Allocation of %zu bytes inside NO_ALLOC_SCOPE(\"%s\")\n", size, scope);
+            std::abort();
+#endif
+        }
+    }
+
+    void countDeallocation(void* pointer) {
+        if (!pointer) { return; }
+        process_deallocations.fetch_add(1, std::memory_order_relaxed);
+        thread_counts.deallocations++;
+    }
+
+    void* allocate(std::size_t size) {
+        countAllocation(size);
+        return std::malloc(size ? size : 1);
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+        countAllocation(size);
+        // aligned_alloc() wants a size that is a multiple of the alignment
+        std::size_t align = static_cast<std::size_t>(alignment);
+        std::size_t rounded = (size + align - 1) / align * align;
+        return std::aligned_alloc(align, rounded ? rounded : align);
+    }
+
+    void release(void* pointer) {
+        countDeallocation(pointer);
+        std::free(pointer);
+    }
+#endif
+}
+
+/**
+ * Gets the counts of the whole process.
+ */
+AllocationTracker::Counts AllocationTracker::process() {
+    Counts counts;
+    counts.allocations = process_allocations.load(std::memory_order_relaxed);
+    counts.deallocations = process_deallocations.load(std::memory_order_relaxed);
+    counts.bytes = process_bytes.load(std::memory_order_relaxed);
+    counts.violations = process_violations.load(std::memory_order_relaxed);
+    return counts;
+}
+
+/**
+ * Gets the counts of the calling thread.
+ */
+AllocationTracker::Counts AllocationTracker::thread() {
+    return thread_counts;
+}
+
+AllocationTracker::NoAllocGuard::NoAllocGuard(const char* name) : previous_name_{forbidden_scope} {
+    forbidden_scope = name;
+}
+
+AllocationTracker::NoAllocGuard::~NoAllocGuard() {
+    forbidden_scope = previous_name_;
+}
+
+#ifdef CHESS_TRACK_ALLOCATIONS
+/*
+The replacements of the global allocation functions. Every other form (sized delete,
+nothrow delete, ...) forwards to one of these by default, apart from those below.
+*/
+void* operator new(std::size_t size) {
+    void* pointer = allocate(size);
+    if (!pointer) { throw std::bad_alloc(); }
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    void* pointer = allocate(size);
+    if (!pointer) { throw std::bad_alloc(); }
+    return pointer;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* pointer = allocateAligned(size, alignment);
+    if (!pointer) { throw std::bad_alloc(); }
+    return pointer;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    void* pointer = allocateAligned(size, alignment);
+    if (!pointer) { throw std::bad_alloc(); }
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    release(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    release(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    release(pointer);
+}
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @brief Heap allocation counting, and scopes in which allocating is a bug.
+ *
+ * In an instrumentation build (`make TRACK_ALLOCATIONS=1`, which defines
+ * CHESS_TRACK_ALLOCATIONS) the global operator new and delete are replaced by versions
+ * that count every allocation, per thread and over the whole process.
+ *
+ * NO_ALLOC_SCOPE("name") marks the rest of the enclosing scope as allocation free:
+ * an allocation inside it is counted as a violation and, unless NDEBUG is defined,
+ * reported on stderr before the program aborts. Scopes nest, and the innermost name
+ * is reported.
+ *
+ * In a normal build nothing is replaced, NO_ALLOC_SCOPE expands to nothing and every
+ * count reads 0.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#ifdef CHESS_TRACK_ALLOCATIONS
+#define NO_ALLOC_CONCAT_(a, b) a##b
+#define NO_ALLOC_CONCAT(a, b) NO_ALLOC_CONCAT_(a, b)
+#define NO_ALLOC_SCOPE(name) AllocationTracker::NoAllocGuard NO_ALLOC_CONCAT(no_alloc_guard_, __LINE__)(name)
+#else
+#define NO_ALLOC_SCOPE(name)
+#endif
+
+namespace AllocationTracker {
+#ifdef CHESS_TRACK_ALLOCATIONS
+    const bool ENABLED = true;
+#else
+    const bool ENABLED = false;
+#endif
+
+    /*
+    Allocation counts, since the start of the program (or of the thread).
+    */
+    struct Counts {
+        uint64_t allocations = 0;
+        uint64_t deallocations = 0;
+        uint64_t bytes = 0;       // Requested by the allocations
+        uint64_t violations = 0;  // Allocations made inside a NO_ALLOC_SCOPE
+    };
+
+    /**
+     * Gets the counts of the whole process.
+     */
+    Counts process();
+
+    /**
+     * Gets the counts of the calling thread.
+     */
+    Counts thread();
+
+    /**
+     * Forbids the calling thread to allocate for as long as it lives. Use it through NO_ALLOC_SCOPE.
+     * `name` must be a string literal (only the pointer is kept).
+     */
+    class NoAllocGuard {
+        private:
+            const char* previous_name_;
+
+        public:
+            explicit NoAllocGuard(const char* name);
+            ~NoAllocGuard();
+
+            NoAllocGuard(const NoAllocGuard& other) = delete;
+            NoAllocGuard& operator=(const NoAllocGuard& other) = delete;
+    };
+};
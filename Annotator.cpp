@@ -0,0 +1,143 @@
+#include "Annotator.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "Notation.hpp"
+
+namespace {
+    /*
+    Mate scores are capped so a missed mate counts as a large, but finite, loss.
+    */
+    const int SCORE_CAP = 1000;
+
+    /*
+    The engine's view of one position: its score and best move (if there are legal moves).
+    */
+    struct Analysis {
+        int score = 0;
+        std::string best_san;
+        std::string best_uci;
+    };
+
+    Analysis analyse(ChessBoard& board, Search& search, const SearchLimits& limits) {
+        Analysis analysis;
+        std::vector<PVLine> lines = search.run(board, limits);
+        if (lines.empty()) {
+            analysis.score = board.isInCheck() ? -Search::MATE_SCORE : 0;
+            return analysis;
+        }
+
+        const Move& best = lines[0].moves[0];
+        analysis.score = lines[0].score;
+        analysis.best_uci = best.toUCI();
+        analysis.best_san = Notation::toSAN(board, best, board.generateMoves());
+        return analysis;
+    }
+}
+
+/**
+ * @brief Constructs an annotator that writes its JSON lines to `out`
+ */
+Annotator::Annotator(std::ostream& out, const AnnotatorOptions& options)
+    : options_{options}, out_{out} {}
+
+/**
+ * @brief Classifies a move by the centipawns it lost: "good", "inaccuracy", "mistake" or "blunder"
+ */
+std::string Annotator::classify(const int& loss) {
+    if (loss >= BLUNDER_LOSS) { return "blunder"; }
+    if (loss >= MISTAKE_LOSS) { return "mistake"; }
+    if (loss >= INACCURACY_LOSS) { return "inaccuracy"; }
+    return "good";
+}
+
+/**
+ * @brief Escapes `text` for use inside a JSON string
+ */
+std::string Annotator::escapeJSON(const std::string& text) {
+    std::string escaped;
+    for (char symbol : text) {
+        if (symbol == '"' || symbol == '\\') { escaped += '\\'; }
+        if (static_cast<unsigned char>(symbol) < 0x20) { continue; }
+        escaped += symbol;
+    }
+    return escaped;
+}
+
+/**
+ * @brief Annotates every ply of `game`
+ * @return The game's JSON object, on a single line.
+ */
+std::string Annotator::annotate(const GameRecord& game, EngineContext& engine) {
+    ChessBoard& board = engine.board;
+    Search& search = engine.search;
+    std::ostringstream json;
+    json << "{\"game\":" << game.index << ",\"tags\":{";
+    for (size_t i = 0; i < game.tags.size(); i++) {
+        json << (i ? "," : "") << "\"" << escapeJSON(game.tags[i].first) << "\":\"" << escapeJSON(game.tags[i].second) << "\"";
+    }
+    json << "},\"result\":\"" << escapeJSON(game.result) << "\",\"plies\":[";
+
+    std::string error;
+    if (!board.loadFEN(game.tag("FEN", ChessBoard::STARTING_FEN))) {
+        error = "invalid FEN";
+    }
+
+    // Every game starts from an empty table so results do not depend on scheduling
+    engine.table.clear();
+    SearchLimits limits;
+    limits.nodes = options_.nodes;
+
+    Analysis current;
+    if (error.empty()) { current = analyse(board, search, limits); }
+
+    for (size_t ply = 0; ply < game.moves.size() && error.empty(); ply++) {
+        std::vector<Move> legal = board.generateMoves();
+        int index = Notation::findMove(board, legal, game.moves[ply]);
+        if (index < 0) {
+            error = "illegal move " + game.moves[ply] + " at ply " + std::to_string(ply + 1);
+            break;
+        }
+
+        const Move& played = legal[index];
+        std::string san = Notation::toSAN(board, played, legal);
+        board.makeMove(played);
+
+        // The played move scores whatever the opponent's best reply leaves us
+        Analysis next = analyse(board, search, limits);
+        int best_score = std::clamp(current.score, -SCORE_CAP, SCORE_CAP);
+        int played_score = std::clamp(-next.score, -SCORE_CAP, SCORE_CAP);
+        bool is_best = played.toUCI() == current.best_uci;
+        int loss = is_best ? 0 : std::max(0, best_score - played_score);
+
+        json << (ply ? "," : "") << "{\"ply\":" << (ply + 1)
+             << ",\"move\":\"" << san << "\",\"uci\":\"" << played.toUCI() << "\""
+             << ",\"eval\":" << played_score
+             << ",\"best\":\"" << current.best_san << "\",\"best_uci\":\"" << current.best_uci << "\""
+             << ",\"best_eval\":" << best_score
+             << ",\"loss\":" << loss
+             << ",\"class\":\"" << (is_best ? "best" : classify(loss)) << "\"}";
+
+        current = next;
+    }
+
+    json << "]";
+    if (!error.empty()) { json << ",\"error\":\"" << escapeJSON(error) << "\""; }
+    json << "}";
+    return json.str();
+}
+
+/**
+ * @brief Annotates every game read from the PGN stream `in`
+ * @return The number of games annotated.
+ */
+size_t Annotator::run(std::istream& in) {
+    CorpusPipeline pipeline(out_, options_.threads);
+    return pipeline.run(in, [this]() {
+        auto engine = std::make_shared<EngineContext>(options_.table_megabytes);
+        return [this, engine](const GameRecord& game) { return annotate(game, *engine) + "\n"; };
+    });
+}
@@ -0,0 +1,70 @@
+/**
+ * @class Annotator
+ * @brief Annotates whole game corpora with engine evaluations.
+ *
+ * Every ply of every game is searched with a fixed node budget, giving the engine's
+ * evaluation, its best move and a classification of the move that was played
+ * (best, good, inaccuracy, mistake or blunder, by the centipawns it lost).
+ *
+ * Games are streamed from a PGN input through a CorpusPipeline, so they are spread
+ * across worker threads (each with its own board, search and transposition table)
+ * and results are written in input order with bounded memory use.
+ *
+ * Output is JSON Lines: one object per game, with one entry per ply.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include "CorpusPipeline.hpp"
+
+/**
+ * The settings of an annotation run.
+ */
+struct AnnotatorOptions {
+    uint64_t nodes = 20000;        // Node budget of every per-position search
+    int threads = 1;               // Number of games annotated in parallel
+    size_t table_megabytes = 16;   // Transposition table size of each thread
+};
+
+class Annotator {
+    public:
+        // Centipawns lost by the played move (compared to the best move) for each classification
+        static const int INACCURACY_LOSS = 50;
+        static const int MISTAKE_LOSS = 100;
+        static const int BLUNDER_LOSS = 300;
+
+    private:
+        AnnotatorOptions options_;
+        std::ostream& out_;
+
+        /**
+         * @brief Annotates every ply of `game`
+         * @return The game's JSON object, on a single line.
+         */
+        std::string annotate(const GameRecord& game, EngineContext& engine);
+
+    public:
+        /**
+         * @brief Constructs an annotator that writes its JSON lines to `out`
+         */
+        Annotator(std::ostream& out, const AnnotatorOptions& options);
+
+        /**
+         * @brief Annotates every game read from the PGN stream `in`
+         * @return The number of games annotated.
+         */
+        size_t run(std::istream& in);
+
+        /**
+         * @brief Classifies a move by the centipawns it lost: "good", "inaccuracy", "mistake" or "blunder"
+         */
+        static std::string classify(const int& loss);
+
+        /**
+         * @brief Escapes `text` for use inside a JSON string
+         */
+        static std::string escapeJSON(const std::string& text);
+};
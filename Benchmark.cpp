@@ -0,0 +1,67 @@
+#include "Benchmark.hpp"
+
+#include <chrono>
+
+#include "ChessBoard.hpp"
+#include "Search.hpp"
+#include "TranspositionTable.hpp"
+
+namespace {
+    /*
+    Openings, middlegames and endgames taken from engine games, with both players to move.
+    Changing this list changes the signature.
+    */
+    const std::vector<std::string> BENCH_POSITIONS = {
+        "rnbkqbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBKQBNR w - - 0 1",
+        "rnbkqbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBKQBNR b - - 0 1",
+        "r1bkqb1r/ppp2ppp/3p1n2/3Pp3/3nP3/2N2N2/PPP2PPP/R1BKQB1R w - - 0 1",
+        "r2kqb1r/ppp2ppp/2n2n2/3ppb2/3P4/2N1BN2/PPP1PPPP/R1K1QB1R w - - 0 1",
+        "r2k3r/pppqbppp/3p4/3n2B1/4P3/3P4/PP2NPPP/R2KQ2R w - - 0 1",
+        "r1k4r/ppp2ppp/3bqn2/3p1b2/8/P1N1B3/RPPQPPPP/1K3B1R w - - 0 1",
+        "r2k3r/ppp2ppp/3b1n2/3N1q2/2n5/2Q1B3/PPP1PPPP/RK3B1R b - - 0 1",
+        "rk1r4/pp1q1ppp/3b4/3bn3/2p1p3/1NQ1B3/PPP1PPPP/RK3B1R b - - 0 1",
+        "r2k1b1r/ppp2ppp/3p1n2/3Pqb2/3p1N2/3B4/PPP2PPP/R1BKQ2R w - - 0 1",
+        "rk1r4/ppp2ppp/4q3/2Q1b3/8/P3P3/1PK1P1PP/R4B1R w - - 0 1",
+        "r1k4r/ppp1nppp/3p4/8/3PP3/1PN5/P2K1PPP/R6R w - - 0 1",
+        "rk1r4/1p4pp/p2p4/2pP1p2/3nPN2/1P6/P4PPP/RK2R3 w - - 0 1",
+        "rk5r/pp3p1p/1b3p2/2p5/1P1pB3/8/P1P2PPP/RK1R4 w - - 0 1",
+        "3r2kr/ppp1Rppp/8/2n5/2B5/8/P1P2PPP/1K6 w - - 0 1",
+        "rk6/p1p2ppp/8/1B2b3/8/8/1nPr1PPP/RK3R2 w - - 0 1",
+        "k2r4/1pb2ppp/8/4nq2/3Qp3/1b2B3/1PP1PPPP/1K3B1R w - - 0 1"
+    };
+}
+
+/**
+ * Gets the FENs of the benchmark positions.
+ */
+const std::vector<std::string>& Benchmark::positions() {
+    return BENCH_POSITIONS;
+}
+
+/**
+ * Searches every benchmark position to `depth`, logging the nodes of each one to `log`.
+ *
+ * @return The totals of the run.
+ */
+Benchmark::BenchResult Benchmark::run(const int& depth, std::ostream& log) {
+    BenchResult result;
+    TranspositionTable table(16);
+    Search search(table);
+    ChessBoard board;
+
+    SearchLimits limits;
+    limits.depth = depth;
+    limits.threads = 1;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < BENCH_POSITIONS.size(); i++) {
+        board.loadFEN(BENCH_POSITIONS[i]);
+        table.clear();
+        search.run(board, limits);
+        result.nodes += search.nodes();
+        log << "Position " << (i + 1) << "/" << BENCH_POSITIONS.size() << ": " << search.nodes() << " nodes" << std::endl;
+    }
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    result.nps = result.elapsed ? result.nodes * 1000 / result.elapsed : 0;
+    return result;
+}
@@ -0,0 +1,41 @@
+/**
+ * @brief A fixed, deterministic search benchmark.
+ *
+ * A set of positions embedded in the program is searched to a fixed depth on a single
+ * thread, starting every position from an empty transposition table. The total node
+ * count is then a signature of the search: a change that only makes the engine faster
+ * must leave it unchanged, and the nodes per second measure how much faster it got.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Benchmark {
+    // The depth every position is searched to, unless another one is given
+    const int DEFAULT_DEPTH = 4;
+
+    /*
+    The outcome of a benchmark run.
+    */
+    struct BenchResult {
+        uint64_t nodes = 0;    // The signature: total nodes over all positions
+        int64_t elapsed = 0;   // In milliseconds
+        uint64_t nps = 0;      // Nodes per second
+    };
+
+    /**
+     * Gets the FENs of the benchmark positions.
+     */
+    const std::vector<std::string>& positions();
+
+    /**
+     * Searches every benchmark position to `depth`, logging the nodes of each one to `log`.
+     *
+     * @return The totals of the run.
+     */
+    BenchResult run(const int& depth, std::ostream& log);
+};
@@ -1,5 +1,56 @@
 #include "ChessBoard.hpp"
 
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+
+#include "AllocationTracker.hpp"
+#include "Profiler.hpp"
+
+namespace {
+    const char SNAPSHOT_MAGIC[4] = {'C', 'H', 'B', 'S'};
+
+    // Flags of a move in a snapshot
+    const uint8_t SNAPSHOT_FIRST_MOVE = 1;     // It was the moved piece's first move
+    const uint8_t SNAPSHOT_CAPTURED_MOVED = 2; // The captured piece had moved before
+
+    /*
+    Reaches the container under a std::stack, to read the history oldest first without copying it.
+    */
+    struct HistoryAccess : std::stack<Move> {
+        static const std::deque<Move>& of(const std::stack<Move>& history) {
+            return history.*(&HistoryAccess::c);
+        }
+    };
+
+    /*
+    FNV-1a checksum of a snapshot.
+    */
+    uint32_t snapshotChecksum(const char* data, const size_t& size) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    /*
+    Appends `value` to a snapshot as 4 little-endian bytes.
+    */
+    void putLittleEndian(std::string& out, const uint32_t& value) {
+        for (int i = 0; i < 4; i++) { out.push_back(static_cast<char>(value >> (8 * i))); }
+    }
+
+    /*
+    Reads 4 little-endian bytes of a snapshot.
+    */
+    uint32_t getLittleEndian(const char* in) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(in);
+        return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+}
+
 /**
  * Colors the given text using the specified color code.
  *
@@ -53,11 +104,11 @@ std::string BoardColorizer::colorText(const std::string& text, const std::string
     *      
     *          (With * denoting empty cells)
     * 
-    * 2) playerOneTurn is set to true.
+    * 2) It is Player One's turn.
     * 3) p1_color is set to "BLACK", and p2_color is set to "WHITE"
     */
 ChessBoard::ChessBoard(const std::string& assignedColorP1, const std::string& assignedColorP2)
-    : playerOneTurn{true}, p1_color{assignedColorP1}, p2_color{assignedColorP2}, board{std::vector(8, std::vector<ChessPiece*>(8)) } {
+    : p1_color{assignedColorP1}, p2_color{assignedColorP2}, board{std::vector(8, std::vector<ChessPiece*>(8)) }, position_{} {
         
         // If the colors used are not available, or if we've specified the same color for Player One & Two
         // default to BLACK and WHITE
@@ -103,6 +154,9 @@ ChessBoard::ChessBoard(const std::string& assignedColorP1, const std::string& as
                 pieces.push_front(board[row][col]);
             }
         }
+
+        position_.player_one_turn = true;
+        syncPosition();
     }
 
 /**
@@ -115,14 +169,540 @@ ChessBoard::ChessBoard(const std::string& assignedColorP1, const std::string& as
  *                 2D vector of ChessPiece* pointers.
  * @param p1Turn   A boolean indicating whether it's Player 1's turn to play.
  */
-ChessBoard::ChessBoard(const std::vector<std::vector<ChessPiece*>>& instance, const bool& p1Turn) : playerOneTurn{p1Turn}, p1_color{"BLACK"}, p2_color{"WHITE"}, board{instance} {
-    // Track all added pieces from the board.
-    for (size_t row = 0; row < BOARD_LENGTH; row++) {
-        for (size_t col = 0; col < BOARD_LENGTH; col++) {
+ChessBoard::ChessBoard(const std::vector<std::vector<ChessPiece*>>& instance, const bool& p1Turn) : p1_color{"BLACK"}, p2_color{"WHITE"}, board{std::vector(8, std::vector<ChessPiece*>(8))}, position_{} {
+    // Clone the pieces, so this board only ever deallocates its own
+    for (int row = 0; row < BOARD_LENGTH; row++) {
+        for (int col = 0; col < BOARD_LENGTH; col++) {
+            const ChessPiece* original = instance[row][col];
+            if (!original) { continue; }
+
+            ChessPiece* copy = createPiece(original->getType(), original->getColor(), row, col, original->isMovingUp());
+            copy->setMoved(original->hasMoved());
+            board[row][col] = copy;
+            pieces.push_front(copy);
+        }
+    }
+
+    position_.player_one_turn = p1Turn;
+    syncPosition();
+}
+
+/**
+ * @brief Constructs a board (with the default colors) on `position`
+ */
+ChessBoard::ChessBoard(const Position& position)
+    : p1_color{"BLACK"}, p2_color{"WHITE"}, board{std::vector(8, std::vector<ChessPiece*>(8))}, position_{} {
+    setPosition(position);
+}
+
+/**
+ * @brief Copy constructor. Performs a deep copy through setPosition(other.getPosition()):
+ *        every piece is allocated again, so both boards own (and later deallocate) their own pieces.
+ * @post The new board has the same pieces, colors, turn and hash as `other`.
+ *       The move history is NOT copied, as its Moves point into `other`'s pieces.
+ */
+ChessBoard::ChessBoard(const ChessBoard& other)
+    : p1_color{other.p1_color}, p2_color{other.p2_color}, board{std::vector(8, std::vector<ChessPiece*>(8))}, position_{} {
+    setPosition(other.position_);
+}
+
+/**
+ * @brief Allocates a ChessPiece derived class matching `type` ("PAWN", "ROOK", ...)
+ * @return A pointer to the new piece, or nullptr if `type` is unknown
+ */
+ChessPiece* ChessBoard::createPiece(const std::string& type, const std::string& color, const int& row, const int& col, const bool& movingUp) {
+    if (type == "PAWN") { return new Pawn(color, row, col, movingUp); }
+    if (type == "ROOK") { return new Rook(color, row, col, movingUp); }
+    if (type == "KNIGHT") { return new Knight(color, row, col, movingUp); }
+    if (type == "BISHOP") { return new Bishop(color, row, col, movingUp); }
+    if (type == "KING") { return new King(color, row, col, movingUp); }
+    if (type == "QUEEN") { return new Queen(color, row, col, movingUp); }
+    return nullptr;
+}
+
+/**
+ * @brief Gets the kind of `piece` as used by Zobrist and the evaluation:
+ *        PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING map to 0-5 for Player One
+ *        and to 6-11 for Player Two.
+ */
+int ChessBoard::pieceKind(const ChessPiece* piece) const {
+    const std::string& type = piece->getType();
+    int kind = 0;
+    if (type == "KNIGHT") { kind = 1; }
+    else if (type == "BISHOP") { kind = 2; }
+    else if (type == "ROOK") { kind = 3; }
+    else if (type == "QUEEN") { kind = 4; }
+    else if (type == "KING") { kind = 5; }
+
+    return (piece->getColor() == p1_color) ? kind : kind + 6;
+}
+
+/**
+ * @brief Computes the Zobrist hash of the current position from scratch
+ *        (getHash() returns the incrementally updated one)
+ */
+uint64_t ChessBoard::computeHash() const {
+    uint64_t hash = position_.player_one_turn ? 0 : Zobrist::sideKey();
+    for (int row = 0; row < BOARD_LENGTH; row++) {
+        for (int col = 0; col < BOARD_LENGTH; col++) {
             if (!board[row][col]) { continue; }
-            pieces.push_front(board[row][col]);
+            hash ^= Zobrist::pieceKey(pieceKind(board[row][col]), row, col);
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Deallocates every piece and empties the board and move history
+ */
+void ChessBoard::clear() {
+    for (auto& piece_ptr : pieces) { delete piece_ptr; }
+    pieces.clear();
+    for (auto& row : board) { std::fill(row.begin(), row.end(), nullptr); }
+    while (!past_moves_.empty()) { past_moves_.pop(); }
+}
+
+/**
+ * @brief Replaces the current position with the one described by a FEN string.
+ * 
+ *        The FEN is read relative to this board's layout: uppercase letters are
+ *        Player One's pieces (moving up from row 0), the first rank listed is row 7,
+ *        and the side to move "w" denotes Player One. Castling, en passant and
+ *        move counters are accepted but ignored, as they have no effect here.
+ *        Pawns that are off their starting row are flagged as having moved.
+ * 
+ * @param fen The FEN string to load.
+ * @return True if the FEN was valid and loaded. False otherwise (the board is left unchanged).
+ * @post On success all previous pieces are deallocated and the move history is cleared.
+ */
+bool ChessBoard::loadFEN(const std::string& fen) {
+    const std::unordered_map<char, std::string> FEN_TYPES = {
+        {'p', "PAWN"}, {'n', "KNIGHT"}, {'b', "BISHOP"}, {'r', "ROOK"}, {'q', "QUEEN"}, {'k', "KING"}
+    };
+
+    std::istringstream fields(fen);
+    std::string placement, side;
+    if (!(fields >> placement)) { return false; }
+    if (!(fields >> side)) { side = "w"; }
+    if (side != "w" && side != "b") { return false; }
+
+    // Validate the placement into a grid of symbols before touching the board
+    char grid[BOARD_LENGTH][BOARD_LENGTH] = {};
+    int row = BOARD_LENGTH - 1;
+    int col = 0;
+    for (char symbol : placement) {
+        if (symbol == '/') {
+            if (col != BOARD_LENGTH || row == 0) { return false; }
+            row--;
+            col = 0;
+        } else if (symbol >= '1' && symbol <= '8') {
+            col += symbol - '0';
+            if (col > BOARD_LENGTH) { return false; }
+        } else {
+            if (col >= BOARD_LENGTH || !FEN_TYPES.count(std::tolower(symbol))) { return false; }
+            grid[row][col++] = symbol;
+        }
+    }
+    if (row != 0 || col != BOARD_LENGTH) { return false; }
+
+    clear();
+    for (row = 0; row < BOARD_LENGTH; row++) {
+        for (col = 0; col < BOARD_LENGTH; col++) {
+            char symbol = grid[row][col];
+            if (!symbol) { continue; }
+
+            bool playerOne = std::isupper(symbol);
+            const std::string& type = FEN_TYPES.at(std::tolower(symbol));
+            ChessPiece* piece = createPiece(type, playerOne ? p1_color : p2_color, row, col, type == "PAWN" && playerOne);
+            if (type == "PAWN" && row != (playerOne ? 1 : BOARD_LENGTH - 2)) { piece->flagMoved(); }
+
+            board[row][col] = piece;
+            pieces.push_front(piece);
+        }
+    }
+
+    position_.player_one_turn = (side == "w");
+    syncPosition();
+    return true;
+}
+
+/**
+ * @brief Describes the current position as a FEN string, using the same
+ *        conventions as loadFEN()
+ */
+std::string ChessBoard::toFEN() const {
+    std::string fen;
+    for (int row = BOARD_LENGTH - 1; row >= 0; row--) {
+        int empty = 0;
+        for (int col = 0; col < BOARD_LENGTH; col++) {
+            const ChessPiece* piece = board[row][col];
+            if (!piece) { empty++; continue; }
+            if (empty) { fen += std::to_string(empty); empty = 0; }
+
+            char symbol = (piece->getType() == "KNIGHT") ? 'n' : std::tolower(piece->getType()[0]);
+            fen += (piece->getColor() == p1_color) ? std::toupper(symbol) : symbol;
+        }
+        if (empty) { fen += std::to_string(empty); }
+        if (row) { fen += '/'; }
+    }
+
+    fen += position_.player_one_turn ? " w - - 0 1" : " b - - 0 1";
+    return fen;
+}
+
+/**
+ * @brief Determines whether it is Player One's turn
+ */
+bool ChessBoard::isPlayerOneTurn() const {
+    return position_.player_one_turn;
+}
+
+/**
+ * @brief Gets the Zobrist hash of the current position (pieces & side to move)
+ */
+uint64_t ChessBoard::getHash() const {
+    return position_.hash;
+}
+
+/**
+ * @brief Moves the piece on `from` to `to` without any validation, updating
+ *        the board, the piece's row / col / moved flag and the hash.
+ */
+void ChessBoard::applyMove(const Square& from, const Square& to) {
+    ChessPiece* movingPiece = board[from.first][from.second];
+    ChessPiece* captured_piece = board[to.first][to.second];
+
+    const int from_square = from.first * BOARD_LENGTH + from.second;
+    const int to_square = to.first * BOARD_LENGTH + to.second;
+    const uint8_t kind = position_.squares[from_square];
+    position_.hash ^= Zobrist::pieceKey(kind, from.first, from.second) ^ Zobrist::pieceKey(kind, to.first, to.second);
+    if (captured_piece) { position_.hash ^= Zobrist::pieceKey(position_.squares[to_square], to.first, to.second); }
+    position_.squares[to_square] = kind;
+    position_.squares[from_square] = Position::EMPTY;
+    position_.moved = (position_.moved & ~(uint64_t(1) << from_square)) | (uint64_t(1) << to_square);
+
+    board[to.first][to.second] = movingPiece;
+    board[from.first][from.second] = nullptr;
+
+    movingPiece->setRow(to.first);
+    movingPiece->setColumn(to.second);
+    movingPiece->flagMoved();
+}
+
+/**
+ * @brief Toggles the side to move and its component of the hash
+ */
+void ChessBoard::switchTurn() {
+    position_.player_one_turn = !position_.player_one_turn;
+    position_.hash ^= Zobrist::sideKey();
+}
+
+/**
+ * @brief Rebuilds position_ from the pieces on the board, hash included
+ */
+void ChessBoard::syncPosition() {
+    position_.moved = 0;
+    for (int row = 0; row < BOARD_LENGTH; row++) {
+        for (int col = 0; col < BOARD_LENGTH; col++) {
+            const ChessPiece* piece = board[row][col];
+            position_.squares[row * BOARD_LENGTH + col] = piece ? static_cast<uint8_t>(pieceKind(piece)) : Position::EMPTY;
+            if (piece && piece->hasMoved()) { position_.moved |= uint64_t(1) << (row * BOARD_LENGTH + col); }
+        }
+    }
+    position_.hash = computeHash();
+}
+
+/**
+ * @brief Takes every piece off the board and puts one of kind squares[i] on each square i
+ *        of `cells` (nullptr where EMPTY), reusing the pieces this board owns (recolored
+ *        if needed) and allocating only when it owns fewer of a kind than needed.
+ *        Pieces left over stay owned, off the board. Neither `board` nor the moved
+ *        flags are touched.
+ */
+void ChessBoard::placePieces(const uint8_t squares[64], ChessPiece* cells[64]) {
+    static const char* const TYPES[6] = {"PAWN", "KNIGHT", "BISHOP", "ROOK", "QUEEN", "KING"};
+
+    // Sort the pieces this board owns by kind, splicing list nodes so nothing is allocated
+    std::list<ChessPiece*> spare[12];
+    while (!pieces.empty()) {
+        const int kind = pieceKind(pieces.front());
+        spare[kind].splice(spare[kind].end(), pieces, pieces.begin());
+    }
+
+    for (int square = 0; square < 64; square++) {
+        const uint8_t kind = squares[square];
+        cells[square] = nullptr;
+        if (kind == Position::EMPTY) { continue; }
+
+        // As everywhere else, only Player One's pawns move up
+        const bool playerOne = kind < 6;
+        ChessPiece* piece;
+        if (spare[kind].empty()) {
+            piece = createPiece(TYPES[kind % 6], playerOne ? p1_color : p2_color, -1, -1, kind == 0);
+            pieces.push_front(piece);
+        } else {
+            piece = spare[kind].front();
+            pieces.splice(pieces.begin(), spare[kind], spare[kind].begin());
+            if (piece->getColor() != (playerOne ? p1_color : p2_color)) { piece->setColor(playerOne ? p1_color : p2_color); }
+        }
+        piece->setRow(square / BOARD_LENGTH);
+        piece->setColumn(square % BOARD_LENGTH);
+        cells[square] = piece;
+    }
+    for (auto& kind : spare) { pieces.splice(pieces.end(), kind); }
+}
+
+/**
+ * @brief Determines whether any piece of color `attacker_color` can move onto (row, col)
+ */
+bool ChessBoard::isSquareAttacked(const int& row, const int& col, const std::string& attacker_color) const {
+    for (const auto& cells : board) {
+        for (const ChessPiece* piece : cells) {
+            if (!piece || piece->getColor() != attacker_color) { continue; }
+            if (piece->canMove(row, col, board)) { return true; }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Determines whether the King of color `color` is attacked by the other player
+ */
+bool ChessBoard::isKingAttacked(const std::string& color) const {
+    const std::string& attacker_color = (color == p1_color) ? p2_color : p1_color;
+    for (int row = 0; row < BOARD_LENGTH; row++) {
+        for (int col = 0; col < BOARD_LENGTH; col++) {
+            const ChessPiece* piece = board[row][col];
+            if (piece && piece->getType() == "KING" && piece->getColor() == color) {
+                return isSquareAttacked(row, col, attacker_color);
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Determines whether the King of the player whose turn it is is attacked
+ */
+bool ChessBoard::isInCheck() const {
+    NO_ALLOC_SCOPE("in_check");
+    return isKingAttacked(position_.player_one_turn ? p1_color : p2_color);
+}
+
+/**
+ * @brief Adds the memory used by the board to `report`: "board" (the object and its
+ *        grid), "pieces" (every piece ever in play, and the list holding them) and "history"
+ */
+void ChessBoard::reportMemory(MemoryReport& report) const {
+    size_t grid = board.capacity() * sizeof(std::vector<ChessPiece*>);
+    for (const auto& row : board) { grid += row.capacity() * sizeof(ChessPiece*); }
+    report.add("board", sizeof(ChessBoard) + grid + MemoryReport::stringHeapBytes(p1_color) + MemoryReport::stringHeapBytes(p2_color));
+
+    // Pieces by pieceKind() % 6, each in its own list node (two links and the pointer)
+    static const size_t PIECE_SIZES[6] = {sizeof(Pawn), sizeof(Knight), sizeof(Bishop), sizeof(Rook), sizeof(Queen), sizeof(King)};
+    size_t piece_bytes = 0;
+    for (const ChessPiece* piece : pieces) {
+        piece_bytes += 3 * sizeof(void*) + PIECE_SIZES[pieceKind(piece) % 6]
+                     + MemoryReport::stringHeapBytes(piece->getColor()) + MemoryReport::stringHeapBytes(piece->getType());
+    }
+    report.add("pieces", piece_bytes, pieces.size());
+
+    report.add("history", MemoryReport::dequeHeapBytes(past_moves_.size(), sizeof(Move)), past_moves_.size());
+}
+
+/**
+ * @brief Checks the incrementally updated state against the board: the hash against
+ *        computeHash(), the kind and moved flag kept for every square against its cell,
+ *        and every piece's row / col against its cell, its presence in the piece list
+ *        and its uniqueness on the board
+ * @param diff Set to one line per mismatch
+ * @return True if everything matches.
+ */
+bool ChessBoard::verifyState(std::string& diff) const {
+    std::ostringstream out;
+
+    uint64_t recomputed = computeHash();
+    if (recomputed != position_.hash) {
+        out << "hash: incremental " << std::hex << position_.hash << ", recomputed " << recomputed << std::dec << "\n";
+    }
+
+    std::unordered_set<const ChessPiece*> listed(pieces.begin(), pieces.end());
+    std::unordered_map<const ChessPiece*, Square> seen;
+    for (int row = 0; row < BOARD_LENGTH; row++) {
+        for (int col = 0; col < BOARD_LENGTH; col++) {
+            const ChessPiece* piece = board[row][col];
+            const int square = row * BOARD_LENGTH + col;
+            const int kind = piece ? pieceKind(piece) : Position::EMPTY;
+            if (position_.squares[square] != kind || position_.hasMoved(row, col) != (piece && piece->hasMoved())) {
+                out << "position: (" << row << ", " << col << ") holds kind " << int(position_.squares[square])
+                    << (position_.hasMoved(row, col) ? " moved" : "") << ", the board kind " << kind
+                    << (piece && piece->hasMoved() ? " moved" : "") << "\n";
+            }
+            if (!piece) { continue; }
+
+            const std::string name = piece->getColor() + " " + piece->getType();
+            if (piece->getRow() != row || piece->getColumn() != col) {
+                out << name << " on (" << row << ", " << col << ") thinks it is on ("
+                    << piece->getRow() << ", " << piece->getColumn() << ")\n";
+            }
+            if (!listed.count(piece)) {
+                out << name << " on (" << row << ", " << col << ") is missing from the piece list\n";
+            }
+            auto [previous, inserted] = seen.emplace(piece, Square{row, col});
+            if (!inserted) {
+                out << name << " on (" << row << ", " << col << ") is also on ("
+                    << previous->second.first << ", " << previous->second.second << ")\n";
+            }
+        }
+    }
+
+    diff = out.str();
+    return diff.empty();
+}
+
+/**
+ * @brief In a CHESS_VERIFY_STATE build, runs verifyState() on one call in N on average
+ *        (N = CHESS_VERIFY_STATE) and aborts with the differences on a mismatch
+ * @param operation The operation that just finished ("make", "unmake"), for the report
+ */
+void ChessBoard::checkState(const char* operation) const {
+#ifdef CHESS_VERIFY_STATE
+    // Sampled at random rather than every Nth call: make and unmake alternate, so an even N
+    // would only ever check one of them
+    thread_local uint64_t calls = 0;
+    thread_local uint64_t random = 0x9E3779B97F4A7C15ULL;
+    calls++;
+    random ^= random << 13;
+    random ^= random >> 7;
+    random ^= random << 17;
+    if (random % CHESS_VERIFY_STATE != 0) { return; }
+
+    std::string diff;
+    if (verifyState(diff)) { return; }
+
+    std::cerr << "Inconsistent board state after " << operation << " (call " << calls << ")"
+              << (past_moves_.empty() ? "" : ", last move " + past_moves_.top().toUCI()) << std::endl
+              << "Position: " << toFEN() << std::endl << diff << std::flush;
+    std::abort();
+#else
+    (void)operation;
+#endif
+}
+
+/**
+ * @brief Counts the leaf nodes of the legal move tree `depth` plies deep (perft),
+ *        used to validate and time move generation
+ * @post The board is left in the same position.
+ */
+uint64_t ChessBoard::perft(const int& depth) {
+    if (depth <= 0) { return 1; }
+
+    std::vector<Move> moves = generateMoves();
+    if (depth == 1) { return moves.size(); }
+
+    uint64_t nodes = 0;
+    for (const Move& move : moves) {
+        makeMove(move);
+        nodes += perft(depth - 1);
+        unmakeMove();
+    }
+    return nodes;
+}
+
+/**
+ * @brief Gets the cells of every piece of Player One (or Player Two) that can move onto (row, col)
+ * @param playerOne True for Player One's pieces, false for Player Two's
+ */
+std::vector<Square> ChessBoard::getAttackers(const int& row, const int& col, const bool& playerOne) const {
+    std::vector<Square> attackers;
+    const std::string& color = playerOne ? p1_color : p2_color;
+    for (int r = 0; r < BOARD_LENGTH; r++) {
+        for (int c = 0; c < BOARD_LENGTH; c++) {
+            const ChessPiece* piece = board[r][c];
+            if (piece && piece->getColor() == color && piece->canMove(row, col, board)) {
+                attackers.push_back({r, c});
+            }
+        }
+    }
+    return attackers;
+}
+
+/**
+ * @brief Generates every legal move for the player whose turn it is.
+ * 
+ *        A move is legal if the piece "can move" to the target, the target is not
+ *        a KING, and the move does not leave the moving player's King attacked.
+ * 
+ * @return A vector of the legal moves (empty if the player is checkmated or stalemated)
+ */
+std::vector<Move> ChessBoard::generateMoves() {
+    PROFILE_ZONE("movegen");
+    std::vector<Move> moves;
+    const std::string colorInPlay = (position_.player_one_turn) ? p1_color : p2_color;
+
+    for (int row = 0; row < BOARD_LENGTH; row++) {
+        for (int col = 0; col < BOARD_LENGTH; col++) {
+            ChessPiece* movingPiece = board[row][col];
+            if (!movingPiece || movingPiece->getColor() != colorInPlay) { continue; }
+
+            for (int new_row = 0; new_row < BOARD_LENGTH; new_row++) {
+                for (int new_col = 0; new_col < BOARD_LENGTH; new_col++) {
+                    if (!movingPiece->canMove(new_row, new_col, board)) { continue; }
+
+                    ChessPiece* captured_piece = board[new_row][new_col];
+                    if (captured_piece && captured_piece->getType() == "KING") { continue; }
+
+                    Move candidate({row, col}, {new_row, new_col}, movingPiece, captured_piece, !movingPiece->hasMoved());
+
+                    // Discard moves that leave our own King attacked
+                    makeMove(candidate);
+                    bool legal = !isKingAttacked(colorInPlay);
+                    unmakeMove();
+
+                    if (legal) { moves.push_back(candidate); }
+                }
+            }
         }
     }
+
+    return moves;
+}
+
+/**
+ * @brief Executes `move` for the player whose turn it is, without validation 
+ *        or console output. Intended for moves returned by generateMoves().
+ * 
+ *        Only the squares of `move` are used, so a move generated on another
+ *        board with the same position may be played.
+ * 
+ * @return True if there was a piece to move.
+ * @post The move is pushed to `past_moves_` and the turn is passed to the other player.
+ */
+bool ChessBoard::makeMove(const Move& move) {
+    PROFILE_ZONE("make");
+    Square from = move.getOriginalPosition();
+    Square to = move.getTargetPosition();
+    ChessPiece* movingPiece = board[from.first][from.second];
+    if (!movingPiece) { return false; }
+
+    past_moves_.push(Move(from, to, movingPiece, board[to.first][to.second], !movingPiece->hasMoved()));
+    applyMove(from, to);
+    switchTurn();
+    checkState("make");
+    return true;
+}
+
+/**
+ * @brief Takes back the most recent move made with makeMove()
+ * @return True if a move was taken back. False if there are no moves to undo.
+ * @post The move is popped from `past_moves_` and the turn is passed back.
+ */
+bool ChessBoard::unmakeMove() {
+    PROFILE_ZONE("unmake");
+    if (!undo()) { return false; }
+    switchTurn();
+    checkState("unmake");
+    return true;
 }
 
 /**
@@ -136,6 +716,125 @@ ChessPiece* ChessBoard::getCell(const int& row, const int& col) const {
     return board[row][col];
 }
 
+/**
+ * @brief Serializes the whole game into a compact binary snapshot: the colors, the
+ *        position, and the move history with what each move captured, so undo()
+ *        keeps working after loadSnapshot(). Versioned (SNAPSHOT_VERSION) and checksummed.
+ */
+std::string ChessBoard::toSnapshot() const {
+    // Layout: magic, version, the two colors (length + characters), the encoded Position,
+    // the move count, 4 bytes per move (oldest first: from, to, captured kind, flags),
+    // checksum. Integers are little-endian.
+    char position[Position::ENCODED_SIZE];
+    position_.encode(position);
+    const uint32_t count = static_cast<uint32_t>(past_moves_.size());
+
+    std::string data;
+    data.reserve(4 + 4 + 2 + p1_color.size() + p2_color.size() + sizeof(position) + 4 + count * 4 + 4);
+    data.append(SNAPSHOT_MAGIC, 4);
+    putLittleEndian(data, SNAPSHOT_VERSION);
+    for (const std::string* color : {&p1_color, &p2_color}) {
+        data.push_back(static_cast<char>(color->size()));
+        data.append(*color);
+    }
+    data.append(position, sizeof(position));
+    putLittleEndian(data, count);
+
+    for (const Move& move : HistoryAccess::of(past_moves_)) {
+        const ChessPiece* captured = move.getCapturedPiece();
+        data.push_back(static_cast<char>(move.getOriginalPosition().first * BOARD_LENGTH + move.getOriginalPosition().second));
+        data.push_back(static_cast<char>(move.getTargetPosition().first * BOARD_LENGTH + move.getTargetPosition().second));
+        data.push_back(static_cast<char>(captured ? pieceKind(captured) : Position::EMPTY));
+        data.push_back(static_cast<char>((move.isFirstMove() ? SNAPSHOT_FIRST_MOVE : 0)
+                                         | (captured && captured->hasMoved() ? SNAPSHOT_CAPTURED_MOVED : 0)));
+    }
+
+    putLittleEndian(data, snapshotChecksum(data.data(), data.size()));
+    return data;
+}
+
+/**
+ * @brief Replaces the game with one serialized by toSnapshot(), reading it in one pass.
+ *
+ *        The pieces this board already owns are reused (recolored and moved onto
+ *        their new squares), so a board restored over and over only allocates
+ *        pieces when the snapshot holds more of a kind than it ever had.
+ *
+ * @return True if the snapshot was valid and loaded. False otherwise (the board is left unchanged).
+ */
+bool ChessBoard::loadSnapshot(const std::string& snapshot) {
+    // Header, colors and checksum
+    const char* data = snapshot.data();
+    const size_t size = snapshot.size();
+    if (size < 4 + 4 + 4 || std::memcmp(data, SNAPSHOT_MAGIC, 4) != 0) { return false; }
+    const uint32_t version = getLittleEndian(data + 4);
+    const uint32_t sum = getLittleEndian(data + size - 4);
+    if (version != SNAPSHOT_VERSION || sum != snapshotChecksum(data, size - 4)) { return false; }
+
+    const size_t end = size - 4;
+    size_t offset = 8;
+    std::string colors[2];
+    for (std::string& color : colors) {
+        if (offset >= end) { return false; }
+        const size_t length = static_cast<unsigned char>(data[offset++]);
+        if (offset + length > end) { return false; }
+        color.assign(data + offset, length);
+        offset += length;
+        if (!BoardColorizer::ALLOWED_COLORS.count(color)) { return false; }
+    }
+    if (colors[0] == colors[1]) { return false; }
+
+    // Squares holding no valid kind, or a side to move other than 0 or 1, are rejected here
+    Position position;
+    if (offset + Position::ENCODED_SIZE + 4 > end || !position.decode(data + offset)) { return false; }
+    offset += Position::ENCODED_SIZE;
+    const uint32_t count = getLittleEndian(data + offset);
+    offset += 4;
+    if (end - offset != static_cast<size_t>(count) * 4) { return false; }
+    const unsigned char* moves = reinterpret_cast<const unsigned char*>(data + offset);
+
+    // Take the moves back on the kinds alone, newest first, to check the history fits the
+    // position and to find every piece of the game on the square it started the history on
+    uint8_t origin[64];
+    std::memcpy(origin, position.squares, sizeof(origin));
+    for (uint32_t i = count; i-- > 0;) {
+        const unsigned char* move = moves + i * 4;
+        if (move[0] >= 64 || move[1] >= 64 || move[0] == move[1] || move[2] > Position::EMPTY) { return false; }
+        if (origin[move[1]] == Position::EMPTY || origin[move[0]] != Position::EMPTY) { return false; }
+        origin[move[0]] = origin[move[1]];
+        origin[move[1]] = move[2];
+    }
+
+    p1_color = colors[0];
+    p2_color = colors[1];
+    ChessPiece* cells[64];
+    placePieces(origin, cells);
+
+    // Replay the history forward, so every Move points at the pieces it moved and captured
+    while (!past_moves_.empty()) { past_moves_.pop(); }
+    for (uint32_t i = 0; i < count; i++) {
+        const unsigned char* move = moves + i * 4;
+        ChessPiece* moved = cells[move[0]];
+        ChessPiece* captured = cells[move[1]];
+        if (captured) { captured->setMoved(move[3] & SNAPSHOT_CAPTURED_MOVED); }
+        past_moves_.push(Move({move[0] / BOARD_LENGTH, move[0] % BOARD_LENGTH}, {move[1] / BOARD_LENGTH, move[1] % BOARD_LENGTH},
+                              moved, captured, move[3] & SNAPSHOT_FIRST_MOVE));
+        moved->setRow(move[1] / BOARD_LENGTH);
+        moved->setColumn(move[1] % BOARD_LENGTH);
+        cells[move[1]] = moved;
+        cells[move[0]] = nullptr;
+    }
+
+    for (int square = 0; square < 64; square++) {
+        ChessPiece* piece = cells[square];
+        board[square / BOARD_LENGTH][square % BOARD_LENGTH] = piece;
+        if (piece) { piece->setMoved(position.moved & (uint64_t(1) << square)); }
+    }
+    position_ = position;
+    checkState("restore");
+    return true;
+}
+
 /**
  * @brief Getter for board_ member
  */
@@ -143,6 +842,42 @@ std::vector<std::vector<ChessPiece*>> ChessBoard::getBoardState() const {
     return board;
 }
 
+/**
+ * @brief Takes the current position as a plain value: a copy of the one the board keeps
+ */
+Position ChessBoard::getPosition() const {
+    return position_;
+}
+
+/**
+ * @brief Replaces the current position with `position`, copied as is. The pieces this
+ *        board owns are reused as in loadSnapshot(), so re-seating a board on another
+ *        position of the same game allocates nothing.
+ * @post The move history is cleared.
+ */
+void ChessBoard::setPosition(const Position& position) {
+    while (!past_moves_.empty()) { past_moves_.pop(); }
+
+    ChessPiece* cells[64];
+    placePieces(position.squares, cells);
+    for (int square = 0; square < 64; square++) {
+        ChessPiece* piece = cells[square];
+        board[square / BOARD_LENGTH][square % BOARD_LENGTH] = piece;
+        if (piece) { piece->setMoved(position.moved & (uint64_t(1) << square)); }
+    }
+    position_ = position;
+    checkState("set");
+}
+
+/**
+ * @brief Publishes the current position and the number of moves played to `view`,
+ *        for other threads to read while this board goes on. Call it from the
+ *        thread playing the game, after each move of the game (not of a search).
+ */
+void ChessBoard::publish(PositionView& view) const {
+    view.publish(getPosition(), static_cast<uint32_t>(past_moves_.size()));
+}
+
 /**
  * @brief Destructor. 
  * @post Deallocates all ChessPiece pointers that were ever used on the board.
@@ -221,7 +956,7 @@ void ChessBoard::display() const {
 bool ChessBoard::move(const int& row, const int& col, const int& new_row, const int& new_col) {
     if (row < 0 || col < 0 || row >= BOARD_LENGTH || col >= BOARD_LENGTH) { return false; }
     ChessPiece* movingPiece = board[row][col];
-    const std::string& colorInPlay = (playerOneTurn) ? p1_color : p2_color;
+    const std::string& colorInPlay = (position_.player_one_turn) ? p1_color : p2_color;
     // If there is no piece to move or it is of the opposite color, terminate
     if (!movingPiece) { return false; }
     if (movingPiece->getColor() != colorInPlay) { return false; }
@@ -235,15 +970,8 @@ bool ChessBoard::move(const int& row, const int& col, const int& new_row, const
     // Cannot capture a King in chess
     if (captured_piece && captured_piece->getType() == "KING") { return false; }
     
-    // Update moved piece
-    board[new_row][new_col] = movingPiece;
-
-    // Valid logic unless for castle, but for simplicity's sake, we'll leave that out for now.
-    board[row][col] = nullptr;
-
-    movingPiece->setRow(new_row);
-    movingPiece->setColumn(new_col);
-    movingPiece->flagMoved();
+    // Update moved piece. Valid logic unless for castle, but for simplicity's sake, we'll leave that out for now.
+    applyMove({row, col}, {new_row, new_col});
     
     return true;
 }
@@ -261,16 +989,16 @@ bool ChessBoard::move(const int& row, const int& col, const int& new_row, const
      * 4) Records their input, or returns the result of attempting to undo the previous action
      * 5) Attempt to execute the move, using move()
      * 6) If the move is successful, records the action by pushing a Move to past_moves_.
-     * 7) If the move OR undo is successful, toggles the `playerOneTurn` boolean member of `ChessBoard`
+     * 7) If the move OR undo is successful, passes the turn to the other player
      * 
      * @return Returns true if the round has been completed successfully, that is:
      *      - If a pieced was succesfully moved.
      *      - Or a move was successfully undone.
-     * @post The `past_moves_` stack & `playerOneTurn` members are updated as described above
+     * @post The `past_moves_` stack & the side to move are updated as described above
      */
     bool ChessBoard:: attemptRound(){
 
-        std::string player_in_turn = playerOneTurn? "Player 1": "Player 2";
+        std::string player_in_turn = position_.player_one_turn ? "Player 1": "Player 2";
         Square target_piece;
         Square target_location;
 
@@ -291,9 +1019,12 @@ bool ChessBoard::move(const int& row, const int& col, const int& new_row, const
 
             
             //Place holder. I need to figure out how to detemrine if the stack is not emty to we can pop in the first place. 
+            if (!past_moves_.empty()) {
+                std::cout << "Undoing " << past_moves_.top().toString() << std::endl;
+            }
             if(undo()){
                 
-                playerOneTurn = playerOneTurn? false:true;
+                switchTurn();
                 std::cout<<"AFTER UNDO, Player in turn: "<<player_in_turn<<std::endl;
                 return true;
             }
@@ -324,9 +1055,12 @@ bool ChessBoard::move(const int& row, const int& col, const int& new_row, const
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             //Place holder. I need to figure out how to detemrine if the stack is not emty to we can pop in the first place. 
+            if (!past_moves_.empty()) {
+                std::cout << "Undoing " << past_moves_.top().toString() << std::endl;
+            }
             if(undo()){
                  
-                playerOneTurn = playerOneTurn? false:true;
+                switchTurn();
                 return true;
                 
             }
@@ -357,8 +1091,10 @@ bool ChessBoard::move(const int& row, const int& col, const int& new_row, const
         }
 
         ChessPiece * moved_piece_ptr = nullptr;
+        bool first_move = false;
         if (valid_target && valid_location && board[target_piece.first][target_piece.second]){
             moved_piece_ptr = board[target_piece.first][target_piece.second];
+            first_move = !moved_piece_ptr->hasMoved();
         }
 
         bool valid_move = false;
@@ -372,11 +1108,11 @@ bool ChessBoard::move(const int& row, const int& col, const int& new_row, const
             std::cout<<"Moved ("<<target_piece.first<<", "<<target_piece.second<<") to ("<<target_location.first << ", "<< target_location.second<<")" <<std::endl;
 
             //we will make a move object
-            Move new_move = Move (target_piece, target_location, moved_piece_ptr, captured_piece_ptr);
+            Move new_move = Move (target_piece, target_location, moved_piece_ptr, captured_piece_ptr, first_move);
             past_moves_.push(new_move);
 
-            //Step 7: Toogle playerOneTurn 
-            playerOneTurn = playerOneTurn? false: true;
+            //Step 7: Toogle the side to move 
+            switchTurn();
             return true;
         }
 
@@ -417,6 +1153,8 @@ bool ChessBoard::move(const int& row, const int& col, const int& new_row, const
          *          positions on the board
          *       3) The most recent `Move` object is removed from the `past_moves_`
          *          stack 
+         *       4) If it was the moved piece's first move, its `has_moved_` flag is cleared again
+         *       5) The hash is updated to match the reverted position
          */ 
     bool ChessBoard:: undo(){
 
@@ -424,25 +1162,37 @@ bool ChessBoard::move(const int& row, const int& col, const int& new_row, const
             return false;
         }
         //First, move the piece back to where it was
-        Move previous_move = past_moves_.top();
-
-        //Print to confirm the move will be done
-        std::cout<<"YES (" << (previous_move).getOriginalPosition().first <<", "<<(previous_move).getOriginalPosition().second << ") to ("
-        << (previous_move).getTargetPosition().first << ", " << (previous_move).getTargetPosition().second<<") "<<std::endl;
+        const Move& previous_move = past_moves_.top();
+        Square from = previous_move.getOriginalPosition();
+        Square to = previous_move.getTargetPosition();
 
         //Manually move the piece back
+        ChessPiece* moved_piece = board[to.first][to.second];
+        const int from_square = from.first * BOARD_LENGTH + from.second;
+        const int to_square = to.first * BOARD_LENGTH + to.second;
+        const uint8_t kind = position_.squares[to_square];
+        position_.hash ^= Zobrist::pieceKey(kind, from.first, from.second) ^ Zobrist::pieceKey(kind, to.first, to.second);
+        position_.squares[from_square] = kind;
+        position_.squares[to_square] = Position::EMPTY;
+        position_.moved &= ~(uint64_t(1) << to_square);
 
-        board[previous_move.getOriginalPosition().first][previous_move.getOriginalPosition().second] = board [previous_move.getTargetPosition().first][previous_move.getTargetPosition().second];
-        board[previous_move.getOriginalPosition().first][previous_move.getOriginalPosition().second]->setRow(previous_move.getOriginalPosition().first);
-        board[previous_move.getOriginalPosition().first][previous_move.getOriginalPosition().second] ->setColumn(previous_move.getOriginalPosition().second);
+        board[from.first][from.second] = moved_piece;
+        moved_piece->setRow(from.first);
+        moved_piece->setColumn(from.second);
+        if (previous_move.isFirstMove()) { moved_piece->setMoved(false); }
+        if (moved_piece->hasMoved()) { position_.moved |= uint64_t(1) << from_square; }
 
         //Yes, I made it empty. If there was a captured it will be added later
-        board [previous_move.getTargetPosition().first][previous_move.getTargetPosition().second] = nullptr; 
+        board[to.first][to.second] = nullptr; 
         
-        if ( previous_move.getCapturedPiece() ){
-            board [previous_move.getTargetPosition().first][previous_move.getTargetPosition().second] = previous_move.getCapturedPiece();
-            board [previous_move.getTargetPosition().first][previous_move.getTargetPosition().second]->setRow(previous_move.getTargetPosition().first);
-            board [previous_move.getTargetPosition().first][previous_move.getTargetPosition().second]-> setColumn(previous_move.getTargetPosition().second);
+        ChessPiece* captured_piece = previous_move.getCapturedPiece();
+        if (captured_piece){
+            board[to.first][to.second] = captured_piece;
+            captured_piece->setRow(to.first);
+            captured_piece->setColumn(to.second);
+            position_.squares[to_square] = static_cast<uint8_t>(pieceKind(captured_piece));
+            if (captured_piece->hasMoved()) { position_.moved |= uint64_t(1) << to_square; }
+            position_.hash ^= Zobrist::pieceKey(position_.squares[to_square], to.first, to.second);
         }
 
         //Always pop
@@ -14,8 +14,13 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <stack>
+#include <cstdint>
 
+#include "MemoryReport.hpp"
 #include "Move.hpp"
+#include "Position.hpp"
+#include "PositionView.hpp"
+#include "Zobrist.hpp"
 #include "pieces_module.hpp"
 
 namespace BoardColorizer {
@@ -40,8 +45,6 @@ class ChessBoard {
         // Define board size (8x8)
         static const int BOARD_LENGTH = 8;
         
-        bool playerOneTurn;
-        
         std::string p1_color;
         std::string p2_color;
 
@@ -51,7 +54,71 @@ class ChessBoard {
 
         std::stack<Move> past_moves_; // Stores all previously executed moves
 
+        // The position as a plain value (kinds, moved flags, side to move and Zobrist hash),
+        // kept up to date by every move / undo alongside `board`
+        Position position_;
+
+        /**
+         * @brief Allocates a ChessPiece derived class matching `type` ("PAWN", "ROOK", ...)
+         * @return A pointer to the new piece, or nullptr if `type` is unknown
+         */
+        static ChessPiece* createPiece(const std::string& type, const std::string& color, const int& row, const int& col, const bool& movingUp);
+
+        /**
+         * @brief Moves the piece on `from` to `to` without any validation, updating
+         *        the board, the piece's row / col / moved flag and the hash.
+         */
+        void applyMove(const Square& from, const Square& to);
+
+        /**
+         * @brief Toggles the side to move and its component of the hash
+         */
+        void switchTurn();
+
+        /**
+         * @brief Rebuilds position_ from the pieces on the board, hash included
+         */
+        void syncPosition();
+
+        /**
+         * @brief Takes every piece off the board and puts one of kind squares[i] on each square i
+         *        of `cells` (nullptr where EMPTY), reusing the pieces this board owns (recolored
+         *        if needed) and allocating only when it owns fewer of a kind than needed.
+         *        Pieces left over stay owned, off the board. Neither `board` nor the moved
+         *        flags are touched.
+         */
+        void placePieces(const uint8_t squares[64], ChessPiece* cells[64]);
+
+        /**
+         * @brief Determines whether any piece of color `attacker_color` can move onto (row, col)
+         */
+        bool isSquareAttacked(const int& row, const int& col, const std::string& attacker_color) const;
+
+        /**
+         * @brief Determines whether the King of color `color` is attacked by the other player
+         */
+        bool isKingAttacked(const std::string& color) const;
+
+        /**
+         * @brief Deallocates every piece and empties the board and move history
+         */
+        void clear();
+
+        /**
+         * @brief In a CHESS_VERIFY_STATE build, runs verifyState() on one call in N on average
+         *        (N = CHESS_VERIFY_STATE) and aborts with the differences on a mismatch
+         * @param operation The operation that just finished ("make", "unmake"), for the report
+         */
+        void checkState(const char* operation) const;
+
     public:
+        // The standard starting position, in the FEN conventions of loadFEN()
+        inline static const std::string STARTING_FEN = "rnbkqbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBKQBNR w - - 0 1";
+
+        // The format version written by toSnapshot(); loadSnapshot() rejects any other.
+        // Version 2 writes every field little-endian, and the position with Position::encode().
+        static const uint32_t SNAPSHOT_VERSION = 2;
+
         /**
          * Default / Parameterized constructor. 
          * @pre assignedColorP1 & assignedColorP2 represent colors present in the ALLOWED_COLORS list
@@ -82,7 +149,7 @@ class ChessBoard {
          *      
          *          (With * denoting empty cells)
          * 
-         * 2) playerOneTurn is set to true.
+         * 2) It is Player One's turn.
          * 3) p1_color is set to "BLACK", and p2_color is set to "WHITE" if not provided, or they are equal
          */
         ChessBoard(const std::string& assignedColorP1 = "BLACK", const std::string& assignedColorP2 = "WHITE");
@@ -90,8 +157,9 @@ class ChessBoard {
         /**
          * Constructs a ChessBoard object.
          *
-         * This constructor initializes the chessboard with the provided 2D vector of 
-         * ChessPiece* pointers. It also tracks all non-null pieces on the board.
+         * This constructor initializes the chessboard with clones of the pieces in the
+         * provided 2D vector of ChessPiece* pointers. The caller keeps ownership of its
+         * own pieces, so any number of boards can be built from the same state.
          *
          * @param instance The state of the chessboard to copy, represented as a 
          *                 2D vector of ChessPiece* pointers.
@@ -99,11 +167,90 @@ class ChessBoard {
          */
         ChessBoard(const std::vector<std::vector<ChessPiece*>>& board, const bool& p1Turn);
 
+        /**
+         * @brief Constructs a board (with the default colors) on `position`
+         */
+        explicit ChessBoard(const Position& position);
+
+        /**
+         * @brief Copy constructor. Performs a deep copy through setPosition(other.getPosition()):
+         *        every piece is allocated again, so both boards own (and later deallocate) their own pieces.
+         * @post The new board has the same pieces, colors, turn and hash as `other`.
+         *       The move history is NOT copied, as its Moves point into `other`'s pieces.
+         */
+        ChessBoard(const ChessBoard& other);
+
+        /**
+         * Boards own their pieces, so assigning one board to another is not allowed.
+         */
+        ChessBoard& operator=(const ChessBoard& other) = delete;
+
+        /**
+         * @brief Replaces the current position with the one described by a FEN string.
+         * 
+         *        The FEN is read relative to this board's layout: uppercase letters are
+         *        Player One's pieces (moving up from row 0), the first rank listed is row 7,
+         *        and the side to move "w" denotes Player One. Castling, en passant and
+         *        move counters are accepted but ignored, as they have no effect here.
+         *        Pawns that are off their starting row are flagged as having moved.
+         * 
+         * @param fen The FEN string to load.
+         * @return True if the FEN was valid and loaded. False otherwise (the board is left unchanged).
+         * @post On success all previous pieces are deallocated and the move history is cleared.
+         */
+        bool loadFEN(const std::string& fen);
+
+        /**
+         * @brief Describes the current position as a FEN string, using the same
+         *        conventions as loadFEN()
+         */
+        std::string toFEN() const;
+
+        /**
+         * @brief Serializes the whole game into a compact binary snapshot: the colors, the
+         *        position, and the move history with what each move captured, so undo()
+         *        keeps working after loadSnapshot(). Versioned (SNAPSHOT_VERSION) and checksummed.
+         */
+        std::string toSnapshot() const;
+
+        /**
+         * @brief Replaces the game with one serialized by toSnapshot(), reading it in one pass.
+         *
+         *        The pieces this board already owns are reused (recolored and moved onto
+         *        their new squares), so a board restored over and over only allocates
+         *        pieces when the snapshot holds more of a kind than it ever had.
+         *
+         * @return True if the snapshot was valid and loaded. False otherwise (the board is left unchanged).
+         */
+        bool loadSnapshot(const std::string& snapshot);
+
         /**
          * @brief Getter for board_ member
+         * @note The pieces are the board's own, changed by every move: other threads must
+         *       not look at them while the game goes on, but read a PositionView instead.
          */
         std::vector<std::vector<ChessPiece*>> getBoardState() const;
 
+        /**
+         * @brief Takes the current position as a plain value: a copy of the one the board keeps
+         */
+        Position getPosition() const;
+
+        /**
+         * @brief Replaces the current position with `position`, copied as is. The pieces this
+         *        board owns are reused as in loadSnapshot(), so re-seating a board on another
+         *        position of the same game allocates nothing.
+         * @post The move history is cleared.
+         */
+        void setPosition(const Position& position);
+
+        /**
+         * @brief Publishes the current position and the number of moves played to `view`,
+         *        for other threads to read while this board goes on. Call it from the
+         *        thread playing the game, after each move of the game (not of a search).
+         */
+        void publish(PositionView& view) const;
+
         /**
         * @brief Moves the piece at (row,col) to (new_row, new_col), if possible
         * 
@@ -134,9 +281,91 @@ class ChessBoard {
          */
         ChessPiece* getCell(const int& row, const int& col) const;
 
-        /*
-        Gets the playerOneTurn member. 
-        */
+        /**
+         * @brief Gets the kind of `piece` as used by Zobrist and the evaluation:
+         *        PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING map to 0-5 for Player One
+         *        and to 6-11 for Player Two.
+         */
+        int pieceKind(const ChessPiece* piece) const;
+
+        /**
+         * @brief Determines whether it is Player One's turn
+         */
+        bool isPlayerOneTurn() const;
+
+        /**
+         * @brief Gets the Zobrist hash of the current position (pieces & side to move)
+         */
+        uint64_t getHash() const;
+
+        /**
+         * @brief Computes the Zobrist hash of the current position from scratch
+         *        (getHash() returns the incrementally updated one)
+         */
+        uint64_t computeHash() const;
+
+        /**
+         * @brief Checks the incrementally updated state against the board: the hash against
+         *        computeHash(), the kind and moved flag kept for every square against its cell,
+         *        and every piece's row / col against its cell, its presence in the piece list
+         *        and its uniqueness on the board
+         * @param diff Set to one line per mismatch
+         * @return True if everything matches.
+         */
+        bool verifyState(std::string& diff) const;
+
+        /**
+         * @brief Generates every legal move for the player whose turn it is.
+         * 
+         *        A move is legal if the piece "can move" to the target, the target is not
+         *        a KING, and the move does not leave the moving player's King attacked.
+         * 
+         * @return A vector of the legal moves (empty if the player is checkmated or stalemated)
+         */
+        std::vector<Move> generateMoves();
+
+        /**
+         * @brief Determines whether the King of the player whose turn it is is attacked
+         */
+        bool isInCheck() const;
+
+        /**
+         * @brief Counts the leaf nodes of the legal move tree `depth` plies deep (perft),
+         *        used to validate and time move generation
+         * @post The board is left in the same position.
+         */
+        uint64_t perft(const int& depth);
+
+        /**
+         * @brief Adds the memory used by the board to `report`: "board" (the object and its
+         *        grid), "pieces" (every piece ever in play, and the list holding them) and "history"
+         */
+        void reportMemory(MemoryReport& report) const;
+
+        /**
+         * @brief Gets the cells of every piece of Player One (or Player Two) that can move onto (row, col)
+         * @param playerOne True for Player One's pieces, false for Player Two's
+         */
+        std::vector<Square> getAttackers(const int& row, const int& col, const bool& playerOne) const;
+
+        /**
+         * @brief Executes `move` for the player whose turn it is, without validation 
+         *        or console output. Intended for moves returned by generateMoves().
+         * 
+         *        Only the squares of `move` are used, so a move generated on another
+         *        board with the same position may be played.
+         * 
+         * @return True if there was a piece to move.
+         * @post The move is pushed to `past_moves_` and the turn is passed to the other player.
+         */
+        bool makeMove(const Move& move);
+
+        /**
+         * @brief Takes back the most recent move made with makeMove()
+         * @return True if a move was taken back. False if there are no moves to undo.
+         * @post The move is popped from `past_moves_` and the turn is passed back.
+         */
+        bool unmakeMove();
 
         /**
          * @brief Attempts to execute a round of play on the chessboard. A round consists of the 
@@ -150,12 +379,12 @@ class ChessBoard {
          * 4) Records their input, or returns the result of attempting to undo the previous action
          * 5) Attempt to execute the move, using move()
          * 6) If the move is successful, records the action by pushing a Move to past_moves_.
-         * 7) If the move OR undo is successful, toggles the `playerOneTurn` boolean member of `ChessBoard`
+         * 7) If the move OR undo is successful, passes the turn to the other player
          * 
          * @return Returns true if the round has been completed successfully, that is:
          *      - If a pieced was succesfully moved.
          *      - Or a move was successfully undone.
-         * @post The `past_moves_` stack & `playerOneTurn` members are updated as described above
+         * @post The `past_moves_` stack & the side to move are updated as described above
          */
         bool attemptRound();
 
@@ -177,6 +406,8 @@ class ChessBoard {
          *          positions on the board
          *       3) The most recent `Move` object is removed from the `past_moves_`
          *          stack 
+         *       4) If it was the moved piece's first move, its `has_moved_` flag is cleared again
+         *       5) The hash is updated to match the reverted position
          */ 
         bool undo();
 
@@ -0,0 +1,77 @@
+#include "CorpusPipeline.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Constructs a pipeline of `threads` workers writing to `out`
+ */
+CorpusPipeline::CorpusPipeline(std::ostream& out, const int& threads)
+    : out_{out}, threads_{std::max(1, threads)}, next_to_write_{0}, in_flight_{0}, done_reading_{false} {}
+
+/**
+ * @brief Takes games from the queue and runs `task` on them until the input is exhausted
+ */
+void CorpusPipeline::worker(Task task) {
+    while (true) {
+        GameRecord game;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return !queue_.empty() || done_reading_; });
+            if (queue_.empty()) { return; }
+            game = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        std::string output = task(game);
+
+        // Write every finished game that is next in input order
+        std::lock_guard<std::mutex> guard(mutex_);
+        finished_[game.index] = std::move(output);
+        while (!finished_.empty() && finished_.begin()->first == next_to_write_) {
+            out_ << finished_.begin()->second;
+            finished_.erase(finished_.begin());
+            next_to_write_++;
+            in_flight_--;
+        }
+        out_.flush();
+        cv_.notify_all();
+    }
+}
+
+/**
+ * @brief Runs every game read from the PGN stream `in` through a task built by `factory`
+ * @return The number of games processed.
+ */
+size_t CorpusPipeline::run(std::istream& in, const TaskFactory& factory) {
+    const size_t max_in_flight = static_cast<size_t>(threads_) * 4;
+    next_to_write_ = 0;
+    in_flight_ = 0;
+    done_reading_ = false;
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads_; i++) {
+        workers.emplace_back(&CorpusPipeline::worker, this, factory());
+    }
+
+    // Read ahead only while there is room, so the corpus is never held in memory
+    GameReader reader(in);
+    GameRecord game;
+    while (reader.next(game)) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this, &max_in_flight]() { return in_flight_ < max_in_flight; });
+        queue_.push_back(std::move(game));
+        in_flight_++;
+        cv_.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        done_reading_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : workers) { thread.join(); }
+
+    return reader.gamesRead();
+}
@@ -0,0 +1,73 @@
+/**
+ * @class CorpusPipeline
+ * @brief Streams the games of a PGN corpus through a pool of worker threads.
+ *
+ * Games are read one at a time and handed to the workers. Every worker processes
+ * its games with its own task (built by a factory, so each thread can own its board,
+ * search and tables) and returns the text to output for that game. Outputs are
+ * written in input order as soon as they are ready. At most a few games per worker
+ * are in flight at once, so memory use does not depend on the size of the corpus.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "ChessBoard.hpp"
+#include "GameReader.hpp"
+#include "Search.hpp"
+#include "TranspositionTable.hpp"
+
+/**
+ * The engine state a worker thread needs to search positions on its own.
+ */
+struct EngineContext {
+    ChessBoard board;
+    TranspositionTable table;
+    Search search;
+
+    EngineContext(const size_t& table_megabytes) : table{table_megabytes}, search{table} {}
+};
+
+class CorpusPipeline {
+    public:
+        // Processes one game and returns the text to write for it (possibly empty)
+        using Task = std::function<std::string(const GameRecord& game)>;
+        // Builds the task of one worker thread
+        using TaskFactory = std::function<Task()>;
+
+    private:
+        std::ostream& out_;
+        int threads_;
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<GameRecord> queue_;            // Games waiting for a worker
+        std::map<size_t, std::string> finished_;  // Outputs waiting for their turn to be written
+        size_t next_to_write_;
+        size_t in_flight_;                        // Games read but not written yet
+        bool done_reading_;
+
+        /**
+         * @brief Takes games from the queue and runs `task` on them until the input is exhausted
+         */
+        void worker(Task task);
+
+    public:
+        /**
+         * @brief Constructs a pipeline of `threads` workers writing to `out`
+         */
+        CorpusPipeline(std::ostream& out, const int& threads);
+
+        /**
+         * @brief Runs every game read from the PGN stream `in` through a task built by `factory`
+         * @return The number of games processed.
+         */
+        size_t run(std::istream& in, const TaskFactory& factory);
+};
@@ -0,0 +1,192 @@
+#include "EpdSuite.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include "Notation.hpp"
+
+namespace {
+    /*
+    Gets the `percent` percentile (nearest rank) of sorted `values`, or 0 if there are none.
+    */
+    int64_t percentile(const std::vector<int64_t>& values, const int& percent) {
+        if (values.empty()) { return 0; }
+        size_t rank = (values.size() * percent + 99) / 100;
+        return values[std::max<size_t>(rank, 1) - 1];
+    }
+
+    /*
+    Determines whether `move` is one of the legal moves named in `names`.
+    */
+    bool isListed(const ChessBoard& board, const std::vector<Move>& legal, const std::vector<std::string>& names, const Move& move) {
+        for (const std::string& name : names) {
+            int index = Notation::findMove(board, legal, name);
+            if (index >= 0 && legal[index] == move) { return true; }
+        }
+        return false;
+    }
+}
+
+/**
+ * @brief Reads an EPD line: the four FEN fields followed by ';'-terminated operations,
+ *        eg. `r1b1k2r/... w - - bm Nxe5; id "suite.001";`
+ * @return True if the line held a position.
+ */
+bool EpdPosition::parse(const std::string& line, EpdPosition& position) {
+    std::istringstream fields(line);
+    std::string placement, side, castling, en_passant;
+    if (!(fields >> placement >> side >> castling >> en_passant)) { return false; }
+
+    position = EpdPosition();
+    position.fen = placement + " " + side + " " + castling + " " + en_passant + " 0 1";
+
+    std::string operation;
+    while (std::getline(fields, operation, ';')) {
+        std::istringstream tokens(operation);
+        std::string opcode, operand;
+        if (!(tokens >> opcode)) { continue; }
+
+        if (opcode == "id") {
+            std::getline(tokens >> std::ws, operand);
+            operand.erase(std::remove(operand.begin(), operand.end(), '"'), operand.end());
+            position.id = operand;
+        } else if (opcode == "bm" || opcode == "am") {
+            std::vector<std::string>& moves = (opcode == "bm") ? position.best_moves : position.avoid_moves;
+            while (tokens >> operand) { moves.push_back(operand); }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Constructs a runner that searches every position under the limits of `engine`
+ *        (its node, depth and time budgets and its hash size), on `threads` threads
+ */
+EpdSuite::EpdSuite(const EngineConfig& engine, const int& threads)
+    : engine_{engine}, threads_{std::max(1, threads)}, next_position_{0}, finished_{0} {}
+
+/**
+ * @brief Reads the positions of an EPD file. Lines without a valid position,
+ *        or without `bm` and `am` operations, are skipped.
+ * @return The number of positions read.
+ */
+size_t EpdSuite::load(std::istream& in) {
+    ChessBoard board;
+    std::string line;
+    EpdPosition position;
+    while (std::getline(in, line)) {
+        if (!EpdPosition::parse(line, position) || !board.loadFEN(position.fen)) { continue; }
+        if (position.best_moves.empty() && position.avoid_moves.empty()) { continue; }
+
+        if (position.id.empty()) { position.id = "#" + std::to_string(positions_.size() + 1); }
+        positions_.push_back(position);
+    }
+    return positions_.size();
+}
+
+/**
+ * @brief Searches `position` and decides whether it was solved
+ */
+EpdResult EpdSuite::solve(const EpdPosition& position, EngineContext& context) const {
+    EpdResult result;
+    ChessBoard& board = context.board;
+    board.loadFEN(position.fen);
+    context.table.clear();
+
+    std::vector<Move> legal = board.generateMoves();
+    auto correct = [&](const Move& move) {
+        bool best = position.best_moves.empty() || isListed(board, legal, position.best_moves, move);
+        return best && !isListed(board, legal, position.avoid_moves, move);
+    };
+
+    SearchLimits limits;
+    limits.nodes = engine_.nodes;
+    limits.depth = engine_.depth;
+    limits.movetime = engine_.movetime;
+
+    // The solution counts from the first iteration of the final run of correct choices
+    bool settled = false;
+    std::vector<PVLine> lines = context.search.run(board, limits, [&](const SearchReport& report) {
+        if (!correct(report.lines[0].moves[0])) {
+            settled = false;
+        } else if (!settled) {
+            settled = true;
+            result.solve_time = report.elapsed;
+            result.solve_nodes = report.nodes;
+        }
+    });
+
+    result.nodes = context.search.nodes();
+    if (!lines.empty()) {
+        const Move& choice = lines[0].moves[0];
+        result.move = Notation::toSAN(board, choice, legal);
+        result.solved = correct(choice) && settled;
+    }
+    return result;
+}
+
+/**
+ * @brief Searches positions until none are left, logging every result to `log`
+ */
+void EpdSuite::worker(std::ostream& log) {
+    EngineContext context(engine_.table_megabytes);
+
+    while (true) {
+        size_t index = next_position_++;
+        if (index >= positions_.size()) { return; }
+
+        const EpdPosition& position = positions_[index];
+        auto start = std::chrono::steady_clock::now();
+        EpdResult result = solve(position, context);
+        result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        results_[index] = result;
+        finished_++;
+
+        log << finished_ << "/" << positions_.size() << " " << position.id << ": ";
+        if (result.solved) {
+            log << "solved " << result.move << " in " << result.solve_time << " ms, " << result.solve_nodes << " nodes";
+        } else {
+            log << "unsolved, played " << (result.move.empty() ? "nothing" : result.move);
+            for (const std::string& move : position.best_moves) { log << " (bm " << move << ")"; }
+            for (const std::string& move : position.avoid_moves) { log << " (am " << move << ")"; }
+        }
+        log << std::endl;
+    }
+}
+
+/**
+ * @brief Runs the suite, logging every position to `log`
+ * @return The totals of the run.
+ */
+EpdSummary EpdSuite::run(std::ostream& log) {
+    results_.assign(positions_.size(), EpdResult());
+    next_position_ = 0;
+    finished_ = 0;
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads_; i++) {
+        workers.emplace_back(&EpdSuite::worker, this, std::ref(log));
+    }
+    for (auto& thread : workers) { thread.join(); }
+
+    EpdSummary summary;
+    summary.positions = results_.size();
+    std::vector<int64_t> solve_times;
+    for (const EpdResult& result : results_) {
+        summary.nodes += result.nodes;
+        summary.elapsed += result.elapsed;
+        if (result.solved) { solve_times.push_back(result.solve_time); }
+    }
+    std::sort(solve_times.begin(), solve_times.end());
+
+    summary.solved = solve_times.size();
+    summary.p50_time = percentile(solve_times, 50);
+    summary.p90_time = percentile(solve_times, 90);
+    summary.max_time = percentile(solve_times, 100);
+    summary.nps = summary.elapsed ? summary.nodes * 1000 / summary.elapsed : 0;
+    return summary;
+}
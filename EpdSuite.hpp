@@ -0,0 +1,108 @@
+/**
+ * @class EpdSuite
+ * @brief Runs EPD test suites (eg. tactical suites) against the engine.
+ *
+ * Every position of the suite is searched under the same limits. A position is
+ * solved if the engine's final choice is one of its `bm` (best move) moves and none
+ * of its `am` (avoid move) moves. Its time to solution is the moment the engine
+ * settled on a correct move for good: from that iteration to the end of the search
+ * its choice never changed to a wrong one.
+ *
+ * Positions are spread across threads, each searching one position at a time with
+ * its own transposition table.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MatchRunner.hpp"
+
+/**
+ * A test position read from an EPD line.
+ */
+struct EpdPosition {
+    std::string fen;
+    std::string id;
+    std::vector<std::string> best_moves;   // The `bm` operands, in SAN or coordinate notation
+    std::vector<std::string> avoid_moves;  // The `am` operands
+
+    /**
+     * @brief Reads an EPD line: the four FEN fields followed by ';'-terminated operations,
+     *        eg. `r1b1k2r/... w - - bm Nxe5; id "suite.001";`
+     * @return True if the line held a position.
+     */
+    static bool parse(const std::string& line, EpdPosition& position);
+};
+
+/**
+ * The outcome of one test position.
+ */
+struct EpdResult {
+    bool solved = false;
+    std::string move;          // The engine's final choice, in SAN
+    int64_t solve_time = 0;    // Milliseconds until the engine settled on a correct move
+    uint64_t solve_nodes = 0;  // Nodes until the engine settled on a correct move
+    int64_t elapsed = 0;       // Milliseconds searched in total
+    uint64_t nodes = 0;        // Nodes searched in total
+};
+
+/**
+ * The totals of a suite run.
+ */
+struct EpdSummary {
+    size_t positions = 0;
+    size_t solved = 0;
+    int64_t p50_time = 0;      // Time-to-solution percentiles of the solved positions, in milliseconds
+    int64_t p90_time = 0;
+    int64_t max_time = 0;
+    uint64_t nodes = 0;
+    int64_t elapsed = 0;       // Search time summed over all positions, in milliseconds
+    uint64_t nps = 0;          // Nodes per second of search time
+};
+
+class EpdSuite {
+    private:
+        EngineConfig engine_;
+        int threads_;
+        std::vector<EpdPosition> positions_;
+        std::vector<EpdResult> results_;
+
+        std::mutex mutex_;
+        std::atomic<size_t> next_position_;
+        size_t finished_;
+
+        /**
+         * @brief Searches `position` and decides whether it was solved
+         */
+        EpdResult solve(const EpdPosition& position, EngineContext& context) const;
+
+        /**
+         * @brief Searches positions until none are left, logging every result to `log`
+         */
+        void worker(std::ostream& log);
+
+    public:
+        /**
+         * @brief Constructs a runner that searches every position under the limits of `engine`
+         *        (its node, depth and time budgets and its hash size), on `threads` threads
+         */
+        EpdSuite(const EngineConfig& engine, const int& threads);
+
+        /**
+         * @brief Reads the positions of an EPD file. Lines without a valid position,
+         *        or without `bm` and `am` operations, are skipped.
+         * @return The number of positions read.
+         */
+        size_t load(std::istream& in);
+
+        /**
+         * @brief Runs the suite, logging every position to `log`
+         * @return The totals of the run.
+         */
+        EpdSummary run(std::ostream& log);
+};
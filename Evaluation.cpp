@@ -0,0 +1,194 @@
+#include "Evaluation.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "AllocationTracker.hpp"
+#include "Profiler.hpp"
+
+namespace {
+    /*
+    Piece-square tables from Player One's side: row 0 is Player One's back rank.
+    Each table is listed with row 0 first.
+    */
+    const int PIECE_SQUARE[6][64] = {
+        // PAWN: advance, and keep the center pawns moving
+        {
+             0,   0,   0,   0,   0,   0,   0,   0,
+             5,  10,  10, -20, -20,  10,  10,   5,
+             5,  -5, -10,   0,   0, -10,  -5,   5,
+             0,   0,   0,  20,  20,   0,   0,   0,
+             5,   5,  10,  25,  25,  10,   5,   5,
+            10,  10,  20,  30,  30,  20,  10,  10,
+            50,  50,  50,  50,  50,  50,  50,  50,
+             0,   0,   0,   0,   0,   0,   0,   0
+        },
+        // KNIGHT: centralize
+        {
+            -50, -40, -30, -30, -30, -30, -40, -50,
+            -40, -20,   0,   5,   5,   0, -20, -40,
+            -30,   5,  10,  15,  15,  10,   5, -30,
+            -30,   0,  15,  20,  20,  15,   0, -30,
+            -30,   5,  15,  20,  20,  15,   5, -30,
+            -30,   0,  10,  15,  15,  10,   0, -30,
+            -40, -20,   0,   0,   0,   0, -20, -40,
+            -50, -40, -30, -30, -30, -30, -40, -50
+        },
+        // BISHOP: long diagonals, avoid the rim
+        {
+            -20, -10, -10, -10, -10, -10, -10, -20,
+            -10,   5,   0,   0,   0,   0,   5, -10,
+            -10,  10,  10,  10,  10,  10,  10, -10,
+            -10,   0,  10,  10,  10,  10,   0, -10,
+            -10,   5,   5,  10,  10,   5,   5, -10,
+            -10,   0,   5,  10,  10,   5,   0, -10,
+            -10,   0,   0,   0,   0,   0,   0, -10,
+            -20, -10, -10, -10, -10, -10, -10, -20
+        },
+        // ROOK: the seventh row and the center files
+        {
+              0,   0,   0,   5,   5,   0,   0,   0,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+              5,  10,  10,  10,  10,  10,  10,   5,
+              0,   0,   0,   0,   0,   0,   0,   0
+        },
+        // QUEEN: mild centralization
+        {
+            -20, -10, -10,  -5,  -5, -10, -10, -20,
+            -10,   0,   5,   0,   0,   0,   0, -10,
+            -10,   5,   5,   5,   5,   5,   0, -10,
+              0,   0,   5,   5,   5,   5,   0,  -5,
+             -5,   0,   5,   5,   5,   5,   0,  -5,
+            -10,   0,   5,   5,   5,   5,   0, -10,
+            -10,   0,   0,   0,   0,   0,   0, -10,
+            -20, -10, -10,  -5,  -5, -10, -10, -20
+        },
+        // KING: stay home, behind the pawns
+        {
+             20,  30,  10,   0,   0,  10,  30,  20,
+             20,  20,   0,   0,   0,   0,  20,  20,
+            -10, -20, -20, -20, -20, -20, -20, -10,
+            -20, -30, -30, -40, -40, -30, -30, -20,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30
+        }
+    };
+}
+
+/**
+ * Gets the piece-square bonus for a piece kind on the cell (row, col).
+ *
+ * The tables are written for Player One (who starts on row 0);
+ * Player Two's pieces read them with the rows mirrored.
+ *
+ * @param kind The piece kind, as returned by ChessBoard::pieceKind()
+ * @return The bonus in centipawns.
+ */
+int Evaluation::squareBonus(const int& kind, const int& row, const int& col) {
+    int relative_row = (kind < 6) ? row : 7 - row;
+    return PIECE_SQUARE[kind % 6][relative_row * 8 + col];
+}
+
+/**
+ * Evaluates the position on `board`.
+ *
+ * @return The score in centipawns, from the point of view of the player whose turn it is.
+ */
+int Evaluation::evaluate(const ChessBoard& board) {
+    PROFILE_ZONE("evaluate");
+    NO_ALLOC_SCOPE("evaluate");
+    int score = 0; // From Player One's point of view
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            const ChessPiece* piece = board.getCell(row, col);
+            if (!piece) { continue; }
+
+            int kind = board.pieceKind(piece);
+            int value = PIECE_VALUES[kind % 6] + squareBonus(kind, row, col);
+            score += (kind < 6) ? value : -value;
+        }
+    }
+
+    return board.isPlayerOneTurn() ? score : -score;
+}
+
+/**
+ * Counts the material on `board` (piece values only, no square bonuses).
+ *
+ * @return The balance in centipawns, from Player One's point of view.
+ */
+int Evaluation::materialBalance(const ChessBoard& board) {
+    int balance = 0;
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            const ChessPiece* piece = board.getCell(row, col);
+            if (!piece) { continue; }
+
+            int kind = board.pieceKind(piece);
+            balance += (kind < 6) ? PIECE_VALUES[kind % 6] : -PIECE_VALUES[kind % 6];
+        }
+    }
+    return balance;
+}
+
+/**
+ * Static exchange evaluation: plays out the captures on the target square of `move`,
+ * each side always recapturing with its least valuable piece and free to stop
+ * whenever recapturing would lose material.
+ *
+ * @param move A legal move for the player whose turn it is
+ * @return The material the moving player gains (or loses, if negative) in centipawns.
+ * @post `board` is left in the same position it was passed in.
+ */
+int Evaluation::staticExchange(ChessBoard& board, const Move& move) {
+    const Square target = move.getTargetPosition();
+    const ChessPiece* captured = board.getCell(target.first, target.second);
+    const ChessPiece* mover = board.getCell(move.getOriginalPosition().first, move.getOriginalPosition().second);
+
+    // gains[i] is the material won by the side making the i-th capture, if the exchange stopped there
+    std::vector<int> gains;
+    gains.push_back(captured ? PIECE_VALUES[board.pieceKind(captured) % 6] : 0);
+    int on_target = PIECE_VALUES[board.pieceKind(mover) % 6];
+    board.makeMove(move);
+    int played = 1;
+
+    while (true) {
+        // Recapture with the least valuable piece, the King last
+        std::vector<Square> attackers = board.getAttackers(target.first, target.second, board.isPlayerOneTurn());
+        auto rank = [&board](const Square& cell) {
+            int kind = board.pieceKind(board.getCell(cell.first, cell.second)) % 6;
+            return kind == 5 ? 100000 : PIECE_VALUES[kind];
+        };
+        auto least = std::min_element(attackers.begin(), attackers.end(),
+            [&rank](const Square& a, const Square& b) { return rank(a) < rank(b); });
+        if (least == attackers.end()) { break; }
+
+        const bool king = rank(*least) == 100000;
+        gains.push_back(on_target - gains.back());
+        on_target = king ? 0 : PIECE_VALUES[board.pieceKind(board.getCell(least->first, least->second)) % 6];
+        board.makeMove(Move(*least, target, nullptr));
+        played++;
+
+        // The King may only recapture if the square is no longer defended
+        if (king && !board.getAttackers(target.first, target.second, board.isPlayerOneTurn()).empty()) {
+            board.unmakeMove();
+            played--;
+            gains.pop_back();
+            break;
+        }
+    }
+
+    for (int i = 0; i < played; i++) { board.unmakeMove(); }
+
+    // Either side may decline to continue the exchange
+    for (size_t i = gains.size() - 1; i > 0; i--) {
+        gains[i - 1] = -std::max(-gains[i - 1], gains[i]);
+    }
+    return gains[0];
+}
@@ -0,0 +1,55 @@
+/**
+ * @brief Static evaluation of a ChessBoard position.
+ *
+ * Scores are in centipawns from the point of view of the player whose turn it is
+ * (positive means that player is better). The evaluation is material plus a
+ * piece-square bonus for every piece.
+ */
+
+#pragma once
+
+#include "ChessBoard.hpp"
+
+namespace Evaluation {
+    /*
+    Values of PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING (indexed like ChessBoard::pieceKind()).
+    The King is never captured, so it carries no material value.
+    */
+    const int PIECE_VALUES[6] = {100, 320, 330, 500, 900, 0};
+
+    /**
+     * Gets the piece-square bonus for a piece kind on the cell (row, col).
+     *
+     * The tables are written for Player One (who starts on row 0);
+     * Player Two's pieces read them with the rows mirrored.
+     *
+     * @param kind The piece kind, as returned by ChessBoard::pieceKind()
+     * @return The bonus in centipawns.
+     */
+    int squareBonus(const int& kind, const int& row, const int& col);
+
+    /**
+     * Evaluates the position on `board`.
+     *
+     * @return The score in centipawns, from the point of view of the player whose turn it is.
+     */
+    int evaluate(const ChessBoard& board);
+
+    /**
+     * Counts the material on `board` (piece values only, no square bonuses).
+     *
+     * @return The balance in centipawns, from Player One's point of view.
+     */
+    int materialBalance(const ChessBoard& board);
+
+    /**
+     * Static exchange evaluation: plays out the captures on the target square of `move`,
+     * each side always recapturing with its least valuable piece and free to stop
+     * whenever recapturing would lose material.
+     *
+     * @param move A legal move for the player whose turn it is
+     * @return The material the moving player gains (or loses, if negative) in centipawns.
+     * @post `board` is left in the same position it was passed in.
+     */
+    int staticExchange(ChessBoard& board, const Move& move);
+};
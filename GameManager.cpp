@@ -0,0 +1,690 @@
+#include "GameManager.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    /*
+    Game ids: the shard in the low 8 bits, then the slot in the next 24, then the slot's generation.
+    */
+    GameManager::GameId makeId(const size_t& shard, const uint32_t& slot, const uint32_t& generation) {
+        return static_cast<GameManager::GameId>(shard) | (static_cast<GameManager::GameId>(slot) << 8)
+             | (static_cast<GameManager::GameId>(generation) << 32);
+    }
+
+    size_t shardOf(const GameManager::GameId& id) {
+        return id & 0xFF;
+    }
+
+    uint32_t slotOf(const GameManager::GameId& id) {
+        return static_cast<uint32_t>((id >> 8) & 0xFFFFFF);
+    }
+
+    uint32_t generationOf(const GameManager::GameId& id) {
+        return static_cast<uint32_t>(id >> 32);
+    }
+
+    const char SNAPSHOT_MAGIC[4] = {'C', 'H', 'S', 'N'};
+
+    std::string snapshotPath(const std::string& directory) {
+        return directory + "/snapshot.bin";
+    }
+
+    /*
+    Appends an integer to a snapshot, little-endian.
+    */
+    template <typename T>
+    void put(std::string& out, const T& value) {
+        static_assert(std::is_integral<T>::value, "Snapshots hold integers and encoded positions only");
+        for (size_t i = 0; i < sizeof(T); i++) { out.push_back(static_cast<char>(static_cast<uint64_t>(value) >> (8 * i))); }
+    }
+
+    void put(std::string& out, const Position& position) {
+        char encoded[Position::ENCODED_SIZE];
+        position.encode(encoded);
+        out.append(encoded, sizeof(encoded));
+    }
+
+    /*
+    Reads values back from a snapshot, failing once past the end (or on an invalid position).
+    */
+    struct Cursor {
+        const std::string& data;
+        size_t offset = 0;
+
+        template <typename T>
+        bool get(T& value) {
+            static_assert(std::is_integral<T>::value, "Snapshots hold integers and encoded positions only");
+            if (offset + sizeof(T) > data.size()) { return false; }
+            uint64_t read = 0;
+            for (size_t i = 0; i < sizeof(T); i++) {
+                read |= static_cast<uint64_t>(static_cast<unsigned char>(data[offset + i])) << (8 * i);
+            }
+            value = static_cast<T>(read);
+            offset += sizeof(T);
+            return true;
+        }
+
+        bool get(Position& position) {
+            if (offset + Position::ENCODED_SIZE > data.size() || !position.decode(data.data() + offset)) { return false; }
+            offset += Position::ENCODED_SIZE;
+            return true;
+        }
+    };
+}
+
+/**
+ * @brief Constructs a manager with `shards` shards, each with its own worker thread
+ */
+GameManager::GameManager(const int& shards) : live_games_{0}, next_shard_{0}, pending_{0}, log_{nullptr}, awaiting_log_{0} {
+    const int count = std::clamp(shards, 1, static_cast<int>(MAX_SHARDS));
+    for (int i = 0; i < count; i++) { shards_.push_back(std::make_unique<Shard>()); }
+    for (auto& shard : shards_) {
+        Shard& owned = *shard;
+        shard->worker = std::thread([this, &owned]() { work(owned); });
+    }
+}
+
+/**
+ * @brief Stops the workers. Moves still queued are dropped without a callback; moves
+ *        waiting for the log are reported first.
+ */
+GameManager::~GameManager() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> guard(shard->queue_mutex);
+        shard->stopping = true;
+        shard->wake.notify_one();
+    }
+    for (auto& shard : shards_) { shard->worker.join(); }
+
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_.wait(lock, [this]() { return awaiting_log_ == 0; });
+}
+
+/**
+ * @brief Gets the game named by `id` in `shard`, or nullptr if it has ended or never existed
+ * @pre The shard's mutex is held.
+ */
+GameManager::Game* GameManager::find(Shard& shard, const GameId& id) const {
+    const uint32_t slot = slotOf(id);
+    if (slot >= shard.games.size()) { return nullptr; }
+
+    Game& game = shard.games[slot];
+    return (game.live && game.generation == generationOf(id)) ? &game : nullptr;
+}
+
+/**
+ * @brief Starts a game from `start`
+ * @return The id of the new game.
+ */
+GameManager::GameId GameManager::createGame(const Position& start) {
+    // Spread the games evenly over the shards
+    const size_t index = next_shard_++ % shards_.size();
+    Shard& shard = *shards_[index];
+
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    uint32_t slot;
+    if (!shard.free_slots.empty()) {
+        slot = shard.free_slots.back();
+        shard.free_slots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(shard.games.size());
+        shard.games.emplace_back();
+    }
+
+    Game& game = shard.games[slot];
+    game.position = start;
+    game.history.clear();
+    game.status = Status::ACTIVE;
+    game.live = true;
+    live_games_++;
+
+    const GameId id = makeId(index, slot, game.generation);
+    if (log_) { log_->append(MoveLog::Type::CREATE, id, 0, 0, &start); }
+    return id;
+}
+
+/**
+ * @brief Ends a game and frees its slot
+ * @return False if there is no such game.
+ */
+bool GameManager::endGame(const GameId& id) {
+    if (shardOf(id) >= shards_.size()) { return false; }
+    Shard& shard = *shards_[shardOf(id)];
+
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    Game* game = find(shard, id);
+    if (!game) { return false; }
+
+    if (log_) { log_->append(MoveLog::Type::END, id, game->history.size()); }
+    game->live = false;
+    game->status = Status::ENDED;
+    game->generation++;
+    game->view.reset();
+    std::vector<MoveGenerator::MoveWord>().swap(game->history);
+    shard.free_slots.push_back(slotOf(id));
+    live_games_--;
+    return true;
+}
+
+/**
+ * @brief Plays `move` in the game named by `id`
+ * @param lsn Set to the log sequence number of the move's record, or 0 if it was not logged.
+ * @param before Set to the position the move was played in.
+ */
+GameManager::MoveOutcome GameManager::play(const GameId& id, const MoveGenerator::MoveWord& move, uint64_t& lsn,
+                                           Position& before) {
+    lsn = 0;
+    MoveOutcome outcome;
+    outcome.game = id;
+    outcome.move = move;
+    if (shardOf(id) >= shards_.size()) { return outcome; }
+    Shard& shard = *shards_[shardOf(id)];
+
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    Game* game = find(shard, id);
+    if (!game) { return outcome; }
+
+    outcome.status = game->status;
+    outcome.plies = static_cast<uint32_t>(game->history.size());
+    outcome.position = game->position;
+    if (game->status != Status::ACTIVE) {
+        outcome.result = MoveResult::GAME_OVER;
+        return outcome;
+    }
+    if (!MoveGenerator::isLegal(game->position, move)) {
+        outcome.result = MoveResult::ILLEGAL;
+        return outcome;
+    }
+    // A failed log makes nothing durable any more, so the move would only be taken back
+    if (log_ && log_->failed()) {
+        outcome.result = MoveResult::NOT_DURABLE;
+        return outcome;
+    }
+
+    before = game->position;
+    MoveGenerator::apply(game->position, move);
+    game->history.push_back(move);
+
+    MoveGenerator::MoveList replies;
+    if (MoveGenerator::generate(game->position, replies) == 0) {
+        game->status = MoveGenerator::isInCheck(game->position) ? Status::CHECKMATE : Status::STALEMATE;
+    }
+    // Logged under the shard's lock, so the records of a game are in the order of its moves
+    if (log_) { lsn = log_->append(MoveLog::Type::MOVE, id, game->history.size(), move); }
+    // Published under it too, which makes its holder the view's only publisher
+    if (game->view) { game->view->publish(game->position, static_cast<uint32_t>(game->history.size())); }
+
+    outcome.result = MoveResult::ACCEPTED;
+    outcome.status = game->status;
+    outcome.plies = static_cast<uint32_t>(game->history.size());
+    outcome.position = game->position;
+    return outcome;
+}
+
+/**
+ * @brief Validates and plays `move` in a game, on the calling thread
+ */
+GameManager::MoveOutcome GameManager::playMove(const GameId& id, const MoveGenerator::MoveWord& move) {
+    uint64_t lsn;
+    Position before;
+    MoveOutcome outcome = play(id, move, lsn, before);
+    if (lsn && !log_->waitDurable(lsn)) { return takeBack(outcome, before); }
+    return outcome;
+}
+
+/**
+ * @brief Takes back the accepted move of `outcome`, whose record did not reach the log,
+ *        along with the moves played after it in its game
+ * @return The outcome to report instead: NOT_DURABLE, with the game as it now stands.
+ */
+GameManager::MoveOutcome GameManager::takeBack(const MoveOutcome& outcome, const Position& before) {
+    MoveOutcome rejected = outcome;
+    rejected.result = MoveResult::NOT_DURABLE;
+    Shard& shard = *shards_[shardOf(outcome.game)];
+
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    Game* game = find(shard, outcome.game);
+    if (!game) {
+        rejected.status = Status::ENDED;
+        return rejected;
+    }
+
+    // The moves played after it were logged after it, so they are not durable either:
+    // they go too, whichever of them is reported first
+    if (game->history.size() >= outcome.plies && game->history[outcome.plies - 1] == outcome.move) {
+        game->history.resize(outcome.plies - 1);
+        game->position = before;
+        game->status = Status::ACTIVE;
+        if (game->view) { game->view->publish(game->position, static_cast<uint32_t>(game->history.size())); }
+    }
+    rejected.status = game->status;
+    rejected.plies = static_cast<uint32_t>(game->history.size());
+    rejected.position = game->position;
+    return rejected;
+}
+
+/**
+ * @brief Queues `move` on the worker of the game's shard, which validates and plays it
+ *        and then calls `callback` (from the worker thread, or from the log's flusher
+ *        thread once the move is durable, without any lock held)
+ */
+void GameManager::submitMove(const GameId& id, const MoveGenerator::MoveWord& move, const Callback& callback) {
+    Shard& shard = *shards_[shardOf(id) < shards_.size() ? shardOf(id) : 0];
+    pending_++;
+
+    std::lock_guard<std::mutex> guard(shard.queue_mutex);
+    shard.queue.push_back({id, move, callback});
+    shard.wake.notify_one();
+}
+
+/**
+ * @brief Runs the jobs queued on `shard` until the manager is destroyed
+ */
+void GameManager::work(Shard& shard) {
+    std::deque<Job> jobs;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(shard.queue_mutex);
+            shard.wake.wait(lock, [&shard]() { return shard.stopping || !shard.queue.empty(); });
+            if (shard.stopping) { return; }
+            jobs.swap(shard.queue);
+        }
+
+        // Take the whole queue at once, so producers are only held up for a swap
+        for (const Job& job : jobs) {
+            uint64_t lsn;
+            Position before;
+            MoveOutcome outcome = play(job.game, job.move, lsn, before);
+            if (!lsn) {
+                if (job.callback) { job.callback(outcome); }
+                finishJob();
+                continue;
+            }
+
+            // The move is only reported once its record is durable
+            awaiting_log_++;
+            log_->whenDurable(lsn, [this, callback = job.callback, outcome, before](bool durable) {
+                const MoveOutcome reported = durable ? outcome : takeBack(outcome, before);
+                if (callback) { callback(reported); }
+                finishJob();
+                std::lock_guard<std::mutex> guard(idle_mutex_);
+                if (--awaiting_log_ == 0) { idle_.notify_all(); }
+            });
+        }
+        jobs.clear();
+    }
+}
+
+/**
+ * @brief Counts a queued move as reported, waking waitIdle() after the last one
+ */
+void GameManager::finishJob() {
+    if (pending_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> guard(idle_mutex_);
+        idle_.notify_all();
+    }
+}
+
+/**
+ * @brief Waits until every queued move has been played and reported
+ */
+void GameManager::waitIdle() {
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+/**
+ * @brief Logs every change to the games from now on to `log`, which must stay open
+ *        until the manager is destroyed
+ */
+void GameManager::setLog(MoveLog* log) {
+    log_ = log;
+}
+
+/**
+ * @brief Snapshots every game next to the attached log, then deletes the log segments
+ *        the snapshot covers
+ * @return False if there is no log, the log has failed or the snapshot can not be written.
+ *         Otherwise error() says why.
+ */
+bool GameManager::checkpoint() {
+    if (!log_) {
+        error_ = "no log attached";
+        return false;
+    }
+
+    // Every record in the closed segments was appended after its change was made, so the
+    // snapshot taken below includes them all. Records that land in later segments while
+    // it is taken may be in it too; recover() skips those.
+    uint64_t closed;
+    if (!log_->rotate(closed)) {
+        error_ = log_->error();
+        return false;
+    }
+
+    std::string data;
+    data.append(SNAPSHOT_MAGIC, 4);
+    const uint32_t version = MoveLog::VERSION;
+    put(data, version);
+    put(data, static_cast<uint32_t>(shards_.size()));
+    put(data, closed + 1);
+    for (const auto& shard : shards_) {
+        // One shard at a time, so the games of the others go on being played
+        std::lock_guard<std::mutex> guard(shard->mutex);
+        put(data, static_cast<uint32_t>(shard->games.size()));
+        for (const Game& game : shard->games) {
+            put(data, game.generation);
+            put(data, static_cast<uint8_t>(game.live));
+            if (!game.live) { continue; }
+            put(data, static_cast<uint8_t>(game.status));
+            put(data, static_cast<uint32_t>(game.history.size()));
+            put(data, game.position);
+            data.append(reinterpret_cast<const char*>(game.history.data()), game.history.size() * sizeof(MoveGenerator::MoveWord));
+        }
+    }
+    put(data, MoveLog::checksum(data.data(), data.size()));
+
+    // Written aside and renamed over the old snapshot, which stays valid until then
+    const std::string& directory = log_->directory();
+    const std::string path = snapshotPath(directory);
+    const std::string temporary = path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error_ = temporary + ": " + std::strerror(errno);
+        return false;
+    }
+    const char* bytes = data.data();
+    size_t left = data.size();
+    while (left) {
+        ssize_t written = ::write(fd, bytes, left);
+        if (written < 0 && errno == EINTR) { continue; }
+        if (written <= 0) { break; }
+        bytes += written;
+        left -= written;
+    }
+    if (left || ::fsync(fd) < 0) {
+        error_ = temporary + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    ::close(fd);
+
+    // The snapshot may hold moves whose records are not durable yet. If the log fails before
+    // they are, those moves are taken back, so the snapshot must not replace the old one.
+    if (!log_->waitDurable(log_->lastLsn())) {
+        error_ = log_->error();
+        std::remove(temporary.c_str());
+        return false;
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        error_ = path + ": " + std::strerror(errno);
+        return false;
+    }
+    int dir = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir >= 0) {
+        ::fsync(dir);
+        ::close(dir);
+    }
+
+    for (const uint64_t& segment : MoveLog::listSegments(directory)) {
+        if (segment <= closed) { std::remove(MoveLog::segmentPath(directory, segment).c_str()); }
+    }
+    return true;
+}
+
+/**
+ * @brief Rebuilds the games of an empty manager from the snapshot and log segments
+ *        in `directory`. The manager must have as many shards as the one that wrote them.
+ * @return False if they can not be read. Otherwise error() says why.
+ */
+bool GameManager::recover(const std::string& directory, RecoveryStats& stats) {
+    stats = RecoveryStats();
+    uint64_t first_segment = 0;
+
+    std::ifstream in(snapshotPath(directory), std::ios::binary);
+    if (in) {
+        // One read for the whole snapshot
+        const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        uint32_t sum;
+        if (data.size() < 20 + sizeof(sum) || std::memcmp(data.data(), SNAPSHOT_MAGIC, 4) != 0) {
+            error_ = snapshotPath(directory) + ": not a snapshot";
+            return false;
+        }
+        Cursor tail{data, data.size() - sizeof(sum)};
+        tail.get(sum);
+        if (sum != MoveLog::checksum(data.data(), data.size() - sizeof(sum))) {
+            error_ = snapshotPath(directory) + ": corrupt snapshot";
+            return false;
+        }
+
+        Cursor cursor{data, 4};
+        uint32_t version = 0;
+        uint32_t shards = 0;
+        cursor.get(version);
+        cursor.get(shards);
+        cursor.get(first_segment);
+        if (version != MoveLog::VERSION) {
+            error_ = snapshotPath(directory) + ": unsupported version " + std::to_string(version);
+            return false;
+        }
+        if (shards != shards_.size()) {
+            error_ = snapshotPath(directory) + ": written with " + std::to_string(shards) + " shards, not "
+                   + std::to_string(shards_.size());
+            return false;
+        }
+
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> guard(shard->mutex);
+            uint32_t slots = 0;
+            bool ok = cursor.get(slots);
+            shard->games.assign(ok ? slots : 0, Game());
+            for (Game& game : shard->games) {
+                uint8_t live = 0;
+                uint8_t status = 0;
+                uint32_t plies = 0;
+                ok = ok && cursor.get(game.generation) && cursor.get(live) && live <= 1;
+                if (!ok || !live) { continue; }
+                // A game that has not ended is active, checkmated or stalemated: any other value is corrupt
+                ok = cursor.get(status) && status <= static_cast<uint8_t>(Status::STALEMATE) && cursor.get(plies)
+                  && cursor.get(game.position);
+                game.status = static_cast<Status>(status);
+                game.history.resize(ok ? plies : 0);
+                for (MoveGenerator::MoveWord& move : game.history) { ok = ok && cursor.get(move); }
+                game.live = ok;
+                stats.snapshot_games += ok;
+            }
+            if (!ok) {
+                error_ = snapshotPath(directory) + ": truncated or invalid snapshot";
+                return false;
+            }
+        }
+    }
+
+    // Sort the records by shard: the records of a shard were appended under its lock,
+    // so they are in the order its games changed
+    struct Entry {
+        MoveLog::Record record;
+        Position start;
+    };
+    std::vector<std::vector<Entry>> entries(shards_.size());
+    bool foreign = false;
+    for (const uint64_t& segment : MoveLog::listSegments(directory)) {
+        if (segment < first_segment) { continue; }
+        stats.records += MoveLog::readSegment(MoveLog::segmentPath(directory, segment),
+                                              [&](const MoveLog::Record& record, const Position* start) {
+            if (shardOf(record.game) >= entries.size()) {
+                foreign = true;
+                return;
+            }
+            entries[shardOf(record.game)].push_back({record, start ? *start : Position{}});
+        });
+    }
+    if (foreign) {
+        error_ = directory + ": the log names more shards than " + std::to_string(shards_.size());
+        return false;
+    }
+
+    // Replay each shard on its own thread
+    std::vector<RecoveryStats> shard_stats(shards_.size());
+    std::vector<size_t> shard_live(shards_.size(), 0);
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < shards_.size(); index++) {
+        threads.emplace_back([this, index, &entries, &shard_stats, &shard_live]() {
+            Shard& shard = *shards_[index];
+            RecoveryStats& counted = shard_stats[index];
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            for (const Entry& entry : entries[index]) {
+                const MoveLog::Record& record = entry.record;
+                const uint32_t slot = slotOf(record.game);
+                const uint32_t generation = generationOf(record.game);
+                if (slot >= shard.games.size()) { shard.games.resize(slot + 1); }
+                Game& game = shard.games[slot];
+
+                bool applied = false;
+                bool rejected = false;
+                if (record.type == MoveLog::Type::CREATE) {
+                    // Skipped when the snapshot already has the game or has seen it end
+                    if (game.generation < generation || (game.generation == generation && !game.live)) {
+                        game.position = entry.start;
+                        game.history.clear();
+                        game.generation = generation;
+                        game.status = Status::ACTIVE;
+                        game.live = true;
+                        applied = true;
+                    }
+                } else if (!game.live || game.generation != generation) {
+                    rejected = (game.generation < generation);
+                } else if (record.type == MoveLog::Type::END) {
+                    game.live = false;
+                    game.status = Status::ENDED;
+                    game.generation++;
+                    std::vector<MoveGenerator::MoveWord>().swap(game.history);
+                    applied = true;
+                } else if (record.sequence > game.history.size()) {
+                    if (record.sequence != game.history.size() + 1 || game.status != Status::ACTIVE
+                        || !MoveGenerator::isLegal(game.position, record.move)) {
+                        rejected = true;
+                    } else {
+                        MoveGenerator::apply(game.position, record.move);
+                        game.history.push_back(record.move);
+                        MoveGenerator::MoveList replies;
+                        if (MoveGenerator::generate(game.position, replies) == 0) {
+                            game.status = MoveGenerator::isInCheck(game.position) ? Status::CHECKMATE : Status::STALEMATE;
+                        }
+                        applied = true;
+                    }
+                }
+                counted.replayed += applied;
+                counted.rejected += rejected;
+            }
+
+            shard.free_slots.clear();
+            for (uint32_t slot = static_cast<uint32_t>(shard.games.size()); slot-- > 0;) {
+                if (shard.games[slot].live) { shard_live[index]++; }
+                else { shard.free_slots.push_back(slot); }
+            }
+        });
+    }
+    for (std::thread& thread : threads) { thread.join(); }
+
+    size_t live = 0;
+    for (size_t index = 0; index < shards_.size(); index++) {
+        stats.replayed += shard_stats[index].replayed;
+        stats.rejected += shard_stats[index].rejected;
+        live += shard_live[index];
+    }
+    live_games_ = live;
+    return true;
+}
+
+/**
+ * @brief Gets the reason recover() or checkpoint() failed
+ */
+const std::string& GameManager::error() const {
+    return error_;
+}
+
+/**
+ * @brief Copies the state of a game
+ * @return False if there is no such game.
+ */
+bool GameManager::getGame(const GameId& id, Position& position, uint32_t& plies, Status& status) const {
+    if (shardOf(id) >= shards_.size()) { return false; }
+    Shard& shard = *shards_[shardOf(id)];
+
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    const Game* game = find(shard, id);
+    if (!game) { return false; }
+
+    position = game->position;
+    plies = static_cast<uint32_t>(game->history.size());
+    status = game->status;
+    return true;
+}
+
+/**
+ * @brief Gets a view of a game that any thread can read without a lock. Every move
+ *        played in the game (and every move taken back) is published to it as soon
+ *        as it is played, before it is durable. Once the game ends, the view keeps
+ *        its last position.
+ * @return nullptr if there is no such game.
+ */
+std::shared_ptr<const PositionView> GameManager::watch(const GameId& id) {
+    if (shardOf(id) >= shards_.size()) { return nullptr; }
+    Shard& shard = *shards_[shardOf(id)];
+
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    Game* game = find(shard, id);
+    if (!game) { return nullptr; }
+
+    if (!game->view) {
+        game->view = std::make_shared<PositionView>();
+        game->view->publish(game->position, static_cast<uint32_t>(game->history.size()));
+    }
+    return game->view;
+}
+
+/**
+ * @brief Gets the number of games that have not ended
+ */
+size_t GameManager::liveGames() const {
+    return live_games_;
+}
+
+/**
+ * @brief Gets the number of shards
+ */
+int GameManager::shardCount() const {
+    return static_cast<int>(shards_.size());
+}
+
+/**
+ * @brief Adds the memory used by the games to `report`: "games" (the game slots and
+ *        their positions), "game history", "game views" and "game shards"
+ */
+void GameManager::reportMemory(MemoryReport& report) const {
+    report.add("game shards", sizeof(GameManager) + shards_.size() * (sizeof(Shard) + sizeof(std::unique_ptr<Shard>)), shards_.size());
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> guard(shard->mutex);
+        size_t history = 0;
+        size_t plies = 0;
+        size_t views = 0;
+        for (const Game& game : shard->games) {
+            history += game.history.capacity() * sizeof(MoveGenerator::MoveWord);
+            plies += game.history.size();
+            views += (game.view != nullptr);
+        }
+        report.add("games", shard->games.capacity() * sizeof(Game) + shard->free_slots.capacity() * sizeof(uint32_t),
+                   shard->games.size() - shard->free_slots.size());
+        report.add("game history", history, plies);
+        report.add("game views", views * sizeof(PositionView), views);
+    }
+}
@@ -0,0 +1,257 @@
+/**
+ * @class GameManager
+ * @brief Hosts a large number of simultaneous games in one process.
+ *
+ * A game is a Position, its history as packed move words (MoveGenerator::MoveWord, two
+ * bytes per ply) and a status: about 140 bytes plus the history, where a ChessBoard
+ * needs 32 heap pieces, a list and a deque. Moves are validated and played by
+ * MoveGenerator, whose tables, like the Zobrist keys, are shared read-only.
+ *
+ * Games are spread over shards, each with its own lock, game slots and worker thread.
+ * submitMove() queues a move on the worker of the game's shard and reports the outcome
+ * through a callback, so one shard's games are always played by the same thread;
+ * playMove() plays a move on the calling thread instead.
+ *
+ * A game id names a shard, a slot and the slot's generation, so the id of an ended
+ * game is never mistaken for the game that later reuses its slot.
+ *
+ * watch() gives other threads a PositionView of a game, which every move played in the
+ * game is then published to, so spectators and analysis read it without taking the
+ * shard's lock. Games nobody watches have no view.
+ *
+ * With a MoveLog attached, every created game, accepted move and ended game is logged,
+ * and the outcome of a submitted move is only reported once its record is on disk. If
+ * the log fails first, the move is taken back and reported as NOT_DURABLE, and no more
+ * moves are played.
+ * checkpoint() snapshots every game and drops the log segments the snapshot covers;
+ * recover() rebuilds the games from the snapshot and the log, each shard's records
+ * replayed by its own thread.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MemoryReport.hpp"
+#include "MoveGenerator.hpp"
+#include "MoveLog.hpp"
+#include "Position.hpp"
+#include "PositionView.hpp"
+
+class GameManager {
+    public:
+        typedef uint64_t GameId;
+
+        enum class Status : uint8_t { ACTIVE, CHECKMATE, STALEMATE, ENDED };
+
+        // NOT_DURABLE: the attached log failed before the move was on disk
+        enum class MoveResult : uint8_t { ACCEPTED, UNKNOWN_GAME, GAME_OVER, ILLEGAL, NOT_DURABLE };
+
+        /**
+         * The result of submitting a move, with the game as it stands afterwards.
+         */
+        struct MoveOutcome {
+            GameId game = 0;
+            MoveGenerator::MoveWord move = 0;
+            MoveResult result = MoveResult::UNKNOWN_GAME;
+            Status status = Status::ENDED;
+            uint32_t plies = 0;   // The number of moves played in the game
+            Position position{};
+        };
+
+        using Callback = std::function<void(const MoveOutcome&)>;
+
+        // The most shards (and so worker threads) a manager may have
+        static const int MAX_SHARDS = 256;
+
+        /**
+         * What recover() found.
+         */
+        struct RecoveryStats {
+            size_t snapshot_games = 0; // Games read from the snapshot
+            size_t records = 0;        // Log records read after the snapshot
+            size_t replayed = 0;       // Records applied (the others were already in the snapshot)
+            size_t rejected = 0;       // Records that did not fit their game (illegal or out of sequence)
+        };
+
+    private:
+        struct Game {
+            Position position;
+            std::vector<MoveGenerator::MoveWord> history;
+            uint32_t generation = 0; // Bumped every time the slot is reused
+            Status status = Status::ENDED;
+            bool live = false;
+            std::shared_ptr<PositionView> view; // Published to after every move, once watched
+        };
+
+        struct Job {
+            GameId game;
+            MoveGenerator::MoveWord move;
+            Callback callback;
+        };
+
+        struct Shard {
+            std::mutex mutex; // Guards games and free_slots
+            std::vector<Game> games;
+            std::vector<uint32_t> free_slots;
+
+            std::mutex queue_mutex;
+            std::condition_variable wake;
+            std::deque<Job> queue;
+            bool stopping = false;
+            std::thread worker;
+        };
+
+        std::vector<std::unique_ptr<Shard>> shards_;
+        std::atomic<size_t> live_games_;
+        std::atomic<size_t> next_shard_; // The shard the next game starts on
+
+        // Moves queued but not reported yet, over every shard
+        std::atomic<uint64_t> pending_;
+        std::mutex idle_mutex_;
+        std::condition_variable idle_;
+
+        MoveLog* log_;
+        std::atomic<uint64_t> awaiting_log_; // Outcomes waiting for their record to be durable
+        std::string error_;
+
+        /**
+         * @brief Gets the game named by `id` in `shard`, or nullptr if it has ended or never existed
+         * @pre The shard's mutex is held.
+         */
+        Game* find(Shard& shard, const GameId& id) const;
+
+        /**
+         * @brief Plays `move` in the game named by `id`
+         * @param lsn Set to the log sequence number of the move's record, or 0 if it was not logged.
+         * @param before Set to the position the move was played in.
+         */
+        MoveOutcome play(const GameId& id, const MoveGenerator::MoveWord& move, uint64_t& lsn, Position& before);
+
+        /**
+         * @brief Takes back the accepted move of `outcome`, whose record did not reach the log,
+         *        along with the moves played after it in its game
+         * @return The outcome to report instead: NOT_DURABLE, with the game as it now stands.
+         */
+        MoveOutcome takeBack(const MoveOutcome& outcome, const Position& before);
+
+        /**
+         * @brief Counts a queued move as reported, waking waitIdle() after the last one
+         */
+        void finishJob();
+
+        /**
+         * @brief Runs the jobs queued on `shard` until the manager is destroyed
+         */
+        void work(Shard& shard);
+
+    public:
+        /**
+         * @brief Constructs a manager with `shards` shards, each with its own worker thread
+         */
+        explicit GameManager(const int& shards);
+
+        /**
+         * @brief Stops the workers. Moves still queued are dropped without a callback; moves
+         *        waiting for the log are reported first.
+         */
+        ~GameManager();
+
+        GameManager(const GameManager& other) = delete;
+        GameManager& operator=(const GameManager& other) = delete;
+
+        /**
+         * @brief Starts a game from `start`
+         * @return The id of the new game.
+         */
+        GameId createGame(const Position& start = MoveGenerator::startingPosition());
+
+        /**
+         * @brief Ends a game and frees its slot
+         * @return False if there is no such game.
+         */
+        bool endGame(const GameId& id);
+
+        /**
+         * @brief Validates and plays `move` in a game, on the calling thread
+         */
+        MoveOutcome playMove(const GameId& id, const MoveGenerator::MoveWord& move);
+
+        /**
+         * @brief Queues `move` on the worker of the game's shard, which validates and plays it
+         *        and then calls `callback` (from the worker thread, or from the log's flusher
+         *        thread once the move is durable, without any lock held)
+         */
+        void submitMove(const GameId& id, const MoveGenerator::MoveWord& move, const Callback& callback);
+
+        /**
+         * @brief Waits until every queued move has been played and reported
+         */
+        void waitIdle();
+
+        /**
+         * @brief Logs every change to the games from now on to `log`, which must stay open
+         *        until the manager is destroyed
+         */
+        void setLog(MoveLog* log);
+
+        /**
+         * @brief Rebuilds the games of an empty manager from the snapshot and log segments
+         *        in `directory`. The manager must have as many shards as the one that wrote them.
+         * @return False if they can not be read. Otherwise error() says why.
+         */
+        bool recover(const std::string& directory, RecoveryStats& stats);
+
+        /**
+         * @brief Snapshots every game next to the attached log, then deletes the log segments
+         *        the snapshot covers
+         * @return False if there is no log, the log has failed or the snapshot can not be written.
+         *         Otherwise error() says why.
+         */
+        bool checkpoint();
+
+        /**
+         * @brief Gets the reason recover() or checkpoint() failed
+         */
+        const std::string& error() const;
+
+        /**
+         * @brief Copies the state of a game
+         * @return False if there is no such game.
+         */
+        bool getGame(const GameId& id, Position& position, uint32_t& plies, Status& status) const;
+
+        /**
+         * @brief Gets a view of a game that any thread can read without a lock. Every move
+         *        played in the game (and every move taken back) is published to it as soon
+         *        as it is played, before it is durable. Once the game ends, the view keeps
+         *        its last position.
+         * @return nullptr if there is no such game.
+         */
+        std::shared_ptr<const PositionView> watch(const GameId& id);
+
+        /**
+         * @brief Gets the number of games that have not ended
+         */
+        size_t liveGames() const;
+
+        /**
+         * @brief Gets the number of shards
+         */
+        int shardCount() const;
+
+        /**
+         * @brief Adds the memory used by the games to `report`: "games" (the game slots and
+         *        their positions), "game history", "game views" and "game shards"
+         */
+        void reportMemory(MemoryReport& report) const;
+};
@@ -0,0 +1,122 @@
+#include "GameReader.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+/**
+ * @brief Gets the value of the tag `name`, or `fallback` if the game has no such tag
+ */
+std::string GameRecord::tag(const std::string& name, const std::string& fallback) const {
+    for (const auto& pair : tags) {
+        if (pair.first == name) { return pair.second; }
+    }
+    return fallback;
+}
+
+/**
+ * @brief Constructs a reader over `in`
+ */
+GameReader::GameReader(std::istream& in) : in_{in}, games_read_{0} {}
+
+/**
+ * @brief Gets the number of games read so far
+ */
+size_t GameReader::gamesRead() const {
+    return games_read_;
+}
+
+/**
+ * @brief Reads the next line into `line`, taking `pending_line_` first if there is one
+ * @return False at the end of the input.
+ */
+bool GameReader::readLine(std::string& line) {
+    if (!pending_line_.empty()) {
+        line.swap(pending_line_);
+        pending_line_.clear();
+        return true;
+    }
+    if (!std::getline(in_, line)) { return false; }
+    if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+    return true;
+}
+
+/**
+ * @brief Reads the next game.
+ * @param game Set to the game that was read.
+ * @return False once there are no more games.
+ */
+bool GameReader::next(GameRecord& game) {
+    game = GameRecord();
+    game.index = games_read_;
+
+    bool in_movetext = false;
+    int comment_depth = 0;   // Inside {...}
+    int variation_depth = 0; // Inside (...)
+    std::string line;
+
+    while (readLine(line)) {
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos) { continue; }
+
+        // Tag pair: [Name "Value"]. One after movetext starts the next game.
+        if (line[first] == '[' && comment_depth == 0) {
+            if (in_movetext) {
+                pending_line_ = line;
+                break;
+            }
+            size_t name_end = line.find(' ', first);
+            size_t value_start = line.find('"', first);
+            size_t value_end = line.rfind('"');
+            if (name_end == std::string::npos || value_start == std::string::npos || value_end <= value_start) { continue; }
+            game.tags.push_back({line.substr(first + 1, name_end - first - 1), line.substr(value_start + 1, value_end - value_start - 1)});
+            continue;
+        }
+
+        // Movetext
+        in_movetext = true;
+        bool finished = false;
+        size_t i = 0;
+        while (i < line.size() && !finished) {
+            char symbol = line[i];
+            if (comment_depth) {
+                if (symbol == '}') { comment_depth = 0; }
+                i++;
+            } else if (symbol == '{') {
+                comment_depth = 1;
+                i++;
+            } else if (symbol == ';') {
+                break; // Comment to the end of the line
+            } else if (symbol == '(') {
+                variation_depth++;
+                i++;
+            } else if (symbol == ')') {
+                variation_depth = std::max(0, variation_depth - 1);
+                i++;
+            } else if (std::isspace(static_cast<unsigned char>(symbol))) {
+                i++;
+            } else {
+                size_t end = line.find_first_of(" \t{}();", i);
+                std::string token = line.substr(i, end == std::string::npos ? std::string::npos : end - i);
+                i = (end == std::string::npos) ? line.size() : end;
+                if (variation_depth) { continue; }
+
+                if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
+                    game.result = token;
+                    finished = true;
+                    continue;
+                }
+                if (token[0] == '$') { continue; }
+
+                // Strip move numbers ("12." / "12..." / "12.e4")
+                size_t move_start = token.find_first_not_of("0123456789.");
+                if (move_start == std::string::npos) { continue; }
+                game.moves.push_back(token.substr(move_start));
+            }
+        }
+        if (finished) { break; }
+    }
+
+    if (!in_movetext && game.tags.empty()) { return false; }
+    games_read_++;
+    return true;
+}
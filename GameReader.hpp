@@ -0,0 +1,62 @@
+/**
+ * @class GameReader
+ * @brief Streams games out of a PGN file, one at a time.
+ *
+ * Only the game being read is held in memory, so corpora of any size can be processed.
+ * Tag pairs are kept as-is. Movetext is split into move tokens: move numbers, comments
+ * ({...} and ; to end of line), variations ((...)), NAGs ($n) and the result are skipped.
+ * Moves are not validated here, as that needs a board (see Notation::findMove()).
+ */
+
+#pragma once
+
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * A game as read from a PGN file.
+ */
+struct GameRecord {
+    size_t index = 0;                                        // 0-based position of the game in the file
+    std::vector<std::pair<std::string, std::string>> tags;   // Tag pairs, in file order
+    std::vector<std::string> moves;                          // Move tokens, in SAN or coordinate notation
+    std::string result = "*";                                // "1-0", "0-1", "1/2-1/2" or "*"
+
+    /**
+     * @brief Gets the value of the tag `name`, or `fallback` if the game has no such tag
+     */
+    std::string tag(const std::string& name, const std::string& fallback = "") const;
+};
+
+class GameReader {
+    private:
+        std::istream& in_;
+        size_t games_read_;
+        std::string pending_line_; // A tag line that starts the next game, read while finishing the current one
+
+        /**
+         * @brief Reads the next line into `line`, taking `pending_line_` first if there is one
+         * @return False at the end of the input.
+         */
+        bool readLine(std::string& line);
+
+    public:
+        /**
+         * @brief Constructs a reader over `in`
+         */
+        GameReader(std::istream& in);
+
+        /**
+         * @brief Reads the next game.
+         * @param game Set to the game that was read.
+         * @return False once there are no more games.
+         */
+        bool next(GameRecord& game);
+
+        /**
+         * @brief Gets the number of games read so far
+         */
+        size_t gamesRead() const;
+};
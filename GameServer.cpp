@@ -0,0 +1,712 @@
+#include "GameServer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    // Lines longer than this are not commands, and the client is disconnected
+    const size_t MAX_LINE = 4096;
+
+    // Buffers handed to one writev call
+    const int MAX_IOVECS = 64;
+
+    const char* statusName(const GameManager::Status& status) {
+        switch (status) {
+            case GameManager::Status::CHECKMATE: return "checkmate";
+            case GameManager::Status::STALEMATE: return "stalemate";
+            case GameManager::Status::ENDED: return "ended";
+            default: return "active";
+        }
+    }
+
+    const char* rejectionReason(const GameManager::MoveResult& result) {
+        switch (result) {
+            case GameManager::MoveResult::ILLEGAL: return "illegal";
+            case GameManager::MoveResult::GAME_OVER: return "game-over";
+            case GameManager::MoveResult::NOT_DURABLE: return "not-durable";
+            default: return "unknown-game";
+        }
+    }
+}
+
+/**
+ * @brief Constructs a server. Nothing is opened until start().
+ */
+GameServer::GameServer(const Options& options)
+    : options_{options}, manager_{std::make_unique<GameManager>(options.shards)},
+      validator_{std::make_unique<MoveValidator>(options.validators)}, epoll_fd_{-1}, wake_fd_{-1},
+      tcp_fd_{-1}, unix_fd_{-1}, timer_fd_{-1}, running_{false}, clocks_{0}, epoch_{std::chrono::steady_clock::now()},
+      ticking_{false}, next_connection_id_{1} {
+    options_.tick_ms = std::max(1, options_.tick_ms);
+}
+
+/**
+ * @brief Closes every socket (and removes the Unix socket file)
+ */
+GameServer::~GameServer() {
+    manager_.reset();
+    validator_.reset();
+    for (auto& [fd, connection] : connections_) { ::close(fd); }
+    for (int fd : {epoll_fd_, wake_fd_, tcp_fd_, unix_fd_, timer_fd_}) {
+        if (fd >= 0) { ::close(fd); }
+    }
+    if (unix_fd_ >= 0) { ::unlink(options_.unix_path.c_str()); }
+}
+
+/**
+ * @brief Opens a listening socket on the TCP port or Unix path of the options
+ * @return The socket, or -1 (with error_ set).
+ */
+int GameServer::listenOn(const bool& tcp) {
+    int fd = ::socket(tcp ? AF_INET : AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error_ = std::string("socket: ") + std::strerror(errno);
+        return -1;
+    }
+
+    int result;
+    if (tcp) {
+        int reuse = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(options_.port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        result = ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    } else {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (options_.unix_path.size() >= sizeof(address.sun_path)) {
+            error_ = "unix socket path too long: " + options_.unix_path;
+            ::close(fd);
+            return -1;
+        }
+        std::strcpy(address.sun_path, options_.unix_path.c_str());
+        ::unlink(address.sun_path);
+        result = ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    }
+
+    if (result < 0 || ::listen(fd, SOMAXCONN) < 0) {
+        error_ = (tcp ? "port " + std::to_string(options_.port) : options_.unix_path) + ": " + std::strerror(errno);
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Opens the listening sockets and the event loop
+ * @return True on success. Otherwise error() says why.
+ */
+bool GameServer::start() {
+    if (!options_.port && options_.unix_path.empty()) {
+        error_ = "no TCP port or unix socket to listen on";
+        return false;
+    }
+
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    timer_fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wake_fd_ < 0 || timer_fd_ < 0) {
+        error_ = std::string("epoll / eventfd / timerfd: ") + std::strerror(errno);
+        return false;
+    }
+    if (options_.port && (tcp_fd_ = listenOn(true)) < 0) { return false; }
+    if (!options_.unix_path.empty() && (unix_fd_ = listenOn(false)) < 0) { return false; }
+
+    for (int fd : {wake_fd_, timer_fd_, tcp_fd_, unix_fd_}) {
+        if (fd < 0) { continue; }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    running_ = true;
+    return true;
+}
+
+/**
+ * @brief Gets the reason start() failed
+ */
+const std::string& GameServer::error() const {
+    return error_;
+}
+
+/**
+ * @brief Makes run() return. Safe to call from any thread (and from a signal handler).
+ */
+void GameServer::stop() {
+    running_ = false;
+    wake();
+}
+
+/**
+ * @brief Wakes the event loop from another thread
+ */
+void GameServer::wake() {
+    uint64_t one = 1;
+    if (::write(wake_fd_, &one, sizeof(one)) < 0) { /* The loop is already awake */ }
+}
+
+/**
+ * @brief Runs the event loop until stop() is called
+ */
+void GameServer::run() {
+    epoll_event events[64];
+    while (running_) {
+        int count = ::epoll_wait(epoll_fd_, events, 64, -1);
+        if (count < 0 && errno != EINTR) { break; }
+
+        for (int i = 0; i < count; i++) {
+            const int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                uint64_t value;
+                if (::read(wake_fd_, &value, sizeof(value)) < 0) { /* Already drained */ }
+                deliverCompletions();
+                continue;
+            }
+            if (fd == timer_fd_) {
+                uint64_t expirations;
+                if (::read(timer_fd_, &expirations, sizeof(expirations)) < 0) { /* Already drained */ }
+                tick();
+                continue;
+            }
+            if (fd == tcp_fd_ || fd == unix_fd_) {
+                acceptClients(fd);
+                continue;
+            }
+
+            auto found = connections_.find(fd);
+            if (found == connections_.end()) { continue; }
+            if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !readFrom(found->second)) { continue; }
+            if (events[i].events & EPOLLOUT) { flush(found->second); }
+        }
+    }
+}
+
+/**
+ * @brief Accepts every pending client of `listen_fd`
+ */
+void GameServer::acceptClients(const int& listen_fd) {
+    while (true) {
+        int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) { return; }
+
+        if (listen_fd == tcp_fd_) {
+            // Replies are small and latency matters more than packet count
+            int no_delay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        }
+
+        Connection& connection = connections_[fd];
+        connection.fd = fd;
+        connection.id = next_connection_id_++;
+        connection_fds_[connection.id] = fd;
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+/**
+ * @brief Reads what `connection` sent and runs its complete lines
+ * @return False if the connection was closed.
+ */
+bool GameServer::readFrom(Connection& connection) {
+    char buffer[4096];
+    while (true) {
+        ssize_t received = ::read(connection.fd, buffer, sizeof(buffer));
+        if (received > 0) {
+            connection.input.append(buffer, received);
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) { break; }
+        if (received < 0 && errno == EINTR) { continue; }
+
+        close(connection);
+        return false;
+    }
+
+    size_t start = 0;
+    size_t end;
+    while ((end = connection.input.find('\n', start)) != std::string::npos) {
+        std::string line = connection.input.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+        start = end + 1;
+
+        if (!execute(connection, line)) {
+            close(connection);
+            return false;
+        }
+    }
+    connection.input.erase(0, start);
+
+    if (connection.input.size() > MAX_LINE) {
+        close(connection);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Runs one command of `connection`
+ * @return False if the connection asked to quit.
+ */
+bool GameServer::execute(Connection& connection, const std::string& line) {
+    if (connection.batch_expected) {
+        connection.batch.push_back(line);
+        if (--connection.batch_expected == 0) { submitBatch(connection); }
+        return true;
+    }
+
+    std::istringstream args(line);
+    std::string command;
+    if (!(args >> command)) { return true; }
+
+    if (command == "quit") { return false; }
+
+    if (command == "validate") {
+        size_t count = 0;
+        if (!(args >> count) || count > MAX_BATCH) {
+            send(connection.id, "error expected a batch of 0 to " + std::to_string(MAX_BATCH) + " requests");
+            return true;
+        }
+        connection.batch_expected = count;
+        if (count == 0) { submitBatch(connection); }
+        return true;
+    }
+
+    if (command == "new") {
+        int64_t clock_ms = 0;
+        int64_t increment_ms = 0;
+        if (args >> clock_ms) { args >> increment_ms; }
+        if (clock_ms < 0 || increment_ms < 0) {
+            send(connection.id, "error expected a positive time");
+            return true;
+        }
+
+        GameManager::GameId id = manager_->createGame();
+        HostedGame& game = games_[id];
+        game.players[0] = connection.id;
+        if (clock_ms > 0) {
+            game.timed = true;
+            game.clock_ms[0] = game.clock_ms[1] = clock_ms;
+            game.increment_ms = increment_ms;
+        }
+        connection.games.push_back(id);
+        send(connection.id, "game " + std::to_string(id) + " w");
+        return true;
+    }
+
+    GameManager::GameId id;
+    if (!(args >> id)) {
+        send(connection.id, "error expected a game id");
+        return true;
+    }
+    auto found = games_.find(id);
+    if (found == games_.end()) {
+        send(connection.id, "error no game " + std::to_string(id));
+        return true;
+    }
+    HostedGame& game = found->second;
+    const bool is_player_one = game.players[0] == connection.id;
+    const bool is_player = is_player_one || game.players[1] == connection.id;
+
+    if (command == "watch") {
+        if (std::find(game.spectators.begin(), game.spectators.end(), connection.id) == game.spectators.end()) {
+            game.spectators.push_back(connection.id);
+            connection.watched.push_back(id);
+        }
+        Position position;
+        uint32_t plies = 0;
+        GameManager::Status status;
+        manager_->getGame(id, position, plies, status);
+        send(connection.id, "watching " + std::to_string(id) + " " + std::to_string(plies) + " " + MoveGenerator::toFEN(position));
+    } else if (command == "unwatch") {
+        unwatch(connection, id);
+        send(connection.id, "unwatched " + std::to_string(id));
+    } else if (command == "join") {
+        if (game.players[1] || is_player) {
+            send(connection.id, "error game " + std::to_string(id) + " is not open");
+            return true;
+        }
+        game.players[1] = connection.id;
+        connection.games.push_back(id);
+        send(connection.id, "game " + std::to_string(id) + " b");
+        send(game.players[0], "start " + std::to_string(id) + clockText(game));
+        send(game.players[1], "start " + std::to_string(id) + clockText(game));
+        if (game.timed) { startClock(id, game); }
+    } else if (command == "move") {
+        std::string uci;
+        args >> uci;
+        const std::string prefix = "rejected " + std::to_string(id) + " " + uci + " ";
+        MoveGenerator::MoveWord move;
+        if (!is_player) { send(connection.id, prefix + "not-a-player"); }
+        else if (!game.players[1]) { send(connection.id, prefix + "no-opponent"); }
+        else if (is_player_one != game.player_one_turn) { send(connection.id, prefix + "not-your-turn"); }
+        else if (game.in_flight) { send(connection.id, prefix + "busy"); }
+        else if (!MoveGenerator::parseUCI(uci, move)) { send(connection.id, prefix + "bad-notation"); }
+        else if (game.timed && !stopClock(game)) { finish(id, std::string("time ") + (is_player_one ? "w" : "b")); }
+        else {
+            game.in_flight = true;
+            const uint64_t mover = connection.id;
+            manager_->submitMove(id, move, [this, mover](const GameManager::MoveOutcome& outcome) {
+                {
+                    std::lock_guard<std::mutex> guard(completions_mutex_);
+                    completions_.push_back({mover, outcome});
+                }
+                wake();
+            });
+        }
+    } else if (command == "resign") {
+        if (is_player) { resign(id, is_player_one); }
+        else { send(connection.id, "error not a player of game " + std::to_string(id)); }
+    } else {
+        send(connection.id, "error unknown command " + command);
+    }
+    return true;
+}
+
+/**
+ * @brief Queues `line` for the connection with id `connection` (if it is still open)
+ */
+void GameServer::send(const uint64_t& connection, const std::string& line) {
+    if (!connection_fds_.count(connection)) { return; }
+    send(connection, std::make_shared<const std::string>(line + '\n'));
+}
+
+/**
+ * @brief Queues the encoded `message` for the connection with id `connection` (if it is still open)
+ */
+void GameServer::send(const uint64_t& connection, const Buffer& message) {
+    auto fd = connection_fds_.find(connection);
+    if (fd == connection_fds_.end()) { return; }
+
+    Connection& target = connections_[fd->second];
+    target.output.push_back(message);
+    target.output_bytes += message->size();
+    flush(target);
+}
+
+/**
+ * @brief Queues the encoded `message` for every spectator of `game`, unsubscribing those
+ *        more than MAX_OUTPUT bytes behind
+ */
+void GameServer::sendToSpectators(const GameManager::GameId& id, HostedGame& game, const Buffer& message) {
+    std::vector<uint64_t> too_slow;
+    for (const uint64_t& spectator : game.spectators) {
+        send(spectator, message);
+
+        auto fd = connection_fds_.find(spectator);
+        if (fd != connection_fds_.end() && connections_[fd->second].output_bytes > MAX_OUTPUT) { too_slow.push_back(spectator); }
+    }
+    for (const uint64_t& spectator : too_slow) {
+        Connection& connection = connections_[connection_fds_[spectator]];
+        unwatch(connection, id);
+        send(spectator, "unwatched " + std::to_string(id) + " too-slow");
+    }
+}
+
+/**
+ * @brief Stops sending the updates of game `id` to `connection`
+ */
+void GameServer::unwatch(Connection& connection, const GameManager::GameId& id) {
+    connection.watched.erase(std::remove(connection.watched.begin(), connection.watched.end(), id), connection.watched.end());
+
+    auto found = games_.find(id);
+    if (found == games_.end()) { return; }
+    std::vector<uint64_t>& spectators = found->second.spectators;
+    spectators.erase(std::remove(spectators.begin(), spectators.end(), connection.id), spectators.end());
+}
+
+/**
+ * @brief Writes as much of the output of `connection` as the socket takes, and
+ *        watches for writability while some is left
+ */
+void GameServer::flush(Connection& connection) {
+    while (!connection.output.empty()) {
+        iovec vectors[MAX_IOVECS];
+        int count = 0;
+        for (auto buffer = connection.output.begin(); buffer != connection.output.end() && count < MAX_IOVECS; ++buffer, ++count) {
+            const size_t skip = (count == 0) ? connection.output_offset : 0;
+            vectors[count].iov_base = const_cast<char*>((*buffer)->data() + skip);
+            vectors[count].iov_len = (*buffer)->size() - skip;
+        }
+
+        // sendmsg is writev with flags: MSG_NOSIGNAL makes a closed peer an error rather than SIGPIPE
+        msghdr header{};
+        header.msg_iov = vectors;
+        header.msg_iovlen = count;
+        ssize_t sent = ::sendmsg(connection.fd, &header, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) { continue; }
+        if (sent <= 0) { break; } // EAGAIN, or an error that the next read will report
+
+        // Drop the buffers written in full; the last one may be written in part
+        connection.output_bytes -= sent;
+        size_t remaining = sent;
+        while (remaining) {
+            const size_t left = connection.output.front()->size() - connection.output_offset;
+            if (remaining < left) {
+                connection.output_offset += remaining;
+                break;
+            }
+            remaining -= left;
+            connection.output.pop_front();
+            connection.output_offset = 0;
+        }
+    }
+
+    const bool pending = !connection.output.empty();
+    if (pending != connection.watching_output) {
+        epoll_event event{};
+        event.events = pending ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        event.data.fd = connection.fd;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.watching_output = pending;
+    }
+}
+
+/**
+ * @brief Ends a game, telling both players who resigned
+ */
+void GameServer::resign(const GameManager::GameId& id, const bool& player_one) {
+    auto found = games_.find(id);
+    if (found == games_.end()) { return; }
+
+    finish(id, std::string("resigned ") + (player_one ? "w" : "b"));
+}
+
+/**
+ * @brief Ends a game, sending "ended <id> <reason>" to its players and spectators
+ */
+void GameServer::finish(const GameManager::GameId& id, const std::string& reason) {
+    auto found = games_.find(id);
+    if (found == games_.end()) { return; }
+
+    HostedGame& game = found->second;
+    const Buffer message = std::make_shared<const std::string>("ended " + std::to_string(id) + " " + reason + "\n");
+    for (const uint64_t& player : game.players) { send(player, message); }
+    sendToSpectators(id, game, message);
+    closeGame(id);
+}
+
+/**
+ * @brief Starts the clock of the player to move in a timed game
+ */
+void GameServer::startClock(const GameManager::GameId& id, HostedGame& game) {
+    game.turn_started = std::chrono::steady_clock::now();
+    const int64_t left = game.clock_ms[game.player_one_turn ? 0 : 1];
+    const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(game.turn_started - epoch_).count();
+
+    // The flag falls on the first tick at or after the time runs out
+    const uint64_t deadline = static_cast<uint64_t>((now + std::max<int64_t>(left, 0) + options_.tick_ms - 1) / options_.tick_ms);
+    game.flag = clocks_.arm(deadline, id);
+    updateTicking();
+}
+
+/**
+ * @brief Stops the running clock of a timed game, charging the time spent to its player
+ * @return False if that player has run out of time.
+ */
+bool GameServer::stopClock(HostedGame& game) {
+    clocks_.cancel(game.flag);
+    game.flag = TimerWheel::NONE;
+
+    int64_t& left = game.clock_ms[game.player_one_turn ? 0 : 1];
+    left -= std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - game.turn_started).count();
+    return left > 0;
+}
+
+/**
+ * @brief Formats the clocks of a timed game as " <Player One ms> <Player Two ms>", or "" if untimed
+ */
+std::string GameServer::clockText(const HostedGame& game) const {
+    if (!game.timed) { return ""; }
+    return " " + std::to_string(game.clock_ms[0]) + " " + std::to_string(game.clock_ms[1]);
+}
+
+/**
+ * @brief Advances the clocks to the current tick and ends the games whose time ran out
+ */
+void GameServer::tick() {
+    const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - epoch_).count();
+    std::vector<uint64_t> expired;
+    clocks_.advance(static_cast<uint64_t>(now / options_.tick_ms), expired);
+
+    for (const uint64_t& id : expired) {
+        auto found = games_.find(id);
+        if (found == games_.end()) { continue; }
+        found->second.flag = TimerWheel::NONE;
+        found->second.clock_ms[found->second.player_one_turn ? 0 : 1] = 0;
+        finish(id, std::string("time ") + (found->second.player_one_turn ? "w" : "b"));
+    }
+    updateTicking();
+}
+
+/**
+ * @brief Arms timer_fd_ while some clock runs, and disarms it otherwise
+ */
+void GameServer::updateTicking() {
+    const bool needed = clocks_.size() > 0;
+    if (needed == ticking_) { return; }
+
+    itimerspec period{};
+    if (needed) {
+        period.it_interval.tv_sec = options_.tick_ms / 1000;
+        period.it_interval.tv_nsec = (options_.tick_ms % 1000) * 1000000L;
+        period.it_value = period.it_interval;
+    }
+    ::timerfd_settime(timer_fd_, 0, &period, nullptr);
+    ticking_ = needed;
+}
+
+/**
+ * @brief Forgets a game that has ended, for its players and spectators, and frees it
+ */
+void GameServer::closeGame(const GameManager::GameId& id) {
+    auto found = games_.find(id);
+    if (found == games_.end()) { return; }
+
+    for (const uint64_t& player : found->second.players) {
+        auto fd = connection_fds_.find(player);
+        if (fd == connection_fds_.end()) { continue; }
+        std::vector<GameManager::GameId>& games = connections_[fd->second].games;
+        games.erase(std::remove(games.begin(), games.end(), id), games.end());
+    }
+    for (const uint64_t& spectator : found->second.spectators) {
+        auto fd = connection_fds_.find(spectator);
+        if (fd == connection_fds_.end()) { continue; }
+        std::vector<GameManager::GameId>& watched = connections_[fd->second].watched;
+        watched.erase(std::remove(watched.begin(), watched.end(), id), watched.end());
+    }
+    clocks_.cancel(found->second.flag);
+    manager_->endGame(id);
+    games_.erase(found);
+}
+
+/**
+ * @brief Closes a connection, resigning the games it was playing
+ */
+void GameServer::close(Connection& connection) {
+    const int fd = connection.fd;
+    const uint64_t id = connection.id;
+    while (!connection.watched.empty()) { unwatch(connection, connection.watched.back()); }
+    const std::vector<GameManager::GameId> games = connection.games;
+    for (const GameManager::GameId& game : games) {
+        auto found = games_.find(game);
+        if (found != games_.end()) { resign(game, found->second.players[0] == id); }
+    }
+
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connection_fds_.erase(id);
+    connections_.erase(fd);
+}
+
+/**
+ * @brief Hands the batch `connection` has finished reading to the validator
+ */
+void GameServer::submitBatch(Connection& connection) {
+    const uint64_t client = connection.id;
+    const uint64_t batch = connection.batches_submitted++;
+    validator_->submitLines(std::move(connection.batch), [this, client, batch](std::vector<std::string>& replies) {
+        std::string text = "validated " + std::to_string(replies.size());
+        for (const std::string& reply : replies) {
+            text += '\n';
+            text += reply;
+        }
+        {
+            std::lock_guard<std::mutex> guard(completions_mutex_);
+            answers_.push_back({client, batch, std::move(text)});
+        }
+        wake();
+    });
+    connection.batch.clear();
+}
+
+/**
+ * @brief Pushes the move outcomes queued by the shard workers to the players, and the
+ *        batch answers queued by the validator workers to their clients
+ */
+void GameServer::deliverCompletions() {
+    std::vector<Completion> completions;
+    std::vector<Answer> answers;
+    {
+        std::lock_guard<std::mutex> guard(completions_mutex_);
+        completions.swap(completions_);
+        answers.swap(answers_);
+    }
+
+    for (Answer& answer : answers) {
+        auto fd = connection_fds_.find(answer.connection);
+        if (fd == connection_fds_.end()) { continue; }
+
+        // Batches are answered in the order they were sent, whichever finished first
+        Connection& connection = connections_[fd->second];
+        connection.answers[answer.batch] = std::move(answer.text);
+        for (auto next = connection.answers.begin(); next != connection.answers.end() && next->first == connection.batches_answered;
+             next = connection.answers.erase(next)) {
+            send(connection.id, next->second);
+            connection.batches_answered++;
+        }
+    }
+
+    for (const Completion& completion : completions) {
+        const GameManager::MoveOutcome& outcome = completion.outcome;
+        auto found = games_.find(outcome.game);
+        if (found == games_.end()) { continue; } // Resigned while the move was being played
+
+        HostedGame& game = found->second;
+        game.in_flight = false;
+        const std::string uci = MoveGenerator::toUCI(outcome.move);
+        if (outcome.result != GameManager::MoveResult::ACCEPTED) {
+            send(completion.connection, "rejected " + std::to_string(outcome.game) + " " + uci + " " + rejectionReason(outcome.result));
+            if (game.timed) { startClock(outcome.game, game); }
+            continue;
+        }
+
+        if (game.timed) { game.clock_ms[game.player_one_turn ? 0 : 1] += game.increment_ms; }
+        game.player_one_turn = outcome.position.player_one_turn;
+        const Buffer moved = std::make_shared<const std::string>("moved " + std::to_string(outcome.game) + " " + std::to_string(outcome.plies)
+            + " " + uci + " " + statusName(outcome.status) + " " + MoveGenerator::toFEN(outcome.position) + clockText(game) + "\n");
+        send(game.players[0], moved);
+        send(game.players[1], moved);
+
+        if (!game.spectators.empty()) {
+            const int64_t clock = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - game.started).count();
+            char delta[96];
+            std::snprintf(delta, sizeof(delta), "delta %" PRIu64 " %" PRIu32 " %u %" PRId64 " %016" PRIx64 "\n",
+                          outcome.game, outcome.plies, static_cast<unsigned>(outcome.move), clock, outcome.position.hash);
+            sendToSpectators(outcome.game, game, std::make_shared<const std::string>(delta));
+        }
+
+        if (outcome.status != GameManager::Status::ACTIVE) {
+            if (!game.spectators.empty()) {
+                sendToSpectators(outcome.game, game, std::make_shared<const std::string>(
+                    "ended " + std::to_string(outcome.game) + " " + statusName(outcome.status) + "\n"));
+            }
+            closeGame(outcome.game);
+        } else if (game.timed) {
+            startClock(outcome.game, game);
+        }
+    }
+}
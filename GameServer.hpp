@@ -0,0 +1,297 @@
+/**
+ * @class GameServer
+ * @brief Serves games to clients over TCP and / or a Unix socket.
+ *
+ * One thread runs an epoll event loop that owns every socket and every piece of
+ * connection state: it accepts clients, reads their commands and writes (buffered,
+ * non-blocking) replies. Output is queued as reference-counted immutable buffers and
+ * written with writev, so an update is encoded once and shared by the output queues of
+ * every player and spectator of the game; a spectator who falls more than MAX_OUTPUT
+ * bytes behind stops receiving updates.
+ *
+ * The clocks of timed games are TimerWheel timers, one per game for the player to move,
+ * re-armed on every move: the loop advances the wheel on every tick of a timerfd and
+ * ends the games whose timer expired. A clock stops when the move reaches the server.
+ * Moves are validated and played by a GameManager, whose shard workers form the thread
+ * pool; their outcomes come back to the loop through a queue and an eventfd, and the
+ * loop pushes them to both players.
+ *
+ * The protocol is one command per line:
+ *   new [<ms> [<inc>]]   -> "game <id> w"           (the creator plays Player One). With a time,
+ *                           each player has <ms> milliseconds for the game plus <inc> per move.
+ *   join <id>            -> "game <id> b", then "start <id>" to both players (followed by both
+ *                           clocks in milliseconds in a timed game)
+ *   move <id> <uci>      -> "moved <id> <plies> <uci> <active|checkmate|stalemate> <fen>" to both
+ *                           players (followed by both clocks in a timed game), or
+ *                           "rejected <id> <uci> <reason>" to the mover
+ *   resign <id>          -> "ended <id> resigned <w|b>" to both players and the spectators
+ *                           (as is "ended <id> time <w|b>" when a player runs out of time)
+ *   watch <id>           -> "watching <id> <plies> <fen>", then for every move a delta
+ *                           "delta <id> <ply> <move word> <clock> <hash>" (the packed
+ *                           MoveGenerator::MoveWord, the milliseconds since the game started and
+ *                           the hash in hexadecimal after the move), and "ended <id> <reason>"
+ *                           when the game ends. Deltas up to the snapshot's ply may still arrive
+ *                           and are to be skipped.
+ *   unwatch <id>         -> "unwatched <id>"
+ *   validate <n>         -> takes the next n lines as "<fen> <uci>" requests, validated in
+ *                           parallel by a MoveValidator, and answers "validated <n>" followed by
+ *                           one reply line per request (see MoveValidator.hpp). The answers of
+ *                           several batches come back in the order of the batches.
+ *   quit                 -> closes the connection (as does disconnecting, which resigns its games)
+ * Anything else is answered with "error <reason>".
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "GameManager.hpp"
+#include "MoveValidator.hpp"
+#include "TimerWheel.hpp"
+
+class GameServer {
+    public:
+        struct Options {
+            int port = 0;            // TCP port on 127.0.0.1, 0 for none
+            std::string unix_path;   // Unix socket path, empty for none
+            int shards = 1;          // GameManager shards (worker threads)
+            int validators = 1;      // MoveValidator worker threads
+            int tick_ms = 10;        // Resolution of the game clocks
+        };
+
+        // The most requests a validate batch may hold
+        static const size_t MAX_BATCH = 65536;
+
+        // The most output a spectator may leave unread before it is unsubscribed
+        static const size_t MAX_OUTPUT = 1 << 20;
+
+    private:
+        // An encoded message, shared read-only by the output queues it was sent to
+        typedef std::shared_ptr<const std::string> Buffer;
+
+        struct Connection {
+            int fd = -1;
+            uint64_t id = 0;
+            std::string input;
+            std::deque<Buffer> output;    // Not yet written, waiting for the socket to drain
+            size_t output_offset = 0;     // Bytes of output.front() already written
+            size_t output_bytes = 0;      // Bytes of output not written yet
+            bool watching_output = false; // Whether epoll reports when the socket can take more
+            std::vector<GameManager::GameId> games;
+            std::vector<GameManager::GameId> watched;
+
+            size_t batch_expected = 0;            // Lines still to read into batch
+            std::vector<std::string> batch;
+            uint64_t batches_submitted = 0;
+            uint64_t batches_answered = 0;
+            std::map<uint64_t, std::string> answers; // Batch answers that came back before an earlier batch's
+        };
+
+        struct HostedGame {
+            uint64_t players[2] = {0, 0}; // Connection ids of Player One and Player Two (0 while waiting)
+            bool player_one_turn = true;
+            bool in_flight = false;       // A move was submitted and its outcome has not come back yet
+            std::vector<uint64_t> spectators; // Connection ids
+            std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+            bool timed = false;
+            int64_t clock_ms[2] = {0, 0};     // Time left to Player One and Player Two
+            int64_t increment_ms = 0;
+            std::chrono::steady_clock::time_point turn_started; // While a clock runs
+            TimerWheel::TimerId flag = TimerWheel::NONE;         // Fires when the running clock runs out
+        };
+
+        // A move outcome on its way from a shard worker back to the loop
+        struct Completion {
+            uint64_t connection;
+            GameManager::MoveOutcome outcome;
+        };
+
+        // The answer of a validate batch on its way from a validator worker back to the loop
+        struct Answer {
+            uint64_t connection;
+            uint64_t batch;
+            std::string text;
+        };
+
+        Options options_;
+        std::unique_ptr<GameManager> manager_; // Destroyed first, so no worker outlives the loop's state
+        std::unique_ptr<MoveValidator> validator_; // Likewise
+        std::string error_;
+
+        int epoll_fd_;
+        int wake_fd_;
+        int tcp_fd_;
+        int unix_fd_;
+        int timer_fd_;
+        std::atomic<bool> running_;
+
+        TimerWheel clocks_;
+        std::chrono::steady_clock::time_point epoch_; // Tick 0 of clocks_
+        bool ticking_;                                // Whether timer_fd_ is armed
+
+        std::unordered_map<int, Connection> connections_;    // By file descriptor
+        std::unordered_map<uint64_t, int> connection_fds_;   // File descriptors by connection id
+        uint64_t next_connection_id_;
+        std::unordered_map<GameManager::GameId, HostedGame> games_;
+
+        std::mutex completions_mutex_; // Guards completions_ and answers_
+        std::vector<Completion> completions_;
+        std::vector<Answer> answers_;
+
+        /**
+         * @brief Accepts every pending client of `listen_fd`
+         */
+        void acceptClients(const int& listen_fd);
+
+        /**
+         * @brief Reads what `connection` sent and runs its complete lines
+         * @return False if the connection was closed.
+         */
+        bool readFrom(Connection& connection);
+
+        /**
+         * @brief Runs one command of `connection`
+         * @return False if the connection asked to quit.
+         */
+        bool execute(Connection& connection, const std::string& line);
+
+        /**
+         * @brief Queues `line` for the connection with id `connection` (if it is still open)
+         */
+        void send(const uint64_t& connection, const std::string& line);
+
+        /**
+         * @brief Queues the encoded `message` for the connection with id `connection` (if it is still open)
+         */
+        void send(const uint64_t& connection, const Buffer& message);
+
+        /**
+         * @brief Queues the encoded `message` for every spectator of `game`, unsubscribing those
+         *        more than MAX_OUTPUT bytes behind
+         */
+        void sendToSpectators(const GameManager::GameId& id, HostedGame& game, const Buffer& message);
+
+        /**
+         * @brief Stops sending the updates of game `id` to `connection`
+         */
+        void unwatch(Connection& connection, const GameManager::GameId& id);
+
+        /**
+         * @brief Forgets a game that has ended, for its players and spectators, and frees it
+         */
+        void closeGame(const GameManager::GameId& id);
+
+        /**
+         * @brief Writes as much of the output of `connection` as the socket takes, and
+         *        watches for writability while some is left
+         */
+        void flush(Connection& connection);
+
+        /**
+         * @brief Closes a connection, resigning the games it was playing
+         */
+        void close(Connection& connection);
+
+        /**
+         * @brief Ends a game, telling both players who resigned
+         */
+        void resign(const GameManager::GameId& id, const bool& player_one);
+
+        /**
+         * @brief Ends a game, sending "ended <id> <reason>" to its players and spectators
+         */
+        void finish(const GameManager::GameId& id, const std::string& reason);
+
+        /**
+         * @brief Pushes the move outcomes queued by the shard workers to the players, and the
+         *        batch answers queued by the validator workers to their clients
+         */
+        void deliverCompletions();
+
+        /**
+         * @brief Hands the batch `connection` has finished reading to the validator
+         */
+        void submitBatch(Connection& connection);
+
+        /**
+         * @brief Wakes the event loop from another thread
+         */
+        void wake();
+
+        /**
+         * @brief Starts the clock of the player to move in a timed game
+         */
+        void startClock(const GameManager::GameId& id, HostedGame& game);
+
+        /**
+         * @brief Stops the running clock of a timed game, charging the time spent to its player
+         * @return False if that player has run out of time.
+         */
+        bool stopClock(HostedGame& game);
+
+        /**
+         * @brief Formats the clocks of a timed game as " <Player One ms> <Player Two ms>", or "" if untimed
+         */
+        std::string clockText(const HostedGame& game) const;
+
+        /**
+         * @brief Advances the clocks to the current tick and ends the games whose time ran out
+         */
+        void tick();
+
+        /**
+         * @brief Arms timer_fd_ while some clock runs, and disarms it otherwise
+         */
+        void updateTicking();
+
+        /**
+         * @brief Opens a listening socket on the TCP port or Unix path of the options
+         * @return The socket, or -1 (with error_ set).
+         */
+        int listenOn(const bool& tcp);
+
+    public:
+        /**
+         * @brief Constructs a server. Nothing is opened until start().
+         */
+        explicit GameServer(const Options& options);
+
+        /**
+         * @brief Closes every socket (and removes the Unix socket file)
+         */
+        ~GameServer();
+
+        GameServer(const GameServer& other) = delete;
+        GameServer& operator=(const GameServer& other) = delete;
+
+        /**
+         * @brief Opens the listening sockets and the event loop
+         * @return True on success. Otherwise error() says why.
+         */
+        bool start();
+
+        /**
+         * @brief Gets the reason start() failed
+         */
+        const std::string& error() const;
+
+        /**
+         * @brief Runs the event loop until stop() is called
+         */
+        void run();
+
+        /**
+         * @brief Makes run() return. Safe to call from any thread (and from a signal handler).
+         */
+        void stop();
+};
@@ -0,0 +1,303 @@
+#include "MatchRunner.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "Notation.hpp"
+
+namespace {
+    /*
+    Determines whether neither player has enough material left to mate: bare Kings,
+    or a single Knight or Bishop against a bare King.
+    */
+    bool insufficientMaterial(const ChessBoard& board) {
+        int minors = 0;
+        for (int row = 0; row < 8; row++) {
+            for (int col = 0; col < 8; col++) {
+                const ChessPiece* piece = board.getCell(row, col);
+                if (!piece) { continue; }
+
+                int kind = board.pieceKind(piece) % 6;
+                if (kind == 1 || kind == 2) { minors++; }
+                else if (kind != 5) { return false; }
+            }
+        }
+        return minors <= 1;
+    }
+}
+
+/**
+ * @brief Reads a configuration of comma-separated "key=value" settings,
+ *        eg. "name=base,nodes=20000,depth=10,movetime=0,hash=4"
+ * @return True if every setting was understood. `config` is updated accordingly.
+ */
+bool EngineConfig::parse(const std::string& spec, EngineConfig& config) {
+    std::istringstream settings(spec);
+    std::string setting;
+    try {
+        while (std::getline(settings, setting, ',')) {
+            size_t equals = setting.find('=');
+            if (equals == std::string::npos) { return false; }
+
+            std::string key = setting.substr(0, equals);
+            std::string value = setting.substr(equals + 1);
+            if (key == "name") { config.name = value; }
+            else if (key == "nodes") { config.nodes = std::stoull(value); }
+            else if (key == "depth") { config.depth = std::stoi(value); }
+            else if (key == "movetime") { config.movetime = std::stoll(value); }
+            else if (key == "hash") { config.table_megabytes = std::stoull(value); }
+            else { return false; }
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the number of games played
+ */
+int MatchResult::games() const {
+    return wins + draws + losses;
+}
+
+/**
+ * @brief Constructs a match of engine `a` against engine `b`
+ */
+MatchRunner::MatchRunner(const EngineConfig& a, const EngineConfig& b, const MatchOptions& options)
+    : engines_{a, b}, options_{options}, next_game_{0}, stop_{false} {}
+
+/**
+ * @brief Converts an expected score (0 to 1) to an Elo difference, and back
+ */
+double MatchRunner::scoreToElo(const double& score) {
+    double clamped = std::clamp(score, 1e-6, 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / clamped - 1.0);
+}
+
+double MatchRunner::eloToScore(const double& elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+/**
+ * @brief Reads the openings to play from an EPD file (one position per line)
+ *        or a PGN file (the first `opening_plies` plies of every game)
+ * @return The number of openings read.
+ */
+size_t MatchRunner::loadOpenings(std::istream& in) {
+    std::stringstream contents;
+    contents << in.rdbuf();
+    std::string text = contents.str();
+
+    ChessBoard board;
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first != std::string::npos && text[first] == '[') {
+        std::istringstream pgn(text);
+        GameReader reader(pgn);
+        GameRecord game;
+        while (reader.next(game)) {
+            if (!board.loadFEN(game.tag("FEN", ChessBoard::STARTING_FEN))) { continue; }
+
+            // Openings stop early at an unreadable move, but are kept
+            for (int ply = 0; ply < options_.opening_plies && ply < static_cast<int>(game.moves.size()); ply++) {
+                std::vector<Move> legal = board.generateMoves();
+                int index = Notation::findMove(board, legal, game.moves[ply]);
+                if (index < 0) { break; }
+                board.makeMove(legal[index]);
+            }
+            openings_.push_back(board.toFEN());
+        }
+    } else {
+        // EPD lines start with the FEN fields, and any operations after them are ignored by loadFEN()
+        std::istringstream epd(text);
+        std::string line;
+        while (std::getline(epd, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#') { continue; }
+            if (board.loadFEN(line)) { openings_.push_back(board.toFEN()); }
+        }
+    }
+
+    return openings_.size();
+}
+
+/**
+ * @brief Plays one game from `fen`
+ * @param a_first True if engine A plays Player One (who moves first)
+ * @param reason Set to how the game ended
+ * @return The score of engine A: 1 for a win, 0.5 for a draw, 0 for a loss.
+ */
+double MatchRunner::playGame(const std::string& fen, const bool& a_first, EngineContext& a, EngineContext& b, std::string& reason) {
+    ChessBoard board;
+    board.loadFEN(fen);
+    a.table.clear();
+    b.table.clear();
+
+    // Scores of Player One: +1 if Player One wins, 0 for a draw, -1 if Player One loses
+    int outcome = 0;
+    std::unordered_map<uint64_t, int> seen{{board.getHash(), 1}};
+    int quiet_plies = 0;   // Plies since the last capture or Pawn move
+    int resign_plies = 0;  // Plies in a row with the same side winning (positive for Player One)
+    int draw_plies = 0;    // Plies in a row with an equal score
+
+    reason = "max plies";
+    for (int ply = 0; ply < options_.max_plies; ply++) {
+        const bool p1 = board.isPlayerOneTurn();
+        std::vector<Move> legal = board.generateMoves();
+        if (legal.empty()) {
+            outcome = board.isInCheck() ? (p1 ? -1 : 1) : 0;
+            reason = board.isInCheck() ? "checkmate" : "stalemate";
+            break;
+        }
+        if (insufficientMaterial(board)) {
+            reason = "insufficient material";
+            break;
+        }
+
+        const bool a_to_move = (p1 == a_first);
+        const EngineConfig& config = engines_[a_to_move ? 0 : 1];
+        EngineContext& engine = a_to_move ? a : b;
+
+        SearchLimits limits;
+        limits.nodes = config.nodes;
+        limits.depth = config.depth;
+        limits.movetime = config.movetime;
+        std::vector<PVLine> lines = engine.search.run(board, limits);
+        const Move move = lines[0].moves[0];
+        const int score = lines[0].score;
+        const int p1_score = p1 ? score : -score;
+
+        // Only the score of a completed iteration is a verdict: a search stopped within its
+        // first has not looked at every move. Otherwise the adjudication counts are left as they were.
+        if (lines[0].depth >= 1) {
+            // A mate the search has proven needs no playing out
+            if (Search::isMateScore(score)) {
+                outcome = (p1_score > 0) ? 1 : -1;
+                reason = "adjudicated: forced mate";
+                break;
+            }
+
+            if (p1_score >= RESIGN_SCORE) { resign_plies = std::max(resign_plies, 0) + 1; }
+            else if (p1_score <= -RESIGN_SCORE) { resign_plies = std::min(resign_plies, 0) - 1; }
+            else { resign_plies = 0; }
+            if (std::abs(resign_plies) >= RESIGN_PLIES) {
+                outcome = (resign_plies > 0) ? 1 : -1;
+                reason = "adjudicated: score";
+                break;
+            }
+
+            draw_plies = (ply >= DRAW_AFTER && std::abs(score) <= DRAW_SCORE) ? draw_plies + 1 : 0;
+            if (draw_plies >= DRAW_PLIES) {
+                reason = "adjudicated: draw";
+                break;
+            }
+        }
+
+        bool irreversible = move.getCapturedPiece() || board.pieceKind(move.getMovedPiece()) % 6 == 0;
+        quiet_plies = irreversible ? 0 : quiet_plies + 1;
+        board.makeMove(move);
+
+        if (quiet_plies >= 100) {
+            reason = "fifty moves";
+            break;
+        }
+        if (++seen[board.getHash()] >= 3) {
+            reason = "threefold repetition";
+            break;
+        }
+    }
+
+    int a_outcome = a_first ? outcome : -outcome;
+    return (a_outcome + 1) / 2.0;
+}
+
+/**
+ * @brief Updates the Elo and SPRT figures of `result` from its score
+ */
+void MatchRunner::updateStatistics(MatchResult& result) const {
+    const double games = result.games();
+    const double score = (result.wins + 0.5 * result.draws) / games;
+    const double variance = (result.wins * std::pow(1.0 - score, 2) + result.draws * std::pow(0.5 - score, 2)
+                             + result.losses * std::pow(score, 2)) / games;
+
+    // The 95% confidence interval of the score, converted to Elo
+    const double margin = 1.96 * std::sqrt(variance / games);
+    result.elo = scoreToElo(score);
+    result.elo_error = (scoreToElo(score + margin) - scoreToElo(score - margin)) / 2.0;
+
+    // The generalized SPRT, with a normal approximation of the game outcomes
+    const double score0 = eloToScore(options_.elo0);
+    const double score1 = eloToScore(options_.elo1);
+    result.llr = (variance > 0) ? games * (score1 - score0) * (2.0 * score - score0 - score1) / (2.0 * variance) : 0.0;
+    result.lower_bound = std::log(options_.beta / (1.0 - options_.alpha));
+    result.upper_bound = std::log((1.0 - options_.beta) / options_.alpha);
+}
+
+/**
+ * @brief Plays games until the match is over, recording their results and logging them to `log`
+ */
+void MatchRunner::worker(std::ostream& log) {
+    EngineContext a(engines_[0].table_megabytes);
+    EngineContext b(engines_[1].table_megabytes);
+    const size_t opening_count = std::max<size_t>(1, openings_.size());
+
+    while (!stop_) {
+        int game = next_game_++;
+        if (game >= options_.games) { return; }
+
+        // Every opening is played twice, with the engines swapping sides
+        size_t opening = (game / 2) % opening_count;
+        bool a_first = (game % 2 == 0);
+        std::string fen = openings_.empty() ? ChessBoard::STARTING_FEN : openings_[opening];
+
+        std::string reason;
+        double score = playGame(fen, a_first, a, b, reason);
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (score == 1.0) { result_.wins++; }
+        else if (score == 0.0) { result_.losses++; }
+        else { result_.draws++; }
+        updateStatistics(result_);
+
+        const std::string& p1 = engines_[a_first ? 0 : 1].name;
+        const std::string& p2 = engines_[a_first ? 1 : 0].name;
+        double p1_score = a_first ? score : 1.0 - score;
+        log << "Game " << (game + 1) << " (" << p1 << " vs " << p2 << ", opening " << (opening + 1) << "): "
+            << (p1_score == 1.0 ? "1-0" : p1_score == 0.0 ? "0-1" : "1/2-1/2") << " {" << reason << "}"
+            << std::fixed << std::setprecision(2)
+            << " | +" << result_.wins << " =" << result_.draws << " -" << result_.losses
+            << " | Elo " << result_.elo << " +/- " << result_.elo_error
+            << " | LLR " << result_.llr << " [" << result_.lower_bound << ", " << result_.upper_bound << "]"
+            << std::defaultfloat << std::endl;
+
+        if (options_.sprt && (result_.llr <= result_.lower_bound || result_.llr >= result_.upper_bound)) {
+            stop_ = true;
+        }
+    }
+}
+
+/**
+ * @brief Plays the match, logging every game to `log`. Without openings, every
+ *        game starts from the standard starting position.
+ * @return The final score.
+ */
+MatchResult MatchRunner::run(std::ostream& log) {
+    result_ = MatchResult();
+    next_game_ = 0;
+    stop_ = false;
+
+    // Games are played in pairs, so both engines play every opening from both sides
+    options_.games += options_.games % 2;
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < std::max(1, options_.concurrency); i++) {
+        workers.emplace_back(&MatchRunner::worker, this, std::ref(log));
+    }
+    for (auto& thread : workers) { thread.join(); }
+
+    return result_;
+}
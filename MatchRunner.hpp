@@ -0,0 +1,145 @@
+/**
+ * @class MatchRunner
+ * @brief Plays engine-vs-engine matches between two in-process engine configurations.
+ *
+ * Games are played concurrently, one thread per game, and every thread owns a search
+ * and transposition table for each engine, so no process or protocol overhead is
+ * involved. Openings are read from an EPD or PGN file and each one is played twice,
+ * with the engines swapping sides.
+ *
+ * Games end by the rules (mate, stalemate, threefold repetition, fifty moves, bare
+ * Kings) or are adjudicated: as soon as a search proves a forced mate, when both
+ * engines agree one side is winning by RESIGN_SCORE for a few plies, or when both
+ * agree the game is dead equal late in the game.
+ *
+ * The match reports the Elo difference of engine A over engine B with its 95% error
+ * margin, and can stop early with a sequential probability ratio test (SPRT) between
+ * the hypotheses "A is `elo0` stronger" (H0) and "A is `elo1` stronger" (H1).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "CorpusPipeline.hpp"
+
+/**
+ * The settings of one engine in a match.
+ */
+struct EngineConfig {
+    std::string name = "engine";
+    uint64_t nodes = 10000;        // Node budget per move, or 0 for none
+    int depth = 64;                // Depth limit per move
+    int64_t movetime = 0;          // Time budget per move in milliseconds, or 0 for none
+    size_t table_megabytes = 4;    // Transposition table size
+
+    /**
+     * @brief Reads a configuration of comma-separated "key=value" settings,
+     *        eg. "name=base,nodes=20000,depth=10,movetime=0,hash=4"
+     * @return True if every setting was understood. `config` is updated accordingly.
+     */
+    static bool parse(const std::string& spec, EngineConfig& config);
+};
+
+/**
+ * The settings of a match.
+ */
+struct MatchOptions {
+    int games = 1000;              // The most games to play (rounded up to whole pairs)
+    int concurrency = 1;           // The number of games played at once
+    int opening_plies = 16;        // The number of plies of every PGN game used as an opening
+    int max_plies = 400;           // Games this long are drawn
+    bool sprt = true;              // Stop as soon as the SPRT accepts a hypothesis
+    double elo0 = 0.0;             // The SPRT hypotheses, in Elo
+    double elo1 = 10.0;
+    double alpha = 0.05;           // The SPRT error rates
+    double beta = 0.05;
+};
+
+/**
+ * The running score of a match, from engine A's point of view.
+ */
+struct MatchResult {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    double elo = 0.0;
+    double elo_error = 0.0;    // The 95% error margin of `elo`
+    double llr = 0.0;          // The SPRT log-likelihood ratio
+    double lower_bound = 0.0;  // Below it H0 is accepted
+    double upper_bound = 0.0;  // Above it H1 is accepted
+
+    /**
+     * @brief Gets the number of games played
+     */
+    int games() const;
+};
+
+class MatchRunner {
+    public:
+        // Both engines must score at least this much, for RESIGN_PLIES plies in a row, to adjudicate a win
+        static const int RESIGN_SCORE = 600;
+        static const int RESIGN_PLIES = 6;
+        // Both engines must score within DRAW_SCORE, for DRAW_PLIES plies in a row after DRAW_AFTER plies, to adjudicate a draw
+        static const int DRAW_SCORE = 10;
+        static const int DRAW_PLIES = 10;
+        static const int DRAW_AFTER = 80;
+
+    private:
+        EngineConfig engines_[2];
+        MatchOptions options_;
+        std::vector<std::string> openings_; // FENs
+
+        std::mutex mutex_;
+        MatchResult result_;
+        std::atomic<int> next_game_;
+        std::atomic<bool> stop_;
+
+        /**
+         * @brief Plays one game from `fen`
+         * @param a_first True if engine A plays Player One (who moves first)
+         * @param reason Set to how the game ended
+         * @return The score of engine A: 1 for a win, 0.5 for a draw, 0 for a loss.
+         */
+        double playGame(const std::string& fen, const bool& a_first, EngineContext& a, EngineContext& b, std::string& reason);
+
+        /**
+         * @brief Plays games until the match is over, recording their results and logging them to `log`
+         */
+        void worker(std::ostream& log);
+
+        /**
+         * @brief Updates the Elo and SPRT figures of `result` from its score
+         */
+        void updateStatistics(MatchResult& result) const;
+
+    public:
+        /**
+         * @brief Constructs a match of engine `a` against engine `b`
+         */
+        MatchRunner(const EngineConfig& a, const EngineConfig& b, const MatchOptions& options);
+
+        /**
+         * @brief Reads the openings to play from an EPD file (one position per line)
+         *        or a PGN file (the first `opening_plies` plies of every game)
+         * @return The number of openings read.
+         */
+        size_t loadOpenings(std::istream& in);
+
+        /**
+         * @brief Plays the match, logging every game to `log`. Without openings, every
+         *        game starts from the standard starting position.
+         * @return The final score.
+         */
+        MatchResult run(std::ostream& log);
+
+        /**
+         * @brief Converts an expected score (0 to 1) to an Elo difference, and back
+         */
+        static double scoreToElo(const double& score);
+        static double eloToScore(const double& elo);
+};
@@ -0,0 +1,257 @@
+#include "MateSolver.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace {
+    const uint32_t INF = ProofTable::INFINITE_PN;
+
+    /*
+    Adds proof / disproof numbers, saturating at INF.
+    */
+    uint32_t saturatingAdd(const uint32_t& a, const uint32_t& b) {
+        return static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(a) + b, INF));
+    }
+}
+
+/**
+ * @brief Constructs a solver.
+ * @param table_megabytes The memory budget of the proof table in MiB.
+ * @param threads The number of threads the root moves are split across (at least 1).
+ */
+MateSolver::MateSolver(const size_t& table_megabytes, const int& threads)
+    : table_{table_megabytes}, threads_{std::max(1, threads)}, nodes_{0}, node_limit_{0}, stop_{false} {}
+
+/**
+ * @brief The df-pn "multiple iterative deepening" step. Expands the node on
+ *        `board` until its proof number reaches `threshold_pn` or its disproof
+ *        number reaches `threshold_dn`, then stores the result in the table.
+ *
+ * @param board The position to search. It is restored before returning.
+ * @param depth The number of plies left to deliver mate.
+ * @param or_node True if the attacker is to move.
+ * @param pn Set to the node's proof number.
+ * @param dn Set to the node's disproof number.
+ * @return The number of nodes searched below (and including) this node.
+ */
+uint64_t MateSolver::search(ChessBoard& board, const int& depth, const bool& or_node,
+                            const uint32_t& threshold_pn, const uint32_t& threshold_dn, uint32_t& pn, uint32_t& dn) {
+    if (++nodes_ >= node_limit_ && node_limit_) { stop_ = true; }
+
+    const uint64_t key = board.getHash();
+    std::vector<Move> moves = board.generateMoves();
+
+    // Terminal nodes: a defender without moves is mated if in check (otherwise stalemated),
+    // and an attacker without moves has failed. Running out of plies also fails.
+    if (moves.empty() || depth <= 0) {
+        bool mated = moves.empty() && !or_node && board.isInCheck();
+        pn = mated ? 0 : INF;
+        dn = mated ? INF : 0;
+        table_.store(key, depth, pn, dn, 1);
+        return 1;
+    }
+
+    // Expand the children, reusing any numbers already in the table.
+    // At OR nodes checking moves are tried first, as they are the most forcing.
+    std::vector<uint64_t> keys(moves.size());
+    std::vector<bool> checks(moves.size());
+    for (size_t i = 0; i < moves.size(); i++) {
+        board.makeMove(moves[i]);
+        keys[i] = board.getHash();
+        checks[i] = or_node && board.isInCheck();
+        board.unmakeMove();
+    }
+
+    std::vector<size_t> order(moves.size());
+    for (size_t i = 0; i < order.size(); i++) { order[i] = i; }
+    std::stable_partition(order.begin(), order.end(), [&checks](const size_t& i) { return checks[i]; });
+
+    std::vector<uint32_t> child_pn(moves.size(), 1);
+    std::vector<uint32_t> child_dn(moves.size(), 1);
+    for (size_t i = 0; i < moves.size(); i++) {
+        table_.lookup(keys[i], depth - 1, child_pn[i], child_dn[i]);
+    }
+
+    uint64_t work = 1;
+    while (true) {
+        // OR node: pn = min(child pn), dn = sum(child dn). AND node: the other way around.
+        // `best` is the most-proving child, `second` the runner-up's deciding number.
+        uint32_t sum = 0;
+        uint32_t least = INF;
+        uint32_t second = INF;
+        size_t best = order[0];
+        for (const size_t& i : order) {
+            const uint32_t& deciding = or_node ? child_pn[i] : child_dn[i];
+            const uint32_t& summed = or_node ? child_dn[i] : child_pn[i];
+            sum = saturatingAdd(sum, summed);
+            if (deciding < least) {
+                second = least;
+                least = deciding;
+                best = i;
+            } else if (deciding < second) {
+                second = deciding;
+            }
+        }
+        pn = or_node ? least : sum;
+        dn = or_node ? sum : least;
+
+        if (pn >= threshold_pn || dn >= threshold_dn || stop_) { break; }
+
+        // Give the best child just enough budget to overtake the runner-up
+        uint32_t next_pn, next_dn;
+        if (or_node) {
+            next_pn = std::min<uint32_t>(threshold_pn, saturatingAdd(second, 1));
+            next_dn = threshold_dn - dn + child_dn[best];
+        } else {
+            next_pn = threshold_pn - pn + child_pn[best];
+            next_dn = std::min<uint32_t>(threshold_dn, saturatingAdd(second, 1));
+        }
+
+        board.makeMove(moves[best]);
+        work += search(board, depth - 1, !or_node, next_pn, next_dn, child_pn[best], child_dn[best]);
+        board.unmakeMove();
+    }
+
+    table_.store(key, depth, pn, dn, work);
+    return work;
+}
+
+/**
+ * @brief Fully solves the node on `board` (until it is proven or disproven)
+ * @return True if the attacker forces mate within `depth` plies.
+ */
+bool MateSolver::prove(ChessBoard& board, const int& depth, const bool& or_node) {
+    uint32_t pn, dn;
+    search(board, depth, or_node, INF, INF, pn, dn);
+    return pn == 0;
+}
+
+/**
+ * @brief Gets the smallest ply limit, up to `max_depth`, within which the node is proven
+ * @return The ply limit, or -1 if the node is not proven within `max_depth` plies.
+ */
+int MateSolver::proofDepth(ChessBoard& board, const int& max_depth, const bool& or_node) {
+    // Mate is always delivered by the attacker, so OR nodes need an odd number of plies
+    for (int depth = or_node ? 1 : 0; depth <= max_depth; depth += 2) {
+        if (prove(board, depth, or_node)) { return depth; }
+    }
+    return -1;
+}
+
+/**
+ * @brief Appends the proof line of a proven node to `line`. The attacker
+ *        picks the fastest mate and the defender the slowest one.
+ */
+void MateSolver::extractLine(ChessBoard& board, const int& depth, const bool& or_node, std::vector<Move>& line) {
+    if (depth <= 0) { return; }
+
+    std::vector<Move> moves = board.generateMoves();
+    int best_index = -1;
+    int best_depth = -1;
+    for (size_t i = 0; i < moves.size(); i++) {
+        board.makeMove(moves[i]);
+        int child_depth = proofDepth(board, depth - 1, !or_node);
+        board.unmakeMove();
+
+        if (child_depth < 0) { continue; }
+        bool better = (best_index < 0) || (or_node ? child_depth < best_depth : child_depth > best_depth);
+        if (better) {
+            best_index = static_cast<int>(i);
+            best_depth = child_depth;
+        }
+    }
+    if (best_index < 0) { return; }
+
+    line.push_back(moves[best_index]);
+    board.makeMove(moves[best_index]);
+    extractLine(board, best_depth, !or_node, line);
+    board.unmakeMove();
+}
+
+/**
+ * @brief Searches every root move for a mate within `depth` plies, splitting
+ *        the root moves across the solver's threads.
+ * @return True if one of the root moves was proven.
+ */
+bool MateSolver::solveRoot(ChessBoard& board, const std::vector<Move>& root_moves, const int& depth) {
+    std::atomic<size_t> next{0};
+    std::atomic<bool> found{false};
+
+    // Each worker claims the next unsearched root move until one is proven
+    auto worker = [&](ChessBoard& thread_board) {
+        while (!stop_) {
+            size_t i = next++;
+            if (i >= root_moves.size()) { return; }
+
+            thread_board.makeMove(root_moves[i]);
+            bool proven = prove(thread_board, depth - 1, false);
+            thread_board.unmakeMove();
+
+            if (proven) {
+                found = true;
+                stop_ = true;
+            }
+        }
+    };
+
+    if (threads_ == 1) {
+        worker(board);
+    } else {
+        // Boards are not thread safe, so every thread searches its own copy
+        std::vector<std::unique_ptr<ChessBoard>> boards;
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads_; i++) {
+            boards.push_back(std::make_unique<ChessBoard>(board));
+        }
+        for (int i = 0; i < threads_; i++) {
+            workers.emplace_back(worker, std::ref(*boards[i]));
+        }
+        for (auto& thread : workers) { thread.join(); }
+    }
+
+    return found;
+}
+
+/**
+ * @brief Searches for a forced mate by the player whose turn it is.
+ *
+ * @param board The position to solve.
+ * @param max_mate_in The largest mate (in attacker moves) to look for.
+ * @param node_limit The maximum number of nodes to search, or 0 for no limit.
+ * @return A MateResult with the shortest mate found, if any.
+ * @post `board` is left in the same position it was passed in.
+ */
+MateResult MateSolver::solve(ChessBoard& board, const int& max_mate_in, const uint64_t& node_limit) {
+    MateResult result;
+    nodes_ = 0;
+    node_limit_ = node_limit;
+    stop_ = false;
+
+    // Checking moves first, so the threads start on the most forcing lines
+    std::vector<Move> root_moves = board.generateMoves();
+    std::stable_partition(root_moves.begin(), root_moves.end(), [&board](const Move& move) {
+        board.makeMove(move);
+        bool check = board.isInCheck();
+        board.unmakeMove();
+        return check;
+    });
+
+    for (int mate_in = 1; mate_in <= max_mate_in && !stop_; mate_in++) {
+        if (solveRoot(board, root_moves, 2 * mate_in - 1)) {
+            result.found = true;
+            result.mate_in = mate_in;
+            break;
+        }
+    }
+    result.nodes = nodes_;
+
+    // The line is extracted without a node limit, mostly from the table
+    if (result.found) {
+        node_limit_ = 0;
+        stop_ = false;
+        extractLine(board, 2 * result.mate_in - 1, true, result.line);
+    }
+
+    return result;
+}
@@ -0,0 +1,102 @@
+/**
+ * @class MateSolver
+ * @brief Proves forced mates with a depth-first proof-number (df-pn) search.
+ *
+ * The player whose turn it is at the root is the attacker. Nodes where the attacker
+ * moves are OR nodes (one proven reply is enough), nodes where the defender moves are
+ * AND nodes (every reply must be proven). Each node carries a proof number (pn) and a
+ * disproof number (dn); the search always expands the most-proving child, which lets it
+ * prove deep but narrow mates that a full-width alpha-beta search would struggle with.
+ *
+ * Mates are searched for with an increasing ply limit (mate in 1, 2, ... N), so the
+ * first proof found is the shortest forced mate. Root moves are split across threads,
+ * which share one memory-bounded ProofTable.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "ChessBoard.hpp"
+#include "ProofTable.hpp"
+
+/**
+ * The outcome of a MateSolver search.
+ */
+struct MateResult {
+    bool found = false;      // Whether a forced mate was proven
+    int mate_in = 0;         // The number of attacker moves needed to deliver mate
+    std::vector<Move> line;  // The proof line: the attacker's moves and the defender's longest resistance
+    uint64_t nodes = 0;      // The number of nodes searched
+};
+
+class MateSolver {
+    private:
+        ProofTable table_;
+        int threads_;
+
+        std::atomic<uint64_t> nodes_;
+        uint64_t node_limit_;      // 0 means unlimited
+        std::atomic<bool> stop_;   // Raised once the root is solved or the node limit is reached
+
+        /**
+         * @brief The df-pn "multiple iterative deepening" step. Expands the node on
+         *        `board` until its proof number reaches `threshold_pn` or its disproof
+         *        number reaches `threshold_dn`, then stores the result in the table.
+         *
+         * @param board The position to search. It is restored before returning.
+         * @param depth The number of plies left to deliver mate.
+         * @param or_node True if the attacker is to move.
+         * @param pn Set to the node's proof number.
+         * @param dn Set to the node's disproof number.
+         * @return The number of nodes searched below (and including) this node.
+         */
+        uint64_t search(ChessBoard& board, const int& depth, const bool& or_node,
+                            const uint32_t& threshold_pn, const uint32_t& threshold_dn, uint32_t& pn, uint32_t& dn);
+
+        /**
+         * @brief Fully solves the node on `board` (until it is proven or disproven)
+         * @return True if the attacker forces mate within `depth` plies.
+         */
+        bool prove(ChessBoard& board, const int& depth, const bool& or_node);
+
+        /**
+         * @brief Gets the smallest ply limit, up to `max_depth`, within which the node is proven
+         * @return The ply limit, or -1 if the node is not proven within `max_depth` plies.
+         */
+        int proofDepth(ChessBoard& board, const int& max_depth, const bool& or_node);
+
+        /**
+         * @brief Appends the proof line of a proven node to `line`. The attacker
+         *        picks the fastest mate and the defender the slowest one.
+         */
+        void extractLine(ChessBoard& board, const int& depth, const bool& or_node, std::vector<Move>& line);
+
+        /**
+         * @brief Searches every root move for a mate within `depth` plies, splitting
+         *        the root moves across the solver's threads.
+         * @return True if one of the root moves was proven.
+         */
+        bool solveRoot(ChessBoard& board, const std::vector<Move>& root_moves, const int& depth);
+
+    public:
+        /**
+         * @brief Constructs a solver.
+         * @param table_megabytes The memory budget of the proof table in MiB.
+         * @param threads The number of threads the root moves are split across (at least 1).
+         */
+        MateSolver(const size_t& table_megabytes = 64, const int& threads = 1);
+
+        /**
+         * @brief Searches for a forced mate by the player whose turn it is.
+         *
+         * @param board The position to solve.
+         * @param max_mate_in The largest mate (in attacker moves) to look for.
+         * @param node_limit The maximum number of nodes to search, or 0 for no limit.
+         * @return A MateResult with the shortest mate found, if any.
+         * @post `board` is left in the same position it was passed in.
+         */
+        MateResult solve(ChessBoard& board, const int& max_mate_in, const uint64_t& node_limit = 0);
+};
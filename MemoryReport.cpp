@@ -0,0 +1,66 @@
+#include "MemoryReport.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+/**
+ * @brief Adds `bytes` used by `objects` objects to `category`
+ */
+void MemoryReport::add(const std::string& category, const size_t& bytes, const size_t& objects) {
+    for (Line& line : lines_) {
+        if (line.category == category) {
+            line.objects += objects;
+            line.bytes += bytes;
+            return;
+        }
+    }
+    lines_.push_back({category, objects, bytes});
+}
+
+/**
+ * @brief Gets one line per category
+ */
+const std::vector<MemoryReport::Line>& MemoryReport::lines() const {
+    return lines_;
+}
+
+/**
+ * @brief Gets the bytes of every category together
+ */
+size_t MemoryReport::total() const {
+    size_t total = 0;
+    for (const Line& line : lines_) { total += line.bytes; }
+    return total;
+}
+
+/**
+ * @brief Writes one "<category> <objects> <bytes>" line per category and the total,
+ *        each line starting with `prefix`
+ */
+void MemoryReport::write(std::ostream& out, const std::string& prefix) const {
+    for (const Line& line : lines_) {
+        out << prefix << std::left << std::setw(22) << line.category << std::right
+            << std::setw(10) << line.objects << std::setw(14) << line.bytes << std::endl;
+    }
+    out << prefix << std::left << std::setw(22) << "total" << std::right
+        << std::setw(10) << "" << std::setw(14) << total() << std::endl;
+}
+
+/**
+ * @brief Gets the heap bytes held by `text` (none if it fits the string's inline buffer)
+ */
+size_t MemoryReport::stringHeapBytes(const std::string& text) {
+    static const size_t INLINE_CAPACITY = std::string().capacity();
+    return text.capacity() > INLINE_CAPACITY ? text.capacity() + 1 : 0;
+}
+
+/**
+ * @brief Estimates the heap bytes of a std::deque (and so a std::stack) holding
+ *        `size` elements of `element_size` bytes: 512 byte blocks plus their map
+ */
+size_t MemoryReport::dequeHeapBytes(const size_t& size, const size_t& element_size) {
+    const size_t per_block = std::max<size_t>(1, 512 / element_size);
+    const size_t blocks = size / per_block + 1;
+    const size_t map_slots = std::max<size_t>(8, blocks + 2);
+    return blocks * per_block * element_size + map_slots * sizeof(void*);
+}
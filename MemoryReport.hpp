@@ -0,0 +1,62 @@
+/**
+ * @class MemoryReport
+ * @brief The bytes used by a set of objects, by category ("board", "history", ...).
+ *
+ * Every subsystem that holds a significant amount of memory adds its own objects to a
+ * report through a reportMemory() method. Heap blocks are counted at the size requested
+ * from the allocator, so the allocator's own bookkeeping (about 16 bytes per block) comes
+ * on top. Where a standard container hides its layout (std::deque, std::string) the
+ * size is estimated the way libstdc++ lays it out.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class MemoryReport {
+    public:
+        struct Line {
+            std::string category;
+            size_t objects;
+            size_t bytes;
+        };
+
+    private:
+        std::vector<Line> lines_; // In the order the categories were first added
+
+    public:
+        /**
+         * @brief Adds `bytes` used by `objects` objects to `category`
+         */
+        void add(const std::string& category, const size_t& bytes, const size_t& objects = 1);
+
+        /**
+         * @brief Gets one line per category
+         */
+        const std::vector<Line>& lines() const;
+
+        /**
+         * @brief Gets the bytes of every category together
+         */
+        size_t total() const;
+
+        /**
+         * @brief Writes one "<category> <objects> <bytes>" line per category and the total,
+         *        each line starting with `prefix`
+         */
+        void write(std::ostream& out, const std::string& prefix = "") const;
+
+        /**
+         * @brief Gets the heap bytes held by `text` (none if it fits the string's inline buffer)
+         */
+        static size_t stringHeapBytes(const std::string& text);
+
+        /**
+         * @brief Estimates the heap bytes of a std::deque (and so a std::stack) holding
+         *        `size` elements of `element_size` bytes: 512 byte blocks plus their map
+         */
+        static size_t dequeHeapBytes(const size_t& size, const size_t& element_size);
+};
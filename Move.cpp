@@ -12,20 +12,23 @@
      * @param captured_piece A pointer to the ChessPiece that was 
      *        captured during the move. Default value nullptr.
      *        Nullptr is also used if we have no piece that was captured.
+     * @param first_move A flag indicating whether this is the first move of `moved_piece`.
+     *        Default value false.
      * @post The private members of the Move are updated accordingly.
      */
-    Move:: Move(const Square& from, const Square& to, ChessPiece* moved_piece, ChessPiece* captured_piece){
+    Move:: Move(const Square& from, const Square& to, ChessPiece* moved_piece, ChessPiece* captured_piece, const bool& first_move){
         from_ = from;
         to_ = to;
         moved_piece_ = moved_piece;
         captured_piece_ = captured_piece;
+        first_move_ = first_move;
     }
 
     /**
      * Gets the original position (starting square) of the move.
      * @return The original position as a Square (std::pair<int, int>).
      */
-    Square Move:: getOriginalPosition(){
+    Square Move:: getOriginalPosition() const{
         return from_;
     }
 
@@ -33,7 +36,7 @@
      * Gets the target position (destination square) of the move.
      * @return The target position as a Square (std::pair<int, int>).
      */
-    Square Move:: getTargetPosition(){
+    Square Move:: getTargetPosition() const{
         return to_;
     }
 
@@ -41,7 +44,7 @@
      * Gets a pointer to the ChessPiece that was moved.
      * @return A pointer to the moved ChessPiece.
      */
-    ChessPiece* Move:: getMovedPiece(){
+    ChessPiece* Move:: getMovedPiece() const{
         return moved_piece_;
     }
 
@@ -49,6 +52,44 @@
      * Gets a pointer to the ChessPiece that was captured during the move.
      * @return A pointer to the captured ChessPiece, or nullptr if no piece was captured.
      */
-     ChessPiece* Move::getCapturedPiece(){
+     ChessPiece* Move::getCapturedPiece() const{
         return captured_piece_;
-    };
\ No newline at end of file
+    }
+
+    /**
+     * Gets whether this move was the first move made by the moved piece.
+     * @return The value stored in `first_move_`
+     */
+    bool Move::isFirstMove() const{
+        return first_move_;
+    }
+
+    /**
+     * Formats the move the same way the game loop reports it: "(row, col) to (row, col)"
+     * @return The formatted move as a string.
+     */
+    std::string Move::toString() const{
+        return "(" + std::to_string(from_.first) + ", " + std::to_string(from_.second) + ") to ("
+            + std::to_string(to_.first) + ", " + std::to_string(to_.second) + ")";
+    }
+
+    /**
+     * Formats the move in coordinate notation as used by chess protocols, eg. "d2d4":
+     * each column is written as a file letter ('a' for column 0) and each row as a rank ('1' for row 0).
+     * @return The move in coordinate notation.
+     */
+    std::string Move::toUCI() const{
+        std::string uci;
+        uci += static_cast<char>('a' + from_.second);
+        uci += static_cast<char>('1' + from_.first);
+        uci += static_cast<char>('a' + to_.second);
+        uci += static_cast<char>('1' + to_.first);
+        return uci;
+    }
+
+    /**
+     * Two moves are considered equal if they share the same original and target squares.
+     */
+    bool Move::operator==(const Move& other) const{
+        return from_ == other.from_ && to_ == other.to_;
+    }
\ No newline at end of file
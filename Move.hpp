@@ -1,5 +1,6 @@
 #pragma once
 #include <utility>
+#include <string>
 #include "pieces_module.hpp"
 
 /** We alias a pair of integers as a square (or cell).
@@ -13,6 +14,7 @@ class Move {
     ChessPiece* captured_piece_;  // A pointer to the piece that was captured (or nullptr if none)
     Square from_; // Represents the original square that `moved_piece_` started from
     Square to_; // Represents the destination square that `moved_piece_` moved to
+    bool first_move_; // Whether this was the first time `moved_piece_` moved (so undo can restore its flag)
 
     public: 
     Move() = delete;
@@ -28,32 +30,57 @@ class Move {
      * @param captured_piece A pointer to the ChessPiece that was 
      *        captured during the move. Default value nullptr.
      *        Nullptr is also used if we have no piece that was captured.
+     * @param first_move A flag indicating whether this is the first move of `moved_piece`.
+     *        Default value false.
      * @post The private members of the Move are updated accordingly.
      */
-    Move(const Square& from, const Square& to, ChessPiece* moved_piece, ChessPiece* captured_piece = nullptr);
+    Move(const Square& from, const Square& to, ChessPiece* moved_piece, ChessPiece* captured_piece = nullptr, const bool& first_move = false);
 
     /**
      * Gets the original position (starting square) of the move.
      * @return The original position as a Square (std::pair<int, int>).
      */
-    Square getOriginalPosition();
+    Square getOriginalPosition() const;
 
     /**
      * Gets the target position (destination square) of the move.
      * @return The target position as a Square (std::pair<int, int>).
      */
-    Square getTargetPosition();
+    Square getTargetPosition() const;
 
     /**
      * Gets a pointer to the ChessPiece that was moved.
      * @return A pointer to the moved ChessPiece.
      */
-    ChessPiece* getMovedPiece();
+    ChessPiece* getMovedPiece() const;
 
     /**
      * Gets a pointer to the ChessPiece that was captured during the move.
      * @return A pointer to the captured ChessPiece, or nullptr if no piece was captured.
      */
-    ChessPiece* getCapturedPiece();
+    ChessPiece* getCapturedPiece() const;
 
+    /**
+     * Gets whether this move was the first move made by the moved piece.
+     * @return The value stored in `first_move_`
+     */
+    bool isFirstMove() const;
+
+    /**
+     * Formats the move the same way the game loop reports it: "(row, col) to (row, col)"
+     * @return The formatted move as a string.
+     */
+    std::string toString() const;
+
+    /**
+     * Formats the move in coordinate notation as used by chess protocols, eg. "d2d4":
+     * each column is written as a file letter ('a' for column 0) and each row as a rank ('1' for row 0).
+     * @return The move in coordinate notation.
+     */
+    std::string toUCI() const;
+
+    /**
+     * Two moves are considered equal if they share the same original and target squares.
+     */
+    bool operator==(const Move& other) const;
 };
\ No newline at end of file
@@ -0,0 +1,481 @@
+#include "MoveGenerator.hpp"
+
+#include <cstring>
+#include <sstream>
+
+#include "Zobrist.hpp"
+
+namespace {
+    /*
+    The targets of a knight and of a king on every square, and the squares along each of
+    the 8 rays from every square (the 4 straight ones first, then the 4 diagonals).
+    */
+    struct Tables {
+        uint8_t knight[64][8];
+        int knight_count[64];
+        uint8_t king[64][8];
+        int king_count[64];
+        uint8_t rays[64][8][7];
+        int ray_length[64][8];
+        uint64_t ray_mask[64][8];   // The squares of each ray as a bit set
+        int8_t direction[64][64];   // The ray from the first square that holds the second, or -1
+    };
+
+    const int KNIGHT_STEPS[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+    const int KING_STEPS[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+    bool onBoard(const int& row, const int& col) {
+        return row >= 0 && row < 8 && col >= 0 && col < 8;
+    }
+
+    Tables buildTables() {
+        Tables tables{};
+        std::memset(tables.direction, -1, sizeof(tables.direction));
+        for (int square = 0; square < 64; square++) {
+            int row = square / 8;
+            int col = square % 8;
+            for (int i = 0; i < 8; i++) {
+                int knight_row = row + KNIGHT_STEPS[i][0];
+                int knight_col = col + KNIGHT_STEPS[i][1];
+                if (onBoard(knight_row, knight_col)) {
+                    tables.knight[square][tables.knight_count[square]++] = static_cast<uint8_t>(knight_row * 8 + knight_col);
+                }
+
+                // The king steps double as the ray directions
+                if (onBoard(row + KING_STEPS[i][0], col + KING_STEPS[i][1])) {
+                    tables.king[square][tables.king_count[square]++] = static_cast<uint8_t>((row + KING_STEPS[i][0]) * 8 + col + KING_STEPS[i][1]);
+                }
+                for (int step = 1; onBoard(row + step * KING_STEPS[i][0], col + step * KING_STEPS[i][1]); step++) {
+                    const int target = (row + step * KING_STEPS[i][0]) * 8 + col + step * KING_STEPS[i][1];
+                    tables.rays[square][i][tables.ray_length[square][i]++] = static_cast<uint8_t>(target);
+                    tables.ray_mask[square][i] |= uint64_t(1) << target;
+                    tables.direction[square][target] = static_cast<int8_t>(i);
+                }
+            }
+        }
+        return tables;
+    }
+
+    const Tables TABLES = buildTables();
+
+    // Piece kinds, without the player (pieceKind() % 6)
+    const int PAWN = 0;
+    const int KNIGHT = 1;
+    const int BISHOP = 2;
+    const int ROOK = 3;
+    const int QUEEN = 4;
+    const int KING = 5;
+
+    bool isOwn(const uint8_t& kind, const bool& player_one) {
+        return kind != Position::EMPTY && (kind < 6) == player_one;
+    }
+
+    /*
+    Whether a piece of `player_one` may land on a square holding `kind`: it must be empty
+    or hold an enemy piece other than the King.
+    */
+    bool canLandOn(const uint8_t& kind, const bool& player_one) {
+        return kind == Position::EMPTY || ((kind < 6) != player_one && kind % 6 != KING);
+    }
+
+    int kingSquare(const Position& position, const bool& player_one) {
+        const uint8_t king = player_one ? KING : KING + 6;
+        for (int square = 0; square < 64; square++) {
+            if (position.squares[square] == king) { return square; }
+        }
+        return -1;
+    }
+
+    /*
+    What the player to move must respect for a move not to leave its King attacked: with
+    no en passant or castling, a move other than the King's is legal exactly when it lands
+    on check_mask (the checker, or a square between it and the King) and, for a pinned
+    piece, stays on the line of its pin. Computed once per position by walking out from
+    the King.
+    */
+    struct Constraints {
+        int king = -1;
+        int checkers = 0;
+        uint64_t check_mask = ~uint64_t(0);
+        uint64_t pinned = 0;
+    };
+
+    Constraints findConstraints(const Position& position) {
+        Constraints constraints;
+        const bool player_one = position.player_one_turn;
+        constraints.king = kingSquare(position, player_one);
+        if (constraints.king < 0) { return constraints; }
+
+        const int king = constraints.king;
+        const int offset = player_one ? 6 : 0;
+        uint64_t checks = 0;
+
+        // Pawns and knights give check from one square, which then has to be captured
+        const int pawn_row = king / 8 + (player_one ? 1 : -1);
+        if (pawn_row >= 0 && pawn_row < 8) {
+            for (int side = -1; side <= 1; side += 2) {
+                const int col = king % 8 + side;
+                if (col >= 0 && col < 8 && position.at(pawn_row, col) == PAWN + offset) {
+                    checks |= uint64_t(1) << (pawn_row * 8 + col);
+                    constraints.checkers++;
+                }
+            }
+        }
+        for (int i = 0; i < TABLES.knight_count[king]; i++) {
+            if (position.squares[TABLES.knight[king][i]] == KNIGHT + offset) {
+                checks |= uint64_t(1) << TABLES.knight[king][i];
+                constraints.checkers++;
+            }
+        }
+
+        // Along each ray, an enemy slider checks if nothing stands in the way, and pins if one own piece does
+        for (int ray = 0; ray < 8; ray++) {
+            const int slider = (ray < 4) ? ROOK + offset : BISHOP + offset;
+            int blocker = -1;
+            for (int i = 0; i < TABLES.ray_length[king][ray]; i++) {
+                const int square = TABLES.rays[king][ray][i];
+                const uint8_t kind = position.squares[square];
+                if (kind == Position::EMPTY) { continue; }
+
+                if (isOwn(kind, player_one)) {
+                    if (blocker >= 0) { break; }
+                    blocker = square;
+                    continue;
+                }
+                if (kind == slider || kind == QUEEN + offset) {
+                    if (blocker >= 0) {
+                        constraints.pinned |= uint64_t(1) << blocker;
+                    } else {
+                        checks |= TABLES.ray_mask[king][ray] & ~TABLES.ray_mask[square][ray];
+                        constraints.checkers++;
+                    }
+                }
+                break;
+            }
+        }
+
+        if (constraints.checkers) { constraints.check_mask = checks; }
+        return constraints;
+    }
+
+    /*
+    Determines whether the pseudo-legal `move` (one that obeys its piece's movement rules)
+    leaves the King of the player to move safe.
+    */
+    bool isSafe(const Position& position, const Constraints& constraints, const MoveGenerator::MoveWord& move) {
+        const int from = MoveGenerator::fromSquare(move);
+        const int to = MoveGenerator::toSquare(move);
+        if (constraints.king < 0) { return true; }
+
+        if (from == constraints.king) {
+            // The King must not step along the line of a slider it hides from, so it is lifted first
+            Position lifted = position;
+            lifted.squares[from] = Position::EMPTY;
+            return !MoveGenerator::isAttacked(lifted, to, !position.player_one_turn);
+        }
+        if (constraints.checkers > 1 || !((constraints.check_mask >> to) & 1)) { return false; }
+        if ((constraints.pinned >> from) & 1) {
+            return (TABLES.ray_mask[constraints.king][TABLES.direction[constraints.king][from]] >> to) & 1;
+        }
+        return true;
+    }
+
+    /*
+    Adds every move of the piece on `square` that obeys its movement rules, whether or not
+    it leaves its own King attacked.
+    */
+    void addPieceMoves(const Position& position, const int& square, MoveGenerator::MoveList& moves) {
+        const uint8_t kind = position.squares[square];
+        const bool player_one = kind < 6;
+        const int row = square / 8;
+        const int col = square % 8;
+        auto add = [&](const int& target) { moves.moves[moves.size++] = MoveGenerator::pack(square, target); };
+
+        switch (kind % 6) {
+            case PAWN: {
+                const int direction = player_one ? 1 : -1;
+                const int next_row = row + direction;
+                if (next_row < 0 || next_row >= 8) { return; }
+
+                if (position.at(next_row, col) == Position::EMPTY) {
+                    add(next_row * 8 + col);
+                    int jump_row = next_row + direction;
+                    if (!position.hasMoved(row, col) && jump_row >= 0 && jump_row < 8 && position.at(jump_row, col) == Position::EMPTY) {
+                        add(jump_row * 8 + col);
+                    }
+                }
+                for (int side = -1; side <= 1; side += 2) {
+                    if (col + side < 0 || col + side >= 8) { continue; }
+                    uint8_t target = position.at(next_row, col + side);
+                    if (target != Position::EMPTY && canLandOn(target, player_one)) { add(next_row * 8 + col + side); }
+                }
+                return;
+            }
+            case KNIGHT:
+                for (int i = 0; i < TABLES.knight_count[square]; i++) {
+                    if (canLandOn(position.squares[TABLES.knight[square][i]], player_one)) { add(TABLES.knight[square][i]); }
+                }
+                return;
+            case KING:
+                for (int i = 0; i < TABLES.king_count[square]; i++) {
+                    if (canLandOn(position.squares[TABLES.king[square][i]], player_one)) { add(TABLES.king[square][i]); }
+                }
+                return;
+            default: {
+                // Rooks use the straight rays, bishops the diagonal ones and queens all of them
+                const int first = (kind % 6 == BISHOP) ? 4 : 0;
+                const int last = (kind % 6 == ROOK) ? 4 : 8;
+                for (int ray = first; ray < last; ray++) {
+                    for (int i = 0; i < TABLES.ray_length[square][ray]; i++) {
+                        const int target = TABLES.rays[square][ray][i];
+                        if (canLandOn(position.squares[target], player_one)) { add(target); }
+                        if (position.squares[target] != Position::EMPTY) { break; }
+                    }
+                }
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * Packs the squares of `move`.
+ */
+MoveGenerator::MoveWord MoveGenerator::pack(const Move& move) {
+    const Square from = move.getOriginalPosition();
+    const Square to = move.getTargetPosition();
+    return pack(from.first * 8 + from.second, to.first * 8 + to.second);
+}
+
+/**
+ * Writes `move` in coordinate notation, as Move::toUCI().
+ */
+std::string MoveGenerator::toUCI(const MoveWord& move) {
+    std::string uci;
+    uci += static_cast<char>('a' + fromSquare(move) % 8);
+    uci += static_cast<char>('1' + fromSquare(move) / 8);
+    uci += static_cast<char>('a' + toSquare(move) % 8);
+    uci += static_cast<char>('1' + toSquare(move) / 8);
+    return uci;
+}
+
+/**
+ * Reads a move in coordinate notation ("e2e4").
+ *
+ * @return True if `text` names two squares. The move may still be illegal.
+ */
+bool MoveGenerator::parseUCI(const std::string& text, MoveWord& move) {
+    if (text.size() != 4) { return false; }
+    for (int i = 0; i < 4; i += 2) {
+        if (text[i] < 'a' || text[i] > 'h' || text[i + 1] < '1' || text[i + 1] > '8') { return false; }
+    }
+    move = pack((text[1] - '1') * 8 + (text[0] - 'a'), (text[3] - '1') * 8 + (text[2] - 'a'));
+    return true;
+}
+
+/**
+ * Describes `position` as a FEN string, as ChessBoard::toFEN().
+ */
+std::string MoveGenerator::toFEN(const Position& position) {
+    static const char SYMBOLS[12] = {'P', 'N', 'B', 'R', 'Q', 'K', 'p', 'n', 'b', 'r', 'q', 'k'};
+
+    std::string fen;
+    for (int row = 7; row >= 0; row--) {
+        int empty = 0;
+        for (int col = 0; col < 8; col++) {
+            const uint8_t kind = position.at(row, col);
+            if (kind == Position::EMPTY) { empty++; continue; }
+            if (empty) { fen += static_cast<char>('0' + empty); empty = 0; }
+            fen += SYMBOLS[kind];
+        }
+        if (empty) { fen += static_cast<char>('0' + empty); }
+        if (row) { fen += '/'; }
+    }
+
+    fen += position.player_one_turn ? " w - - 0 1" : " b - - 0 1";
+    return fen;
+}
+
+/**
+ * Reads a FEN string into `position`, with the conventions of ChessBoard::loadFEN():
+ * only the placement and the side to move are read, and a pawn has moved if it is off
+ * its starting row.
+ *
+ * @return False if the FEN is not valid (`position` is then unspecified).
+ */
+bool MoveGenerator::parseFEN(const std::string& fen, Position& position) {
+    static const char SYMBOLS[] = "PNBRQKpnbrqk";
+
+    std::istringstream fields(fen);
+    std::string placement, side;
+    if (!(fields >> placement)) { return false; }
+    if (!(fields >> side)) { side = "w"; }
+    if (side != "w" && side != "b") { return false; }
+
+    for (int square = 0; square < 64; square++) { position.squares[square] = Position::EMPTY; }
+    position.moved = 0;
+
+    int row = 7;
+    int col = 0;
+    for (char symbol : placement) {
+        if (symbol == '/') {
+            if (col != 8 || row == 0) { return false; }
+            row--;
+            col = 0;
+        } else if (symbol >= '1' && symbol <= '8') {
+            col += symbol - '0';
+            if (col > 8) { return false; }
+        } else {
+            const char* found = std::strchr(SYMBOLS, symbol);
+            if (col >= 8 || !found || !symbol) { return false; }
+            const uint8_t kind = static_cast<uint8_t>(found - SYMBOLS);
+            position.squares[row * 8 + col] = kind;
+            if (kind % 6 == PAWN && row != (kind < 6 ? 1 : 6)) { position.moved |= uint64_t(1) << (row * 8 + col); }
+            col++;
+        }
+    }
+    if (row != 0 || col != 8) { return false; }
+
+    position.player_one_turn = (side == "w");
+    position.hash = position.computeHash();
+    return true;
+}
+
+/**
+ * Gets the position the rules start from (ChessBoard::STARTING_FEN).
+ */
+Position MoveGenerator::startingPosition() {
+    static const uint8_t BACK_RANK[8] = {ROOK, KNIGHT, BISHOP, KING, QUEEN, BISHOP, KNIGHT, ROOK};
+
+    Position position;
+    for (int square = 0; square < 64; square++) { position.squares[square] = Position::EMPTY; }
+    for (int col = 0; col < 8; col++) {
+        position.squares[col] = BACK_RANK[col];
+        position.squares[8 + col] = PAWN;
+        position.squares[48 + col] = PAWN + 6;
+        position.squares[56 + col] = BACK_RANK[col] + 6;
+    }
+    position.moved = 0;
+    position.player_one_turn = true;
+    position.hash = position.computeHash();
+    return position;
+}
+
+/**
+ * Determines whether a piece of Player One (or Two) attacks the square `square`.
+ */
+bool MoveGenerator::isAttacked(const Position& position, const int& square, const bool& by_player_one) {
+    const int offset = by_player_one ? 0 : 6;
+    const int row = square / 8;
+    const int col = square % 8;
+
+    // A pawn attacks the two squares diagonally ahead of it
+    const int pawn_row = row - (by_player_one ? 1 : -1);
+    if (pawn_row >= 0 && pawn_row < 8) {
+        if (col > 0 && position.at(pawn_row, col - 1) == PAWN + offset) { return true; }
+        if (col < 7 && position.at(pawn_row, col + 1) == PAWN + offset) { return true; }
+    }
+
+    for (int i = 0; i < TABLES.knight_count[square]; i++) {
+        if (position.squares[TABLES.knight[square][i]] == KNIGHT + offset) { return true; }
+    }
+    for (int i = 0; i < TABLES.king_count[square]; i++) {
+        if (position.squares[TABLES.king[square][i]] == KING + offset) { return true; }
+    }
+
+    for (int ray = 0; ray < 8; ray++) {
+        const int slider = (ray < 4) ? ROOK + offset : BISHOP + offset;
+        for (int i = 0; i < TABLES.ray_length[square][ray]; i++) {
+            const uint8_t kind = position.squares[TABLES.rays[square][ray][i]];
+            if (kind == Position::EMPTY) { continue; }
+            if (kind == slider || kind == QUEEN + offset) { return true; }
+            break;
+        }
+    }
+    return false;
+}
+
+/**
+ * Determines whether the King of the player to move is attacked.
+ */
+bool MoveGenerator::isInCheck(const Position& position) {
+    const int king = kingSquare(position, position.player_one_turn);
+    return king >= 0 && isAttacked(position, king, !position.player_one_turn);
+}
+
+/**
+ * Generates every legal move of the player to move.
+ *
+ * @return The number of moves, also in moves.size.
+ */
+int MoveGenerator::generate(const Position& position, MoveList& moves) {
+    const bool player_one = position.player_one_turn;
+    const Constraints constraints = findConstraints(position);
+
+    MoveList candidates;
+    for (int square = 0; square < 64; square++) {
+        if (!isOwn(position.squares[square], player_one)) { continue; }
+        // In double check only the King can move
+        if (constraints.checkers > 1 && square != constraints.king) { continue; }
+        addPieceMoves(position, square, candidates);
+    }
+
+    moves.size = 0;
+    for (int i = 0; i < candidates.size; i++) {
+        if (isSafe(position, constraints, candidates.moves[i])) { moves.moves[moves.size++] = candidates.moves[i]; }
+    }
+    return moves.size;
+}
+
+/**
+ * Determines whether `move` is legal for the player to move.
+ */
+bool MoveGenerator::isLegal(const Position& position, const MoveWord& move) {
+    const uint8_t kind = position.squares[fromSquare(move)];
+    if (!isOwn(kind, position.player_one_turn)) { return false; }
+
+    MoveList candidates;
+    addPieceMoves(position, fromSquare(move), candidates);
+    for (int i = 0; i < candidates.size; i++) {
+        if (candidates.moves[i] == move) { return isSafe(position, findConstraints(position), move); }
+    }
+    return false;
+}
+
+/**
+ * Plays `move` (which must be legal), updating the moved flags, the hash and the side to move.
+ */
+void MoveGenerator::apply(Position& position, const MoveWord& move) {
+    const int from = fromSquare(move);
+    const int to = toSquare(move);
+    const uint8_t kind = position.squares[from];
+    const uint8_t captured = position.squares[to];
+
+    position.hash ^= Zobrist::pieceKey(kind, from / 8, from % 8) ^ Zobrist::pieceKey(kind, to / 8, to % 8);
+    if (captured != Position::EMPTY) { position.hash ^= Zobrist::pieceKey(captured, to / 8, to % 8); }
+    position.hash ^= Zobrist::sideKey();
+
+    position.squares[to] = kind;
+    position.squares[from] = Position::EMPTY;
+    position.moved = (position.moved & ~(uint64_t(1) << from)) | (uint64_t(1) << to);
+    position.player_one_turn = !position.player_one_turn;
+}
+
+/**
+ * Counts the leaf nodes of the legal move tree `depth` plies deep, as ChessBoard::perft().
+ */
+uint64_t MoveGenerator::perft(const Position& position, const int& depth) {
+    if (depth <= 0) { return 1; }
+
+    MoveList moves;
+    generate(position, moves);
+    if (depth == 1) { return moves.size; }
+
+    uint64_t nodes = 0;
+    for (int i = 0; i < moves.size; i++) {
+        Position next = position;
+        apply(next, moves.moves[i]);
+        nodes += perft(next, depth - 1);
+    }
+    return nodes;
+}
@@ -0,0 +1,120 @@
+/**
+ * @brief Legal move generation directly on a Position, without any allocation.
+ *
+ * The rules are those of the ChessPiece classes (no castling, en passant or promotion;
+ * a pawn may jump two rows until it has moved; a King can never be captured), so the
+ * moves found here are exactly those of ChessBoard::generateMoves(), possibly in another
+ * order. The knight, king and ray tables are built once and shared read-only by every
+ * thread.
+ *
+ * Legality is decided with check and pin masks found once per position by walking out
+ * from the King, rather than by playing every candidate and looking for an attack: only
+ * King moves need an attack test.
+ *
+ * Moves are packed into 16 bit words (from square | to square << 6, squares being
+ * row * 8 + col), small enough to store by the hundred per game.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Move.hpp"
+#include "Position.hpp"
+
+namespace MoveGenerator {
+    typedef uint16_t MoveWord;
+
+    // More than the most moves any position allows
+    const int MAX_MOVES = 256;
+
+    /*
+    The moves of one position, on the stack.
+    */
+    struct MoveList {
+        MoveWord moves[MAX_MOVES];
+        int size = 0;
+    };
+
+    /**
+     * Packs the move from square `from` to square `to` (row * 8 + col).
+     */
+    inline MoveWord pack(const int& from, const int& to) {
+        return static_cast<MoveWord>(from | (to << 6));
+    }
+
+    inline int fromSquare(const MoveWord& move) {
+        return move & 63;
+    }
+
+    inline int toSquare(const MoveWord& move) {
+        return (move >> 6) & 63;
+    }
+
+    /**
+     * Packs the squares of `move`.
+     */
+    MoveWord pack(const Move& move);
+
+    /**
+     * Writes `move` in coordinate notation, as Move::toUCI().
+     */
+    std::string toUCI(const MoveWord& move);
+
+    /**
+     * Reads a move in coordinate notation ("e2e4").
+     *
+     * @return True if `text` names two squares. The move may still be illegal.
+     */
+    bool parseUCI(const std::string& text, MoveWord& move);
+
+    /**
+     * Describes `position` as a FEN string, as ChessBoard::toFEN().
+     */
+    std::string toFEN(const Position& position);
+
+    /**
+     * Reads a FEN string into `position`, with the conventions of ChessBoard::loadFEN().
+     *
+     * @return False if the FEN is not valid (`position` is then unspecified).
+     */
+    bool parseFEN(const std::string& fen, Position& position);
+
+    /**
+     * Gets the position the rules start from (ChessBoard::STARTING_FEN).
+     */
+    Position startingPosition();
+
+    /**
+     * Determines whether a piece of Player One (or Two) attacks the square `square`.
+     */
+    bool isAttacked(const Position& position, const int& square, const bool& by_player_one);
+
+    /**
+     * Determines whether the King of the player to move is attacked.
+     */
+    bool isInCheck(const Position& position);
+
+    /**
+     * Generates every legal move of the player to move.
+     *
+     * @return The number of moves, also in moves.size.
+     */
+    int generate(const Position& position, MoveList& moves);
+
+    /**
+     * Determines whether `move` is legal for the player to move.
+     */
+    bool isLegal(const Position& position, const MoveWord& move);
+
+    /**
+     * Plays `move` (which must be legal), updating the moved flags, the hash and the side to move.
+     */
+    void apply(Position& position, const MoveWord& move);
+
+    /**
+     * Counts the leaf nodes of the legal move tree `depth` plies deep, as ChessBoard::perft().
+     */
+    uint64_t perft(const Position& position, const int& depth);
+};
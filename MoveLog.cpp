@@ -0,0 +1,374 @@
+#include "MoveLog.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    const char SEGMENT_MAGIC[4] = {'C', 'H', 'W', 'L'};
+
+    static_assert(sizeof(MoveLog::Record) == 24, "Log records must stay packed in 24 bytes");
+
+    /*
+    Writes all of `size` bytes, retrying short writes.
+    */
+    bool writeAll(const int& fd, const char* data, size_t size) {
+        while (size) {
+            ssize_t written = ::write(fd, data, size);
+            if (written < 0 && errno == EINTR) { continue; }
+            if (written <= 0) { return false; }
+            data += written;
+            size -= written;
+        }
+        return true;
+    }
+}
+
+MoveLog::MoveLog()
+    : fd_{-1}, segment_{0}, segment_bytes_{0}, appended_{0}, durable_{0}, records_{0}, commits_{0}, failed_{false},
+      stopping_{false} {}
+
+/**
+ * @brief Commits what is left and closes the log
+ */
+MoveLog::~MoveLog() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stopping_ = true;
+    }
+    pending_.notify_all();
+    if (flusher_.joinable()) { flusher_.join(); }
+    if (fd_ >= 0) { ::close(fd_); }
+}
+
+/**
+ * @brief Gets the path of segment `segment` in `directory`
+ */
+std::string MoveLog::segmentPath(const std::string& directory, const uint64_t& segment) {
+    return directory + "/moves." + std::to_string(segment) + ".log";
+}
+
+/**
+ * @brief Lists the numbers of the segments in `directory`, in increasing order
+ */
+std::vector<uint64_t> MoveLog::listSegments(const std::string& directory) {
+    std::vector<uint64_t> segments;
+    DIR* dir = ::opendir(directory.c_str());
+    if (!dir) { return segments; }
+
+    while (dirent* entry = ::readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name.size() < 11 || name.compare(0, 6, "moves.") != 0 || name.compare(name.size() - 4, 4, ".log") != 0) { continue; }
+        const std::string number = name.substr(6, name.size() - 10);
+        if (number.empty() || number.find_first_not_of("0123456789") != std::string::npos) { continue; }
+        segments.push_back(std::stoull(number));
+    }
+    ::closedir(dir);
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+/**
+ * @brief Computes the checksum of `size` bytes (FNV-1a), continuing from `hash`
+ */
+uint32_t MoveLog::checksum(const void* data, const size_t& size, uint32_t hash) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Opens segment `segment` for appending, writing its header
+ */
+bool MoveLog::openSegment(const uint64_t& segment) {
+    const std::string path = segmentPath(directory_, segment);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error_ = path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    const uint32_t version = VERSION;
+    char header[8];
+    std::memcpy(header, SEGMENT_MAGIC, 4);
+    std::memcpy(header + 4, &version, 4);
+    if (!writeAll(fd, header, sizeof(header)) || ::fdatasync(fd) < 0) {
+        error_ = path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    // Make the new file itself durable
+    int dir = ::open(directory_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir >= 0) {
+        ::fsync(dir);
+        ::close(dir);
+    }
+
+    if (fd_ >= 0) { ::close(fd_); }
+    fd_ = fd;
+    segment_ = segment;
+    segment_bytes_ = sizeof(header);
+    return true;
+}
+
+/**
+ * @brief Opens a log in `directory` (which must exist), starting a segment after the last one there
+ * @return True on success. Otherwise error() says why.
+ */
+bool MoveLog::open(const std::string& directory) {
+    directory_ = directory;
+    const std::vector<uint64_t> segments = listSegments(directory);
+    if (!openSegment(segments.empty() ? 0 : segments.back() + 1)) { return false; }
+
+    flusher_ = std::thread([this]() { flush(); });
+    return true;
+}
+
+/**
+ * @brief Gets the directory of the log
+ */
+const std::string& MoveLog::directory() const {
+    return directory_;
+}
+
+/**
+ * @brief Gets the reason open() failed, or the write error that made the log fail
+ */
+const std::string& MoveLog::error() const {
+    return error_;
+}
+
+/**
+ * @brief Gets whether a write or sync has failed. Nothing is made durable after that.
+ */
+bool MoveLog::failed() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return failed_;
+}
+
+/**
+ * @brief Gets the log sequence number of the last record appended
+ */
+uint64_t MoveLog::lastLsn() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return appended_;
+}
+
+/**
+ * @brief Appends a record, with the starting position of a CREATE
+ * @return The record's log sequence number, for whenDurable() / waitDurable().
+ */
+uint64_t MoveLog::append(const Type& type, const uint64_t& game, const uint64_t& sequence,
+                         const MoveGenerator::MoveWord& move, const Position* start) {
+    Record record{};
+    record.type = type;
+    record.move = move;
+    record.game = game;
+    record.sequence = sequence;
+    char position[Position::ENCODED_SIZE];
+    if (start) { start->encode(position); }
+    record.checksum = checksum(reinterpret_cast<const char*>(&record) + 4, sizeof(record) - 4);
+    if (start) { record.checksum = checksum(position, sizeof(position), record.checksum); }
+
+    uint64_t lsn;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        appended_ += sizeof(record) + (start ? sizeof(position) : 0);
+        lsn = appended_;
+        // A failed log writes nothing more: the record gets an LSN that never becomes durable
+        if (failed_) { return lsn; }
+
+        const char* bytes = reinterpret_cast<const char*>(&record);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(record));
+        if (start) { buffer_.insert(buffer_.end(), position, position + sizeof(position)); }
+        records_++;
+    }
+    pending_.notify_one();
+    return lsn;
+}
+
+/**
+ * @brief Writes and syncs what has been appended so far
+ * @return The continuations that became ready, to run once no lock is held.
+ * @pre write_mutex_ is held.
+ */
+std::vector<std::function<void()>> MoveLog::commit() {
+    std::vector<char> batch;
+    uint64_t end;
+    bool failed;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        batch.swap(buffer_);
+        end = appended_;
+        failed = failed_;
+    }
+
+    if (!batch.empty() && !failed) {
+        if (writeAll(fd_, batch.data(), batch.size()) && ::fdatasync(fd_) == 0) {
+            segment_bytes_ += batch.size();
+        } else {
+            // None of the batch counts as written: cut off whatever part of it reached the
+            // file, so the segment ends with its last durable record rather than a torn one
+            const std::string reason = segmentPath(directory_, segment_) + ": " + std::strerror(errno);
+            if (::ftruncate(fd_, segment_bytes_) == 0) { ::lseek(fd_, segment_bytes_, SEEK_SET); }
+            failed = true;
+
+            std::lock_guard<std::mutex> guard(mutex_);
+            error_ = reason;
+            failed_ = true;
+        }
+    }
+
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (!batch.empty() && !failed) {
+            commits_++;
+            durable_ = end;
+        }
+        if (failed) {
+            // Nothing waiting will ever be durable
+            for (Continuation& entry : waiting_) {
+                ready.push_back([continuation = std::move(entry.second)]() { continuation(false); });
+            }
+            waiting_.clear();
+        } else {
+            auto first_waiting = std::stable_partition(waiting_.begin(), waiting_.end(),
+                                                       [end](const Continuation& entry) { return entry.first <= end; });
+            for (auto entry = waiting_.begin(); entry != first_waiting; ++entry) {
+                ready.push_back([continuation = std::move(entry->second)]() { continuation(true); });
+            }
+            waiting_.erase(waiting_.begin(), first_waiting);
+        }
+    }
+    durable_cv_.notify_all();
+    return ready;
+}
+
+/**
+ * @brief Commits in a loop until the log is closed
+ */
+void MoveLog::flush() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            pending_.wait(lock, [this]() { return stopping_ || !buffer_.empty(); });
+            if (stopping_ && buffer_.empty()) { return; }
+        }
+
+        std::vector<std::function<void()>> ready;
+        {
+            std::lock_guard<std::mutex> guard(write_mutex_);
+            ready = commit();
+        }
+        for (auto& continuation : ready) { continuation(); }
+    }
+}
+
+/**
+ * @brief Runs `continuation` once the record with log sequence number `lsn` is on disk,
+ *        with true, or once the log has failed before it got there, with false: right away
+ *        if that is already known, otherwise on the flusher thread
+ */
+void MoveLog::whenDurable(const uint64_t& lsn, std::function<void(bool durable)> continuation) {
+    bool durable;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        durable = (durable_ >= lsn);
+        if (!durable && !failed_) {
+            waiting_.emplace_back(lsn, std::move(continuation));
+            return;
+        }
+    }
+    continuation(durable);
+}
+
+/**
+ * @brief Waits until the record with log sequence number `lsn` is on disk
+ * @return False if the log failed before it got there.
+ */
+bool MoveLog::waitDurable(const uint64_t& lsn) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    durable_cv_.wait(lock, [this, lsn]() { return durable_ >= lsn || failed_; });
+    return durable_ >= lsn;
+}
+
+/**
+ * @brief Commits the current segment and starts the next one
+ * @param closed Set to the number of the segment that was closed.
+ * @return False if the log has failed, or if the next segment could not be opened (appends
+ *         then go on in the current one).
+ */
+bool MoveLog::rotate(uint64_t& closed) {
+    std::vector<std::function<void()>> ready;
+    bool opened = false;
+    {
+        std::lock_guard<std::mutex> guard(write_mutex_);
+        ready = commit();
+        closed = segment_;
+        if (!failed()) { opened = openSegment(segment_ + 1); }
+    }
+    for (auto& continuation : ready) { continuation(); }
+    return opened;
+}
+
+/**
+ * @brief Gets the number of bytes in the current segment
+ */
+uint64_t MoveLog::segmentBytes() {
+    std::lock_guard<std::mutex> guard(write_mutex_);
+    return segment_bytes_;
+}
+
+/**
+ * @brief Gets the number of records appended and of commits (fdatasync calls) so far
+ */
+std::pair<uint64_t, uint64_t> MoveLog::counts() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return {records_, commits_};
+}
+
+/**
+ * @brief Reads the records of one segment, up to the first torn or corrupt one
+ * @return The number of records read.
+ */
+size_t MoveLog::readSegment(const std::string& path, const Reader& reader) {
+    std::ifstream in(path, std::ios::binary);
+    char header[8];
+    if (!in.read(header, sizeof(header)) || std::memcmp(header, SEGMENT_MAGIC, 4) != 0) { return 0; }
+    uint32_t version;
+    std::memcpy(&version, header + 4, 4);
+    if (version != VERSION) { return 0; }
+
+    // One read for the whole segment, then records are decoded from memory
+    std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t offset = 0;
+    size_t count = 0;
+    while (offset + sizeof(Record) <= data.size()) {
+        Record record;
+        std::memcpy(&record, data.data() + offset, sizeof(record));
+        const bool has_start = (record.type == Type::CREATE);
+        const size_t size = sizeof(record) + (has_start ? Position::ENCODED_SIZE : 0);
+        if (offset + size > data.size()) { break; }
+
+        uint32_t sum = checksum(data.data() + offset + 4, sizeof(record) - 4);
+        if (has_start) { sum = checksum(data.data() + offset + sizeof(record), Position::ENCODED_SIZE, sum); }
+        if (sum != record.checksum || record.type < Type::CREATE || record.type > Type::END) { break; }
+
+        Position start;
+        if (has_start && !start.decode(data.data() + offset + sizeof(record))) { break; }
+        reader(record, has_start ? &start : nullptr);
+        offset += size;
+        count++;
+    }
+    return count;
+}
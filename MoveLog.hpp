@@ -0,0 +1,196 @@
+/**
+ * @class MoveLog
+ * @brief A write-ahead log of the games hosted by a GameManager, with group commit.
+ *
+ * Every change to a game is appended as a fixed size record: a game id, a sequence
+ * number (the game's ply count after the change), a packed move word and a checksum; a
+ * created game's record is followed by its starting Position, as Position::encode()
+ * writes it. Appends only copy the record into a buffer. A flusher thread writes
+ * whatever has accumulated with one write and one fdatasync, so while one commit is on
+ * its way to the disk, the records of every game pile up for the next: the more games,
+ * the more records each fsync covers.
+ * whenDurable() runs a continuation once a record is on disk, which is when a move may
+ * be acknowledged.
+ *
+ * A failed write or sync is sticky: the part of the batch that reached the file is cut
+ * off again, the records waiting for it and every record appended after it are reported
+ * as not durable, and nothing more is written. The segments then still end with the last
+ * durable record, so GameManager::recover() reads all of them.
+ *
+ * The log is a series of segment files "moves.<n>.log" in one directory. rotate() closes
+ * the current segment and opens the next, so a checkpoint can snapshot the games and
+ * then delete the segments the snapshot covers (see GameManager::checkpoint()). Reading
+ * a segment stops at the first torn or corrupt record.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "MoveGenerator.hpp"
+#include "Position.hpp"
+
+class MoveLog {
+    public:
+        enum class Type : uint8_t { CREATE = 1, MOVE = 2, END = 3 };
+
+        struct Record {
+            uint32_t checksum;  // Of the rest of the record, and of the Position that follows a CREATE
+            Type type;
+            uint8_t reserved;
+            MoveGenerator::MoveWord move;
+            uint64_t game;
+            uint64_t sequence;  // The game's ply count once the record is applied
+        };
+
+        // Receives every record read back, with the starting position of a CREATE (nullptr otherwise)
+        using Reader = std::function<void(const Record& record, const Position* start)>;
+
+        // The version written in segment and snapshot headers. Version 2 encodes positions
+        // with Position::encode(), and snapshot fields little-endian.
+        static const uint32_t VERSION = 2;
+
+    private:
+        std::string directory_;
+        std::string error_;
+        int fd_;
+        uint64_t segment_;        // Number of the segment being written
+        uint64_t segment_bytes_;  // Bytes written to it (committed or not)
+
+        std::mutex mutex_;        // Guards everything below, up to write_mutex_
+        std::condition_variable pending_;
+        std::condition_variable durable_cv_;
+        using Continuation = std::pair<uint64_t, std::function<void(bool durable)>>;
+
+        std::vector<char> buffer_;      // Appended, not yet handed to the flusher
+        uint64_t appended_;             // Log sequence number: bytes appended since open()
+        uint64_t durable_;              // Bytes known to be on disk
+        std::vector<Continuation> waiting_; // Continuations by LSN
+        uint64_t records_;
+        uint64_t commits_;
+        bool failed_;                   // A write or sync failed; nothing is written after it
+        bool stopping_;
+
+        std::mutex write_mutex_;  // Held by whoever writes to fd_ (the flusher, rotate())
+        std::thread flusher_;
+
+        /**
+         * @brief Writes and syncs what has been appended so far
+         * @return The continuations that became ready, to run once no lock is held.
+         * @pre write_mutex_ is held.
+         */
+        std::vector<std::function<void()>> commit();
+
+        /**
+         * @brief Commits in a loop until the log is closed
+         */
+        void flush();
+
+        /**
+         * @brief Opens segment `segment` for appending, writing its header
+         */
+        bool openSegment(const uint64_t& segment);
+
+    public:
+        MoveLog();
+
+        /**
+         * @brief Commits what is left and closes the log
+         */
+        ~MoveLog();
+
+        MoveLog(const MoveLog& other) = delete;
+        MoveLog& operator=(const MoveLog& other) = delete;
+
+        /**
+         * @brief Opens a log in `directory` (which must exist), starting a segment after the last one there
+         * @return True on success. Otherwise error() says why.
+         */
+        bool open(const std::string& directory);
+
+        /**
+         * @brief Gets the directory of the log
+         */
+        const std::string& directory() const;
+
+        /**
+         * @brief Gets the reason open() failed, or the write error that made the log fail
+         */
+        const std::string& error() const;
+
+        /**
+         * @brief Gets whether a write or sync has failed. Nothing is made durable after that.
+         */
+        bool failed();
+
+        /**
+         * @brief Gets the log sequence number of the last record appended
+         */
+        uint64_t lastLsn();
+
+        /**
+         * @brief Appends a record, with the starting position of a CREATE
+         * @return The record's log sequence number, for whenDurable() / waitDurable().
+         */
+        uint64_t append(const Type& type, const uint64_t& game, const uint64_t& sequence,
+                        const MoveGenerator::MoveWord& move = 0, const Position* start = nullptr);
+
+        /**
+         * @brief Runs `continuation` once the record with log sequence number `lsn` is on disk,
+         *        with true, or once the log has failed before it got there, with false: right away
+         *        if that is already known, otherwise on the flusher thread
+         */
+        void whenDurable(const uint64_t& lsn, std::function<void(bool durable)> continuation);
+
+        /**
+         * @brief Waits until the record with log sequence number `lsn` is on disk
+         * @return False if the log failed before it got there.
+         */
+        bool waitDurable(const uint64_t& lsn);
+
+        /**
+         * @brief Commits the current segment and starts the next one
+         * @param closed Set to the number of the segment that was closed.
+         * @return False if the log has failed, or if the next segment could not be opened (appends
+         *         then go on in the current one).
+         */
+        bool rotate(uint64_t& closed);
+
+        /**
+         * @brief Gets the number of bytes in the current segment
+         */
+        uint64_t segmentBytes();
+
+        /**
+         * @brief Gets the number of records appended and of commits (fdatasync calls) so far
+         */
+        std::pair<uint64_t, uint64_t> counts();
+
+        /**
+         * @brief Gets the path of segment `segment` in `directory`
+         */
+        static std::string segmentPath(const std::string& directory, const uint64_t& segment);
+
+        /**
+         * @brief Lists the numbers of the segments in `directory`, in increasing order
+         */
+        static std::vector<uint64_t> listSegments(const std::string& directory);
+
+        /**
+         * @brief Reads the records of one segment, up to the first torn or corrupt one
+         * @return The number of records read.
+         */
+        static size_t readSegment(const std::string& path, const Reader& reader);
+
+        /**
+         * @brief Computes the checksum of `size` bytes (FNV-1a), continuing from `hash`
+         */
+        static uint32_t checksum(const void* data, const size_t& size, uint32_t hash = 2166136261u);
+};
@@ -0,0 +1,174 @@
+#include "MoveValidator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+
+#include "AllocationTracker.hpp"
+
+namespace {
+    const char* statusName(const MoveValidator::Status& status) {
+        switch (status) {
+            case MoveValidator::Status::CHECK: return "check";
+            case MoveValidator::Status::CHECKMATE: return "checkmate";
+            case MoveValidator::Status::STALEMATE: return "stalemate";
+            default: return "active";
+        }
+    }
+}
+
+/**
+ * @brief Constructs a validator with `threads` worker threads
+ */
+MoveValidator::MoveValidator(const int& threads) : stopping_{false} {
+    for (int i = 0; i < std::max(1, threads); i++) {
+        workers_.emplace_back([this]() { work(); });
+    }
+}
+
+/**
+ * @brief Stops the workers. Batches still queued are dropped without a callback.
+ */
+MoveValidator::~MoveValidator() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) { worker.join(); }
+}
+
+/**
+ * @brief Runs the queued jobs until the validator is destroyed
+ */
+void MoveValidator::work() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            if (stopping_) { return; }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+
+/**
+ * @brief Runs `chunk(begin, end)` over [0, count) in chunks on the workers, then calls `done`
+ *        (on the worker that finishes last)
+ */
+void MoveValidator::forEachChunk(const size_t& count, std::function<void(size_t, size_t)> chunk, std::function<void()> done) {
+    if (count == 0) {
+        done();
+        return;
+    }
+
+    const size_t chunks = (count + CHUNK - 1) / CHUNK;
+    auto remaining = std::make_shared<std::atomic<size_t>>(chunks);
+    auto shared_chunk = std::make_shared<std::function<void(size_t, size_t)>>(std::move(chunk));
+    auto shared_done = std::make_shared<std::function<void()>>(std::move(done));
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        for (size_t begin = 0; begin < count; begin += CHUNK) {
+            const size_t end = (count - begin > CHUNK) ? begin + CHUNK : count;
+            jobs_.push_back([=]() {
+                (*shared_chunk)(begin, end);
+                if (--*remaining == 0) { (*shared_done)(); }
+            });
+        }
+    }
+    wake_.notify_all();
+}
+
+/**
+ * @brief Validates one request on the calling thread
+ */
+MoveValidator::Result MoveValidator::validate(const Request& request) {
+    NO_ALLOC_SCOPE("validate_move");
+
+    Result result;
+    if (!MoveGenerator::isLegal(request.position, request.move)) { return result; }
+
+    result.legal = true;
+    result.position = request.position;
+    MoveGenerator::apply(result.position, request.move);
+    result.hash = result.position.hash;
+
+    MoveGenerator::MoveList replies;
+    const bool check = MoveGenerator::isInCheck(result.position);
+    if (MoveGenerator::generate(result.position, replies) == 0) {
+        result.status = check ? Status::CHECKMATE : Status::STALEMATE;
+    } else {
+        result.status = check ? Status::CHECK : Status::ACTIVE;
+    }
+    return result;
+}
+
+/**
+ * @brief Answers one request in its text form, on the calling thread
+ */
+std::string MoveValidator::validateLine(const std::string& line) {
+    // The move is the last field, the FEN everything before it
+    const size_t end = line.find_last_not_of(" \t\r");
+    const size_t split = (end == std::string::npos) ? std::string::npos : line.find_last_of(" \t", end);
+    if (split == std::string::npos) { return "invalid expected a FEN and a move"; }
+
+    Request request;
+    if (!MoveGenerator::parseFEN(line.substr(0, split), request.position)) { return "invalid FEN"; }
+    if (!MoveGenerator::parseUCI(line.substr(split + 1, end - split), request.move)) { return "invalid move"; }
+
+    const Result result = validate(request);
+    if (!result.legal) { return "illegal"; }
+
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(result.hash));
+    return std::string("legal ") + hash + " " + statusName(result.status) + " " + MoveGenerator::toFEN(result.position);
+}
+
+/**
+ * @brief Validates a batch on the workers and waits for it
+ * @param results Resized to the number of requests, and filled in their order.
+ */
+void MoveValidator::validate(const std::vector<Request>& requests, std::vector<Result>& results) {
+    results.resize(requests.size());
+
+    std::mutex finished_mutex;
+    std::condition_variable finished_cv;
+    bool finished = false;
+    forEachChunk(requests.size(),
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) { results[i] = validate(requests[i]); }
+        },
+        [&]() {
+            std::lock_guard<std::mutex> guard(finished_mutex);
+            finished = true;
+            finished_cv.notify_one();
+        });
+
+    std::unique_lock<std::mutex> lock(finished_mutex);
+    finished_cv.wait(lock, [&]() { return finished; });
+}
+
+/**
+ * @brief Answers a batch of text requests on the workers, then passes the replies to
+ *        `callback` (from a worker thread, without any lock held)
+ */
+void MoveValidator::submitLines(std::vector<std::string> lines, const LinesCallback& callback) {
+    // The lines are answered in place, so the batch owns a single vector throughout
+    auto batch = std::make_shared<std::vector<std::string>>(std::move(lines));
+    forEachChunk(batch->size(),
+        [batch](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) { (*batch)[i] = validateLine((*batch)[i]); }
+        },
+        [batch, callback]() { callback(*batch); });
+}
+
+/**
+ * @brief Gets the number of worker threads
+ */
+int MoveValidator::threadCount() const {
+    return static_cast<int>(workers_.size());
+}
@@ -0,0 +1,110 @@
+/**
+ * @class MoveValidator
+ * @brief Answers "is this move legal in this position, and what does it lead to" for
+ *        batches of independent requests, in parallel.
+ *
+ * A request is a Position and a packed move, so validating one builds nothing on the
+ * heap: the legality test uses MoveGenerator's check and pin masks and the resulting
+ * position is a copy on the stack. A batch is cut into chunks that the worker threads
+ * (started once, with the validator) take from a shared queue.
+ *
+ * The text form of a request is a line "<fen> <uci move>", answered by
+ * "legal <hash> <active|check|checkmate|stalemate> <fen after the move>", "illegal" or
+ * "invalid <reason>"; the hash is the resulting position's, in hexadecimal.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MoveGenerator.hpp"
+#include "Position.hpp"
+
+class MoveValidator {
+    public:
+        struct Request {
+            Position position;
+            MoveGenerator::MoveWord move;
+        };
+
+        enum class Status : uint8_t { ACTIVE, CHECK, CHECKMATE, STALEMATE };
+
+        struct Result {
+            bool legal = false;
+            Status status = Status::ACTIVE; // Of the resulting position, if the move is legal
+            uint64_t hash = 0;              // Of the resulting position, if the move is legal
+            Position position{};            // The resulting position, if the move is legal
+        };
+
+        // Receives the replies to a batch of lines, in the order of the lines
+        using LinesCallback = std::function<void(std::vector<std::string>& replies)>;
+
+    private:
+        // Requests per job: enough to outweigh taking it from the queue
+        static const size_t CHUNK = 64;
+
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::deque<std::function<void()>> jobs_;
+        bool stopping_;
+
+        /**
+         * @brief Runs the queued jobs until the validator is destroyed
+         */
+        void work();
+
+        /**
+         * @brief Runs `chunk(begin, end)` over [0, count) in chunks on the workers, then calls `done`
+         *        (on the worker that finishes last)
+         */
+        void forEachChunk(const size_t& count, std::function<void(size_t, size_t)> chunk, std::function<void()> done);
+
+    public:
+        /**
+         * @brief Constructs a validator with `threads` worker threads
+         */
+        explicit MoveValidator(const int& threads);
+
+        /**
+         * @brief Stops the workers. Batches still queued are dropped without a callback.
+         */
+        ~MoveValidator();
+
+        MoveValidator(const MoveValidator& other) = delete;
+        MoveValidator& operator=(const MoveValidator& other) = delete;
+
+        /**
+         * @brief Validates one request on the calling thread
+         */
+        static Result validate(const Request& request);
+
+        /**
+         * @brief Answers one request in its text form, on the calling thread
+         */
+        static std::string validateLine(const std::string& line);
+
+        /**
+         * @brief Validates a batch on the workers and waits for it
+         * @param results Resized to the number of requests, and filled in their order.
+         */
+        void validate(const std::vector<Request>& requests, std::vector<Result>& results);
+
+        /**
+         * @brief Answers a batch of text requests on the workers, then passes the replies to
+         *        `callback` (from a worker thread, without any lock held)
+         */
+        void submitLines(std::vector<std::string> lines, const LinesCallback& callback);
+
+        /**
+         * @brief Gets the number of worker threads
+         */
+        int threadCount() const;
+};
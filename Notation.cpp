@@ -0,0 +1,107 @@
+#include "Notation.hpp"
+
+namespace {
+    /*
+    SAN letters of PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING (indexed like ChessBoard::pieceKind() % 6).
+    */
+    const char PIECE_LETTERS[6] = {'\0', 'N', 'B', 'R', 'Q', 'K'};
+
+    char fileOf(const Square& square) { return static_cast<char>('a' + square.second); }
+    char rankOf(const Square& square) { return static_cast<char>('1' + square.first); }
+}
+
+/**
+ * Writes `move` in standard algebraic notation.
+ *
+ * @param board The position the move is played from (left unchanged).
+ * @param move A legal move in that position.
+ * @param legal All legal moves in that position, used for disambiguation.
+ * @return The SAN of the move, including a "+" or "#" suffix for checks and mates.
+ */
+std::string Notation::toSAN(ChessBoard& board, const Move& move, const std::vector<Move>& legal) {
+    const Square from = move.getOriginalPosition();
+    const Square to = move.getTargetPosition();
+    const int type = board.pieceKind(board.getCell(from.first, from.second)) % 6;
+    const bool capture = board.getCell(to.first, to.second) != nullptr;
+
+    std::string san;
+    if (type == 0) {
+        if (capture) { san += fileOf(from); }
+    } else {
+        san += PIECE_LETTERS[type];
+
+        // Disambiguate from other pieces of the same type that can reach the same square
+        bool ambiguous = false, same_file = false, same_rank = false;
+        for (const Move& other : legal) {
+            Square other_from = other.getOriginalPosition();
+            if (other_from == from || other.getTargetPosition() != to) { continue; }
+            if (board.pieceKind(board.getCell(other_from.first, other_from.second)) % 6 != type) { continue; }
+            ambiguous = true;
+            same_file |= other_from.second == from.second;
+            same_rank |= other_from.first == from.first;
+        }
+        if (ambiguous && (!same_file || same_rank)) { san += fileOf(from); }
+        if (ambiguous && same_file) { san += rankOf(from); }
+    }
+
+    if (capture) { san += 'x'; }
+    san += fileOf(to);
+    san += rankOf(to);
+
+    board.makeMove(move);
+    if (board.isInCheck()) { san += board.generateMoves().empty() ? '#' : '+'; }
+    board.unmakeMove();
+
+    return san;
+}
+
+/**
+ * Finds the move written as `text` among `legal`, in either coordinate notation or SAN.
+ * Check, mate and annotation suffixes ("+", "#", "!", "?") are ignored.
+ *
+ * @param board The position the moves are played from.
+ * @param legal All legal moves in that position.
+ * @return The index of the move in `legal`, or -1 if `text` does not name exactly one of them.
+ */
+int Notation::findMove(const ChessBoard& board, const std::vector<Move>& legal, const std::string& text) {
+    std::string san;
+    for (char symbol : text) {
+        if (symbol != '+' && symbol != '#' && symbol != '!' && symbol != '?' && symbol != 'x') { san += symbol; }
+    }
+
+    // Coordinate notation
+    for (size_t i = 0; i < legal.size(); i++) {
+        if (legal[i].toUCI() == san) { return static_cast<int>(i); }
+    }
+
+    if (san.size() < 2) { return -1; }
+
+    // SAN: [piece letter] [from file] [from rank] <to file> <to rank>
+    int type = 0;
+    size_t start = 0;
+    for (int kind = 1; kind < 6; kind++) {
+        if (san[0] == PIECE_LETTERS[kind]) { type = kind; start = 1; }
+    }
+
+    const std::string target = san.substr(san.size() - 2);
+    const std::string hints = san.substr(start, san.size() - 2 - start);
+
+    int found = -1;
+    for (size_t i = 0; i < legal.size(); i++) {
+        const Square from = legal[i].getOriginalPosition();
+        const Square to = legal[i].getTargetPosition();
+        if (fileOf(to) != target[0] || rankOf(to) != target[1]) { continue; }
+        if (board.pieceKind(board.getCell(from.first, from.second)) % 6 != type) { continue; }
+
+        bool matches = true;
+        for (char hint : hints) {
+            if (hint >= 'a' && hint <= 'h' && hint != fileOf(from)) { matches = false; }
+            if (hint >= '1' && hint <= '8' && hint != rankOf(from)) { matches = false; }
+        }
+        if (!matches) { continue; }
+
+        if (found >= 0) { return -1; } // Ambiguous
+        found = static_cast<int>(i);
+    }
+    return found;
+}
@@ -0,0 +1,39 @@
+/**
+ * @brief Reading and writing moves in text form.
+ *
+ * Two notations are supported:
+ * 1) Coordinate notation, as used by UCI: "d2d4" (see Move::toUCI())
+ * 2) Standard algebraic notation (SAN), as used by PGN: "Nf3", "exd5", "Qxe7+", "Rad1#"
+ *
+ * Columns are files ('a' for column 0) and rows are ranks ('1' for row 0).
+ * There is no castling, en passant or promotion on this board, so neither is there in its SAN.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ChessBoard.hpp"
+
+namespace Notation {
+    /**
+     * Writes `move` in standard algebraic notation.
+     *
+     * @param board The position the move is played from (left unchanged).
+     * @param move A legal move in that position.
+     * @param legal All legal moves in that position, used for disambiguation.
+     * @return The SAN of the move, including a "+" or "#" suffix for checks and mates.
+     */
+    std::string toSAN(ChessBoard& board, const Move& move, const std::vector<Move>& legal);
+
+    /**
+     * Finds the move written as `text` among `legal`, in either coordinate notation or SAN.
+     * Check, mate and annotation suffixes ("+", "#", "!", "?") are ignored.
+     *
+     * @param board The position the moves are played from.
+     * @param legal All legal moves in that position.
+     * @return The index of the move in `legal`, or -1 if `text` does not name exactly one of them.
+     */
+    int findMove(const ChessBoard& board, const std::vector<Move>& legal, const std::string& text);
+};
@@ -0,0 +1,167 @@
+#include "PerfCounters.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef __linux__
+    /*
+    A hardware event to count: its name, perf type and config.
+    */
+    struct Event {
+        const char* name;
+        uint32_t type;
+        uint64_t config;
+    };
+
+    const uint64_t L1D_READ_MISS = PERF_COUNT_HW_CACHE_L1D
+                                 | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                 | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    const Event EVENTS[] = {
+        {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {"L1d-read-misses", PERF_TYPE_HW_CACHE, L1D_READ_MISS},
+        {"LLC-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}
+    };
+
+    /*
+    The layout read() returns for PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING.
+    */
+    struct Reading {
+        uint64_t value;
+        uint64_t time_enabled;
+        uint64_t time_running;
+    };
+#endif
+}
+
+/**
+ * @brief Closes the counters
+ */
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (const Counter& counter : counters_) { close(counter.fd); }
+#endif
+}
+
+/**
+ * @brief Opens every supported counter, disabled
+ * @return True if at least one counter could be opened. Otherwise error() says why.
+ */
+bool PerfCounters::open() {
+#ifdef __linux__
+    for (const Event& event : EVENTS) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = event.type;
+        attr.config = event.config;
+        attr.disabled = 1;
+        attr.inherit = 1;          // Also count the threads started from now on
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd < 0) {
+            if (error_.empty()) { error_ = std::string(event.name) + ": " + std::strerror(errno); }
+            continue;
+        }
+
+        Counter counter;
+        counter.name = event.name;
+        counter.fd = fd;
+        counters_.push_back(counter);
+    }
+
+    if (counters_.empty() && (errno == EACCES || errno == EPERM)) {
+        error_ += " (perf_event_paranoid must be 2 or below, or the process needs CAP_PERFMON)";
+    } else if (counters_.empty() && (errno == ENOENT || errno == ENODEV || errno == EOPNOTSUPP)) {
+        error_ += " (the CPU, or the virtual machine, exposes no hardware counters)";
+    }
+    return !counters_.empty();
+#else
+    error_ = "perf_event_open is only available on Linux";
+    return false;
+#endif
+}
+
+/**
+ * @brief Gets the reason open() failed
+ */
+const std::string& PerfCounters::error() const {
+    return error_;
+}
+
+/**
+ * @brief Resets and enables the counters
+ */
+void PerfCounters::start() {
+#ifdef __linux__
+    for (const Counter& counter : counters_) {
+        ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/**
+ * @brief Disables the counters and reads their values
+ */
+void PerfCounters::stop() {
+#ifdef __linux__
+    for (Counter& counter : counters_) {
+        ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+
+        // A counter that was multiplexed only ran part of the time, so its count is extrapolated
+        Reading reading;
+        if (read(counter.fd, &reading, sizeof(reading)) != static_cast<ssize_t>(sizeof(reading))) {
+            counter.value = 0;
+        } else if (reading.time_running && reading.time_running < reading.time_enabled) {
+            counter.value = static_cast<uint64_t>(static_cast<double>(reading.value) * reading.time_enabled / reading.time_running);
+        } else {
+            counter.value = reading.value;
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Gets the counters opened, with the values read by the last stop()
+ */
+const std::vector<PerfCounters::Counter>& PerfCounters::counters() const {
+    return counters_;
+}
+
+/**
+ * @brief Writes every counter, its value per node and the instructions per cycle to `out`
+ * @param nodes The number of nodes (perft leaves or search nodes) the work consisted of
+ */
+void PerfCounters::report(std::ostream& out, const uint64_t& nodes) const {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+
+    out << "Hardware counters over " << nodes << " nodes:" << std::endl;
+    for (const Counter& counter : counters_) {
+        double per_node = nodes ? static_cast<double>(counter.value) / nodes : 0.0;
+        out << "  " << std::left << std::setw(18) << counter.name << std::right << std::setw(16) << counter.value
+            << std::fixed << std::setprecision(2) << std::setw(14) << per_node << " / node" << std::defaultfloat << std::endl;
+
+        if (counter.name == "cycles") { cycles = counter.value; }
+        if (counter.name == "instructions") { instructions = counter.value; }
+    }
+    if (cycles && instructions) {
+        out << "  IPC " << std::fixed << std::setprecision(2) << static_cast<double>(instructions) / cycles
+            << std::defaultfloat << std::endl;
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * @class PerfCounters
+ * @brief Hardware performance counters of the running process, read through Linux perf_event_open.
+ *
+ * Counts CPU cycles, instructions, branch misses, L1 data cache read misses and
+ * last-level cache misses in user space, for the calling thread and every thread it
+ * starts after open(), so multi-threaded searches are counted in full. Counters the
+ * CPU (or a virtual machine) does not provide are left out, and counts are scaled
+ * up when the kernel had to multiplex them.
+ *
+ * No `perf` tool is needed, but the kernel must allow it: perf_event_paranoid at
+ * 2 or below, or CAP_PERFMON. Elsewhere than Linux open() always fails.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class PerfCounters {
+    public:
+        /**
+         * One hardware event and its count over the last start() / stop() interval.
+         */
+        struct Counter {
+            std::string name;
+            int fd = -1;
+            uint64_t value = 0;
+        };
+
+    private:
+        std::vector<Counter> counters_;
+        std::string error_;
+
+    public:
+        PerfCounters() = default;
+
+        /**
+         * @brief Counters own file descriptors, so they can not be copied
+         */
+        PerfCounters(const PerfCounters& other) = delete;
+        PerfCounters& operator=(const PerfCounters& other) = delete;
+
+        /**
+         * @brief Closes the counters
+         */
+        ~PerfCounters();
+
+        /**
+         * @brief Opens every supported counter, disabled
+         * @return True if at least one counter could be opened. Otherwise error() says why.
+         */
+        bool open();
+
+        /**
+         * @brief Gets the reason open() failed
+         */
+        const std::string& error() const;
+
+        /**
+         * @brief Resets and enables the counters
+         */
+        void start();
+
+        /**
+         * @brief Disables the counters and reads their values
+         */
+        void stop();
+
+        /**
+         * @brief Gets the counters opened, with the values read by the last stop()
+         */
+        const std::vector<Counter>& counters() const;
+
+        /**
+         * @brief Writes every counter, its value per node and the instructions per cycle to `out`
+         * @param nodes The number of nodes (perft leaves or search nodes) the work consisted of
+         */
+        void report(std::ostream& out, const uint64_t& nodes) const;
+};
@@ -0,0 +1,45 @@
+#include "Position.hpp"
+
+#include "Zobrist.hpp"
+
+/**
+ * @brief Writes the squares, the moved flags (little-endian) and the side to move (0 or 1)
+ *        to `out`, ENCODED_SIZE bytes. The hash is left out: decode() recomputes it.
+ */
+void Position::encode(char* out) const {
+    std::memcpy(out, squares, sizeof(squares));
+    for (int i = 0; i < 8; i++) { out[64 + i] = static_cast<char>(moved >> (8 * i)); }
+    out[72] = player_one_turn ? 1 : 0;
+}
+
+/**
+ * @brief Reads a position written by encode() from `in`, and recomputes its hash
+ * @return False if a square holds no valid kind or the side to move is not 0 or 1.
+ *         The position is then left unchanged.
+ */
+bool Position::decode(const char* in) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(in);
+    for (int square = 0; square < 64; square++) {
+        if (bytes[square] > EMPTY) { return false; }
+    }
+    if (bytes[72] > 1) { return false; }
+
+    std::memcpy(squares, bytes, sizeof(squares));
+    moved = 0;
+    for (int i = 0; i < 8; i++) { moved |= static_cast<uint64_t>(bytes[64 + i]) << (8 * i); }
+    player_one_turn = (bytes[72] == 1);
+    hash = computeHash();
+    return true;
+}
+
+/**
+ * @brief Computes the Zobrist hash of the pieces and the side to move
+ */
+uint64_t Position::computeHash() const {
+    uint64_t result = player_one_turn ? 0 : Zobrist::sideKey();
+    for (int square = 0; square < 64; square++) {
+        if (squares[square] == EMPTY) { continue; }
+        result ^= Zobrist::pieceKey(squares[square], square / 8, square % 8);
+    }
+    return result;
+}
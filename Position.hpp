@@ -0,0 +1,89 @@
+/**
+ * @struct Position
+ * @brief A position as a plain value: what is on every square, which pieces have moved,
+ *        the side to move and the hash.
+ *
+ * A Position holds no pointer at all: it is trivially copyable (a memcpy of under 100
+ * bytes), can be compared, stored in arrays or written to disk as is, and read from
+ * any thread.
+ *
+ * A ChessBoard wraps one: it keeps its Position up to date with every move and undo,
+ * next to the heap allocated pieces the move generation works on, so getPosition() is
+ * a plain copy. setPosition() copies a Position back in and re-seats the pieces the
+ * board already owns, so a board kept around (as each search thread's is) takes on
+ * another position without allocating. Only a board new to the pieces, such as one
+ * from the copy constructor, allocates them.
+ *
+ * Squares use the board's coordinates (index row * 8 + col) and hold the pieceKind()
+ * of their piece: 0-5 for Player One's PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING and
+ * 6-11 for Player Two's, or EMPTY.
+ *
+ * The struct's own bytes (padding included) depend on the compiler, so anything that
+ * leaves the process (snapshots, logs) goes through encode() and decode() instead: the
+ * fields one by one, little-endian, in ENCODED_SIZE bytes.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+struct Position {
+    static const uint8_t EMPTY = 12;
+
+    // The size of encode()'s output: the squares, the moved flags and the side to move
+    static const size_t ENCODED_SIZE = 64 + 8 + 1;
+
+    uint8_t squares[64];   // The kind of the piece on each square, or EMPTY
+    uint64_t moved;        // Bit (row * 8 + col) is set if the piece on that square has moved
+    uint64_t hash;         // The Zobrist hash, as ChessBoard::getHash()
+    bool player_one_turn;
+
+    /**
+     * @brief Gets the kind of the piece on (row, col), or EMPTY
+     */
+    uint8_t at(const int& row, const int& col) const {
+        return squares[row * 8 + col];
+    }
+
+    /**
+     * @brief Determines whether the piece on (row, col) has moved
+     */
+    bool hasMoved(const int& row, const int& col) const {
+        return (moved >> (row * 8 + col)) & 1;
+    }
+
+    /**
+     * @brief Determines whether both positions have the same pieces, moved flags and side to move
+     */
+    bool operator==(const Position& other) const {
+        return std::memcmp(squares, other.squares, sizeof(squares)) == 0 && moved == other.moved
+            && hash == other.hash && player_one_turn == other.player_one_turn;
+    }
+
+    bool operator!=(const Position& other) const {
+        return !(*this == other);
+    }
+
+    /**
+     * @brief Writes the squares, the moved flags (little-endian) and the side to move (0 or 1)
+     *        to `out`, ENCODED_SIZE bytes. The hash is left out: decode() recomputes it.
+     */
+    void encode(char* out) const;
+
+    /**
+     * @brief Reads a position written by encode() from `in`, and recomputes its hash
+     * @return False if a square holds no valid kind or the side to move is not 0 or 1.
+     *         The position is then left unchanged.
+     */
+    bool decode(const char* in);
+
+    /**
+     * @brief Computes the Zobrist hash of the pieces and the side to move
+     */
+    uint64_t computeHash() const;
+};
+
+static_assert(std::is_trivially_copyable<Position>::value, "Position must stay copyable with memcpy");
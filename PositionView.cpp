@@ -0,0 +1,63 @@
+#include "PositionView.hpp"
+
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<Position>::value, "A Position must be copyable word by word");
+
+PositionView::PositionView() : sequence_{0} {
+    for (auto& word : words_) { word.store(0, std::memory_order_relaxed); }
+}
+
+/**
+ * @brief Publishes `position` after `plies` moves. Never blocks.
+ * @pre No other thread publishes to this view at the same time.
+ */
+void PositionView::publish(const Position& position, const uint32_t& plies) {
+    uint64_t words[WORDS] = {};
+    std::memcpy(words, &position, sizeof(position));
+    words[WORDS - 1] = plies;
+
+    // Odd while the words are being stored. The release fence keeps the stores below from
+    // being seen before the odd sequence number.
+    const uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < WORDS; i++) { words_[i].store(words[i], std::memory_order_relaxed); }
+    sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Copies the last published position, retrying while a publish is in progress
+ */
+PositionView::Snapshot PositionView::read() const {
+    uint64_t words[WORDS];
+    uint64_t sequence;
+    while (true) {
+        sequence = sequence_.load(std::memory_order_acquire);
+        if (sequence & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (int i = 0; i < WORDS; i++) { words[i] = words_[i].load(std::memory_order_relaxed); }
+
+        // The acquire fence keeps the loads above from moving past the second sequence load
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == sequence) { break; }
+    }
+
+    Snapshot snapshot;
+    std::memcpy(&snapshot.position, words, sizeof(snapshot.position));
+    snapshot.plies = static_cast<uint32_t>(words[WORDS - 1]);
+    snapshot.version = sequence / 2;
+    return snapshot;
+}
+
+/**
+ * @brief Gets the number of publishes so far, so a reader can tell whether
+ *        its snapshot is still current without copying anything
+ */
+uint64_t PositionView::version() const {
+    return sequence_.load(std::memory_order_acquire) / 2;
+}
@@ -0,0 +1,63 @@
+/**
+ * @class PositionView
+ * @brief Lets any number of threads read a live game's position while the game's own
+ *        thread keeps playing, with no lock on either side.
+ *
+ * A seqlock: the game thread publishes a Position and the number of moves played by
+ * bumping a sequence number to odd, storing the words of the position and bumping it
+ * back to even. A reader copies the words between two loads of the sequence number and
+ * retries if a publish overlapped. Publishing never waits for readers and costs a dozen
+ * stores, so the game's move path is not slowed down by however many readers there are;
+ * a reader only ever retries while a publish is in progress.
+ *
+ * There must be one publishing thread per view at a time.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "Position.hpp"
+
+class PositionView {
+    public:
+        /**
+         * A consistent copy of what was published, owned by the reader.
+         */
+        struct Snapshot {
+            Position position{};
+            uint32_t plies = 0;   // The number of moves played in the game
+            uint64_t version = 0; // The number of publishes so far; 0 if nothing was published
+        };
+
+    private:
+        // The position and the ply count, stored as words so every access is atomic
+        static const int WORDS = (sizeof(Position) + sizeof(uint64_t) - 1) / sizeof(uint64_t) + 1;
+
+        alignas(64) std::atomic<uint64_t> sequence_;
+        std::atomic<uint64_t> words_[WORDS];
+
+    public:
+        PositionView();
+
+        PositionView(const PositionView& other) = delete;
+        PositionView& operator=(const PositionView& other) = delete;
+
+        /**
+         * @brief Publishes `position` after `plies` moves. Never blocks.
+         * @pre No other thread publishes to this view at the same time.
+         */
+        void publish(const Position& position, const uint32_t& plies);
+
+        /**
+         * @brief Copies the last published position, retrying while a publish is in progress
+         */
+        Snapshot read() const;
+
+        /**
+         * @brief Gets the number of publishes so far, so a reader can tell whether
+         *        its snapshot is still current without copying anything
+         */
+        uint64_t version() const;
+};
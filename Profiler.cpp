@@ -0,0 +1,198 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+    /*
+    The ring buffer of one thread. Only its thread writes to it.
+    */
+    struct ThreadBuffer {
+        int thread_id = 0;
+        std::vector<Profiler::Event> events;
+        size_t next = 0;      // Where the next zone is written
+        bool wrapped = false; // Whether the oldest zones were overwritten
+
+        /*
+        Gets the recorded zones, oldest first.
+        */
+        std::vector<Profiler::Event> ordered() const {
+            std::vector<Profiler::Event> result;
+            if (wrapped) { result.insert(result.end(), events.begin() + next, events.end()); }
+            result.insert(result.end(), events.begin(), events.begin() + next);
+            return result;
+        }
+    };
+
+    /*
+    Every buffer ever handed to a thread (kept after the thread ends, so its zones can still
+    be exported), the buffers of the threads that have ended, and the time stamp counter and
+    steady clock readings the trace clock started at.
+    */
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> registry;
+    std::vector<ThreadBuffer*> free_buffers;
+    uint64_t base_ticks = 0;
+    int64_t base_nanoseconds = 0;
+
+    int64_t steadyNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /*
+    Hands the calling thread the buffer of a thread that has ended, or a new one. A reused
+    buffer keeps the zones already in it: they all ended before this thread's first one
+    begins, so its track simply goes on with this thread.
+    */
+    ThreadBuffer* registerThread() {
+        {
+            std::lock_guard<std::mutex> guard(registry_mutex);
+            if (!free_buffers.empty()) {
+                ThreadBuffer* buffer = free_buffers.back();
+                free_buffers.pop_back();
+                return buffer;
+            }
+        }
+
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->events.resize(Profiler::RING_CAPACITY);
+
+        std::lock_guard<std::mutex> guard(registry_mutex);
+        if (registry.empty()) {
+            base_ticks = Profiler::now();
+            base_nanoseconds = steadyNanoseconds();
+        }
+        buffer->thread_id = static_cast<int>(registry.size()) + 1;
+        registry.push_back(std::move(buffer));
+        return registry.back().get();
+    }
+
+    /*
+    Holds a thread's buffer, and gives it back for another thread when the thread ends,
+    so threads started for every search iteration do not each add a ring.
+    */
+    struct BufferOwner {
+        ThreadBuffer* buffer = nullptr;
+
+        ~BufferOwner() {
+            if (!buffer) { return; }
+            std::lock_guard<std::mutex> guard(registry_mutex);
+            free_buffers.push_back(buffer);
+        }
+    };
+
+    /*
+    Gets the number of time stamp counter ticks per nanosecond, measured since the trace clock started.
+    */
+    double ticksPerNanosecond() {
+        int64_t nanoseconds = steadyNanoseconds() - base_nanoseconds;
+        uint64_t ticks = Profiler::now() - base_ticks;
+        return (nanoseconds > 0 && ticks > 0) ? static_cast<double>(ticks) / nanoseconds : 1.0;
+    }
+}
+
+/**
+ * Writes a finished zone to the calling thread's ring buffer.
+ */
+void Profiler::record(const char* name, const uint64_t& begin, const uint64_t& end) {
+    thread_local BufferOwner owner;
+    if (!owner.buffer) { owner.buffer = registerThread(); }
+    ThreadBuffer* buffer = owner.buffer;
+    buffer->events[buffer->next] = {name, begin, end};
+    if (++buffer->next == RING_CAPACITY) {
+        buffer->next = 0;
+        buffer->wrapped = true;
+    }
+}
+
+/**
+ * Discards every recorded zone and restarts the trace clock.
+ *
+ * @pre No zone is running on any thread.
+ */
+void Profiler::reset() {
+    std::lock_guard<std::mutex> guard(registry_mutex);
+    for (auto& buffer : registry) {
+        buffer->next = 0;
+        buffer->wrapped = false;
+    }
+    base_ticks = now();
+    base_nanoseconds = steadyNanoseconds();
+}
+
+/**
+ * Writes every recorded zone as Chrome trace JSON ("complete" events, one track per ring buffer).
+ *
+ * @pre No zone is running on any thread.
+ * @return The number of zones written.
+ */
+size_t Profiler::writeChromeTrace(std::ostream& out) {
+    std::lock_guard<std::mutex> guard(registry_mutex);
+    const double ticks_per_us = ticksPerNanosecond() * 1000.0;
+
+    size_t written = 0;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (const auto& buffer : registry) {
+        for (const Event& event : buffer->ordered()) {
+            if (event.begin < base_ticks) { continue; }
+
+            out << (written++ ? ",\n" : "\n")
+                << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_id
+                << ",\"ts\":" << (event.begin - base_ticks) / ticks_per_us
+                << ",\"dur\":" << (event.end - event.begin) / ticks_per_us << "}";
+        }
+    }
+    out << "\n]}" << std::endl;
+    return written;
+}
+
+/**
+ * Writes the self time of every zone stack as folded stacks: one "outer;inner <nanoseconds>" line per stack.
+ *
+ * @pre No zone is running on any thread.
+ * @return The number of distinct stacks written.
+ */
+size_t Profiler::writeFoldedStacks(std::ostream& out) {
+    std::lock_guard<std::mutex> guard(registry_mutex);
+    const double ticks_per_ns = ticksPerNanosecond();
+
+    // Self ticks by stack, over all threads
+    std::map<std::string, uint64_t> stacks;
+    for (const auto& buffer : registry) {
+        // Parents start before their children, and enclose them
+        std::vector<Event> events = buffer->ordered();
+        std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+            return a.begin != b.begin ? a.begin < b.begin : a.end > b.end;
+        });
+
+        struct Open {
+            std::string stack;
+            uint64_t end;
+            uint64_t self;
+        };
+        std::vector<Open> open;
+        auto close = [&stacks, &open]() {
+            stacks[open.back().stack] += open.back().self;
+            open.pop_back();
+        };
+
+        for (const Event& event : events) {
+            while (!open.empty() && open.back().end <= event.begin) { close(); }
+
+            uint64_t duration = event.end - event.begin;
+            if (!open.empty()) { open.back().self -= std::min(open.back().self, duration); }
+            open.push_back({open.empty() ? event.name : open.back().stack + ";" + event.name, event.end, duration});
+        }
+        while (!open.empty()) { close(); }
+    }
+
+    for (const auto& [stack, ticks] : stacks) {
+        out << stack << " " << static_cast<uint64_t>(ticks / ticks_per_ns) << "\n";
+    }
+    out.flush();
+    return stacks.size();
+}
@@ -0,0 +1,111 @@
+/**
+ * @brief Scoped timing zones for profiling a search without external tools.
+ *
+ * PROFILE_ZONE("name") times the rest of the enclosing scope with the CPU's time stamp
+ * counter (RDTSC, or a steady clock elsewhere than x86). Every finished zone is written
+ * to a ring buffer owned by its thread, so recording takes no lock and the newest
+ * RING_CAPACITY zones of every thread are kept. When a thread ends, its ring is handed
+ * on to the next thread that records a zone, so there are never more rings than threads
+ * alive at once, however many short-lived threads come and go.
+ *
+ * The recorded zones can be exported as Chrome trace JSON (chrome://tracing, Perfetto)
+ * or as folded stacks ("outer;inner <nanoseconds>" lines, for flamegraph.pl), where
+ * nesting is rebuilt from the zones' intervals.
+ *
+ * Zones are only compiled in when CHESS_PROFILE is defined (`make PROFILE=1`).
+ * Otherwise PROFILE_ZONE expands to nothing, and the exports write empty reports.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef CHESS_PROFILE
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
+
+namespace Profiler {
+#ifdef CHESS_PROFILE
+    const bool ENABLED = true;
+#else
+    const bool ENABLED = false;
+#endif
+
+    // The number of zones kept per thread; older ones are overwritten
+    const size_t RING_CAPACITY = 1 << 18;
+
+    /*
+    A finished zone. `name` must be a string literal (only the pointer is kept).
+    */
+    struct Event {
+        const char* name;
+        uint64_t begin;   // In ticks of now()
+        uint64_t end;
+    };
+
+    /**
+     * Reads the time stamp counter.
+     */
+    inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    /**
+     * Writes a finished zone to the calling thread's ring buffer.
+     */
+    void record(const char* name, const uint64_t& begin, const uint64_t& end);
+
+    /**
+     * Times the scope it lives in. Use it through PROFILE_ZONE.
+     */
+    class Zone {
+        private:
+            const char* name_;
+            uint64_t begin_;
+
+        public:
+            explicit Zone(const char* name) : name_{name}, begin_{now()} {}
+            ~Zone() { record(name_, begin_, now()); }
+
+            Zone(const Zone& other) = delete;
+            Zone& operator=(const Zone& other) = delete;
+    };
+
+    /**
+     * Discards every recorded zone and restarts the trace clock.
+     *
+     * @pre No zone is running on any thread.
+     */
+    void reset();
+
+    /**
+     * Writes every recorded zone as Chrome trace JSON ("complete" events, one track per ring buffer).
+     *
+     * @pre No zone is running on any thread.
+     * @return The number of zones written.
+     */
+    size_t writeChromeTrace(std::ostream& out);
+
+    /**
+     * Writes the self time of every zone stack as folded stacks: one "outer;inner <nanoseconds>" line per stack.
+     *
+     * @pre No zone is running on any thread.
+     * @return The number of distinct stacks written.
+     */
+    size_t writeFoldedStacks(std::ostream& out);
+};
@@ -0,0 +1,139 @@
+#include "ProofTable.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Constructs a table that uses at most `megabytes` MiB of entries
+ * @param megabytes The memory budget. At least one bucket is always allocated.
+ */
+ProofTable::ProofTable(const size_t& megabytes)
+    : bucket_count_{std::max<size_t>(1, (megabytes << 20) / (sizeof(Entry) * BUCKET_SIZE))}, used_{0} {
+    entries_.assign(bucket_count_ * BUCKET_SIZE, Entry{0, 0, 0, 0, 0});
+}
+
+/**
+ * @brief Gets the index of the first entry of the bucket for (key, depth)
+ */
+size_t ProofTable::bucketIndex(const uint64_t& key, const int& depth) const {
+    uint64_t mixed = key ^ (static_cast<uint64_t>(depth) * 0x9E3779B97F4A7C15ULL);
+    return static_cast<size_t>(mixed % bucket_count_) * BUCKET_SIZE;
+}
+
+/**
+ * @brief Looks up the entry for (key, depth)
+ * @param pn Set to the stored proof number if found
+ * @param dn Set to the stored disproof number if found
+ * @return True if an entry was found. False otherwise (pn / dn are untouched)
+ */
+bool ProofTable::lookup(const uint64_t& key, const int& depth, uint32_t& pn, uint32_t& dn) const {
+    std::shared_lock<std::shared_mutex> gc_guard(gc_mutex_);
+    size_t index = bucketIndex(key, depth);
+    std::lock_guard<std::mutex> guard(stripes_[(index / BUCKET_SIZE) % LOCK_STRIPES]);
+
+    for (size_t i = index; i < index + BUCKET_SIZE; i++) {
+        const Entry& entry = entries_[i];
+        if (entry.key == key && entry.depth == depth) {
+            pn = entry.pn;
+            dn = entry.dn;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Stores the proof / disproof numbers for (key, depth).
+ *        If the bucket is full, the entry with the least work is replaced.
+ * @post If the table becomes mostly full, it is garbage collected.
+ */
+void ProofTable::store(const uint64_t& key, const int& depth, const uint32_t& pn, const uint32_t& dn, const uint64_t& work) {
+    {
+        std::shared_lock<std::shared_mutex> gc_guard(gc_mutex_);
+        size_t index = bucketIndex(key, depth);
+        std::lock_guard<std::mutex> guard(stripes_[(index / BUCKET_SIZE) % LOCK_STRIPES]);
+
+        // Prefer the slot already holding this position, then an empty slot, then the cheapest entry
+        Entry* bucket = &entries_[index];
+        Entry* victim = std::find_if(bucket, bucket + BUCKET_SIZE, [&key, &depth](const Entry& entry) {
+            return entry.key == key && entry.depth == depth;
+        });
+        if (victim == bucket + BUCKET_SIZE) {
+            victim = std::find_if(bucket, bucket + BUCKET_SIZE, [](const Entry& entry) { return entry.key == 0; });
+        }
+        if (victim == bucket + BUCKET_SIZE) {
+            victim = std::min_element(bucket, bucket + BUCKET_SIZE, [](const Entry& a, const Entry& b) { return a.work < b.work; });
+        }
+
+        if (victim->key == 0) { used_++; }
+        *victim = Entry{key, pn, dn, static_cast<uint32_t>(std::min<uint64_t>(work, UINT32_MAX)), depth};
+    }
+
+    // Collect once the table is 3/4 full, so buckets keep room for new positions
+    if (used_ * 4 > entries_.size() * 3) {
+        std::unique_lock<std::shared_mutex> gc_guard(gc_mutex_);
+        if (used_ * 4 > entries_.size() * 3) { collectGarbage(); }
+    }
+}
+
+/**
+ * @brief Evicts low-work entries until the table is at most half full.
+ *
+ *        Unsolved entries below the median work are dropped first, since they are
+ *        cheap to recompute. If that is not enough, solved entries below the median
+ *        are dropped as well.
+ * @pre The caller holds `gc_mutex_` exclusively
+ */
+void ProofTable::collectGarbage() {
+    std::vector<uint32_t> work;
+    work.reserve(used_);
+    for (const Entry& entry : entries_) {
+        if (entry.key) { work.push_back(entry.work); }
+    }
+    if (work.empty()) { return; }
+
+    std::nth_element(work.begin(), work.begin() + work.size() / 2, work.end());
+    uint32_t median = work[work.size() / 2];
+
+    auto evict = [this, &median](const bool& include_solved) {
+        for (Entry& entry : entries_) {
+            if (!entry.key || entry.work > median) { continue; }
+            bool solved = entry.pn == 0 || entry.dn == 0;
+            if (solved && !include_solved) { continue; }
+            entry.key = 0;
+            used_--;
+        }
+    };
+
+    evict(false);
+    if (used_ * 2 > entries_.size()) { evict(true); }
+}
+
+/**
+ * @brief Removes every entry
+ */
+void ProofTable::clear() {
+    std::unique_lock<std::shared_mutex> gc_guard(gc_mutex_);
+    std::fill(entries_.begin(), entries_.end(), Entry{0, 0, 0, 0, 0});
+    used_ = 0;
+}
+
+/**
+ * @brief Gets the number of occupied slots
+ */
+size_t ProofTable::size() const {
+    return used_;
+}
+
+/**
+ * @brief Gets the maximum number of entries the table may hold
+ */
+size_t ProofTable::capacity() const {
+    return entries_.size();
+}
+
+/**
+ * @brief Adds the memory used by the table to `report`
+ */
+void ProofTable::reportMemory(MemoryReport& report) const {
+    report.add("proof table", sizeof(ProofTable) + entries_.capacity() * sizeof(Entry));
+}
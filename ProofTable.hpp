@@ -0,0 +1,99 @@
+/**
+ * @class ProofTable
+ * @brief A memory-bounded transposition table for proof-number search.
+ *
+ * Stores the proof / disproof numbers of positions searched by the MateSolver,
+ * keyed by Zobrist hash and the number of plies left to deliver mate.
+ * The table never grows past the size it was constructed with: once it is
+ * mostly full, entries that took little work to compute are garbage collected.
+ * All operations are safe to call from several threads at once.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+
+#include "MemoryReport.hpp"
+
+class ProofTable {
+    public:
+        // Proof & disproof numbers saturate at INFINITE_PN, which marks a solved node
+        static const uint32_t INFINITE_PN = 100000000;
+
+        struct Entry {
+            uint64_t key;    // Zobrist hash of the position (0 marks an empty slot)
+            uint32_t pn;     // Proof number: how many leaves must still be proven to prove a mate
+            uint32_t dn;     // Disproof number: how many leaves must still be disproven to refute it
+            uint32_t work;   // Number of nodes searched to compute pn / dn (used to pick victims)
+            int32_t depth;   // Plies left to deliver mate when this entry was stored
+        };
+
+    private:
+        static const size_t BUCKET_SIZE = 4;  // Entries sharing the same index
+        static const size_t LOCK_STRIPES = 256;
+
+        std::vector<Entry> entries_;
+        size_t bucket_count_;
+        std::atomic<size_t> used_;  // Number of occupied slots
+
+        // Readers / writers share `gc_mutex_`; garbage collection takes it exclusively
+        mutable std::shared_mutex gc_mutex_;
+        mutable std::mutex stripes_[LOCK_STRIPES];
+
+        /**
+         * @brief Gets the index of the first entry of the bucket for (key, depth)
+         */
+        size_t bucketIndex(const uint64_t& key, const int& depth) const;
+
+        /**
+         * @brief Evicts low-work entries until the table is at most half full.
+         * @pre The caller holds `gc_mutex_` exclusively
+         */
+        void collectGarbage();
+
+    public:
+        /**
+         * @brief Constructs a table that uses at most `megabytes` MiB of entries
+         * @param megabytes The memory budget. At least one bucket is always allocated.
+         */
+        ProofTable(const size_t& megabytes);
+
+        /**
+         * @brief Looks up the entry for (key, depth)
+         * @param pn Set to the stored proof number if found
+         * @param dn Set to the stored disproof number if found
+         * @return True if an entry was found. False otherwise (pn / dn are untouched)
+         */
+        bool lookup(const uint64_t& key, const int& depth, uint32_t& pn, uint32_t& dn) const;
+
+        /**
+         * @brief Stores the proof / disproof numbers for (key, depth).
+         *        If the bucket is full, the entry with the least work is replaced.
+         * @post If the table becomes mostly full, it is garbage collected.
+         */
+        void store(const uint64_t& key, const int& depth, const uint32_t& pn, const uint32_t& dn, const uint64_t& work);
+
+        /**
+         * @brief Removes every entry
+         */
+        void clear();
+
+        /**
+         * @brief Gets the number of occupied slots
+         */
+        size_t size() const;
+
+        /**
+         * @brief Gets the maximum number of entries the table may hold
+         */
+        size_t capacity() const;
+
+        /**
+         * @brief Adds the memory used by the table to `report`
+         */
+        void reportMemory(MemoryReport& report) const;
+};
@@ -0,0 +1,201 @@
+#include "PuzzleMiner.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+
+#include "Evaluation.hpp"
+#include "Notation.hpp"
+
+/**
+ * @brief Constructs a miner that writes its JSON lines to `out`
+ */
+PuzzleMiner::PuzzleMiner(std::ostream& out, const PuzzleOptions& options)
+    : options_{options}, out_{out}, positions_{0}, filtered_{0}, quiet_{0}, candidates_{0}, puzzles_{0} {}
+
+/**
+ * @brief The cheap filters: determines whether the position on `board` may hold a tactic
+ * @param swing The game's material swing towards the player to move, in centipawns
+ */
+bool PuzzleMiner::mayHoldTactic(ChessBoard& board, const int& swing) const {
+    if (std::abs(Evaluation::evaluate(board)) >= DECIDED_SCORE) { return false; }
+    if (swing >= MIN_WIN) { return true; }
+
+    // A capture that wins material on its own
+    for (const Move& move : board.generateMoves()) {
+        if (move.getCapturedPiece() && Evaluation::staticExchange(board, move) >= MIN_WIN) { return true; }
+    }
+    return false;
+}
+
+/**
+ * @brief Searches the two best moves of the position on `board`
+ * @return True if the best move is unique and winning. `line` is then set to its
+ *         principal variation and `score` / `gap` to its score and lead.
+ */
+bool PuzzleMiner::findUniqueWin(ChessBoard& board, Search& search, const uint64_t& nodes,
+                                std::vector<Move>& line, int& score, int& gap) const {
+    SearchLimits limits;
+    limits.nodes = nodes;
+    limits.multipv = 2;
+
+    // A single legal move is forced, not found
+    std::vector<PVLine> lines = search.run(board, limits);
+    if (lines.size() < 2) { return false; }
+    // Scores of a first iteration cut short by the node budget are partly static guesses
+    if (lines[0].depth < 1 || lines[1].depth < 1) { return false; }
+
+    score = lines[0].score;
+    gap = lines[0].score - lines[1].score;
+    if (score < MIN_WIN || gap < MIN_GAP) { return false; }
+
+    line = lines[0].moves;
+    return true;
+}
+
+/**
+ * @brief Verifies a candidate with deeper searches and builds its solution line
+ * @return The solution (empty if the candidate was not confirmed).
+ * @post `board` is left in the same position it was passed in.
+ */
+std::vector<Move> PuzzleMiner::verify(ChessBoard& board, Search& search, const Move& candidate, int& score, int& gap) const {
+    std::vector<Move> solution;
+    std::vector<Move> line;
+    if (!findUniqueWin(board, search, options_.verify_nodes, line, score, gap) || !(line[0] == candidate)) {
+        return solution;
+    }
+
+    // Follow the defender's best reply for as long as the winning move stays unique
+    int played = 0;
+    while (true) {
+        solution.push_back(line[0]);
+        board.makeMove(line[0]);
+        played++;
+
+        int moves = static_cast<int>(solution.size() + 1) / 2;
+        if (moves >= options_.max_moves || line.size() < 2) { break; }
+
+        board.makeMove(line[1]);
+        std::vector<Move> next;
+        int next_score, next_gap;
+        if (!findUniqueWin(board, search, options_.verify_nodes, next, next_score, next_gap)) {
+            board.unmakeMove();
+            break;
+        }
+        solution.push_back(line[1]);
+        played++;
+        line = next;
+    }
+
+    for (int i = 0; i < played; i++) { board.unmakeMove(); }
+    return solution;
+}
+
+/**
+ * @brief Mines every position of `game`
+ * @return One JSON line per puzzle found.
+ */
+std::string PuzzleMiner::mine(const GameRecord& game, EngineContext& engine) {
+    ChessBoard& board = engine.board;
+    const std::string start = game.tag("FEN", ChessBoard::STARTING_FEN);
+    if (!board.loadFEN(start)) { return ""; }
+
+    // Replay the game first, for the material balance before every ply (from Player One's point of view).
+    // Only the legal prefix of the game is mined.
+    std::vector<Move> played;
+    std::vector<int> material{Evaluation::materialBalance(board)};
+    for (const std::string& token : game.moves) {
+        std::vector<Move> legal = board.generateMoves();
+        int index = Notation::findMove(board, legal, token);
+        if (index < 0) { break; }
+
+        played.push_back(legal[index]);
+        board.makeMove(legal[index]);
+        material.push_back(Evaluation::materialBalance(board));
+    }
+    board.loadFEN(start);
+
+    // Every game starts from an empty table so results do not depend on scheduling
+    engine.table.clear();
+
+    std::ostringstream json;
+    size_t next_ply = 0; // Plies covered by the solution of the last puzzle are skipped
+    for (size_t ply = 0; ply < played.size(); ply++) {
+        positions_++;
+        if (ply < next_ply) {
+            board.makeMove(played[ply]);
+            continue;
+        }
+
+        size_t horizon = std::min(ply + SWING_PLIES, played.size());
+        int swing = material[horizon] - material[ply];
+        if (!board.isPlayerOneTurn()) { swing = -swing; }
+
+        std::vector<Move> line;
+        int score, gap;
+        bool candidate = false;
+        if (mayHoldTactic(board, swing)) {
+            filtered_++;
+            if (engine.search.quiescenceScore(board) > -DECIDED_SCORE) {
+                quiet_++;
+                candidate = findUniqueWin(board, engine.search, options_.scan_nodes, line, score, gap);
+            }
+        }
+
+        std::vector<Move> solution;
+        if (candidate) {
+            candidates_++;
+            solution = verify(board, engine.search, line[0], score, gap);
+        }
+
+        if (!solution.empty()) {
+            puzzles_++;
+            next_ply = ply + solution.size();
+
+            json << "{\"game\":" << game.index << ",\"ply\":" << (ply + 1)
+                 << ",\"fen\":\"" << board.toFEN() << "\",\"moves\":[";
+            for (size_t i = 0; i < solution.size(); i++) {
+                json << (i ? "," : "") << "\"" << solution[i].toUCI() << "\"";
+            }
+            json << "],\"san\":[";
+            for (size_t i = 0; i < solution.size(); i++) {
+                json << (i ? "," : "") << "\"" << Notation::toSAN(board, solution[i], board.generateMoves()) << "\"";
+                board.makeMove(solution[i]);
+            }
+            for (size_t i = 0; i < solution.size(); i++) { board.unmakeMove(); }
+            json << "],\"eval\":" << score << ",\"gap\":" << gap
+                 << ",\"mate\":" << (Search::isMateScore(score) ? "true" : "false")
+                 << ",\"found_in_game\":" << (played[ply] == solution[0] ? "true" : "false") << "}\n";
+        }
+
+        board.makeMove(played[ply]);
+    }
+
+    return json.str();
+}
+
+/**
+ * @brief Mines every game read from the PGN stream `in`
+ * @return The number of games read.
+ */
+size_t PuzzleMiner::run(std::istream& in) {
+    CorpusPipeline pipeline(out_, options_.threads);
+    return pipeline.run(in, [this]() {
+        auto engine = std::make_shared<EngineContext>(options_.table_megabytes);
+        return [this, engine](const GameRecord& game) { return mine(game, *engine); };
+    });
+}
+
+/**
+ * @brief Gets how many positions each stage let through so far
+ */
+PuzzleStats PuzzleMiner::stats() const {
+    PuzzleStats stats;
+    stats.positions = positions_;
+    stats.filtered = filtered_;
+    stats.quiet = quiet_;
+    stats.candidates = candidates_;
+    stats.puzzles = puzzles_;
+    return stats;
+}
@@ -0,0 +1,118 @@
+/**
+ * @class PuzzleMiner
+ * @brief Mines tactical puzzles from game corpora.
+ *
+ * A puzzle is a position where the player to move has a single winning move: the
+ * best move wins at least MIN_WIN centipawns and beats every other move by at least
+ * MIN_GAP. Every position of every game goes through increasingly expensive stages,
+ * and most are rejected by the cheap ones:
+ *
+ *  1. Filters that need no search: the position is not already decided, and either
+ *     a capture wins material by static exchange evaluation (SEE), or the game's
+ *     material balance swings towards the player to move within the next few plies.
+ *  2. A quiescence search, rejecting positions that are lost once the pending
+ *     exchanges are played out.
+ *  3. A shallow two-line (MultiPV 2) search, measuring the gap between the best
+ *     and the second best move.
+ *  4. A deeper two-line search that must confirm the move and the gap. The solution
+ *     line is then extended for as long as the winning side's next move is unique too.
+ *
+ * Games are streamed through a CorpusPipeline. Output is JSON Lines: one object per
+ * puzzle, with its FEN and solution line.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "CorpusPipeline.hpp"
+
+/**
+ * The settings of a mining run.
+ */
+struct PuzzleOptions {
+    uint64_t scan_nodes = 4000;     // Node budget of the shallow search of every candidate
+    uint64_t verify_nodes = 60000;  // Node budget of every verification search
+    int max_moves = 3;              // The most moves of the winning side in a solution
+    int threads = 1;                // Number of games mined in parallel
+    size_t table_megabytes = 16;    // Transposition table size of each thread
+};
+
+/**
+ * How many positions each stage let through.
+ */
+struct PuzzleStats {
+    uint64_t positions = 0;   // Positions examined
+    uint64_t filtered = 0;    // Passed the SEE / material swing filters
+    uint64_t quiet = 0;       // Passed the quiescence check
+    uint64_t candidates = 0;  // Passed the shallow search
+    uint64_t puzzles = 0;     // Confirmed by the deeper search
+};
+
+class PuzzleMiner {
+    public:
+        // Centipawns the best move must win, and by which it must beat the second best move
+        static const int MIN_WIN = 200;
+        static const int MIN_GAP = 200;
+        // Positions where either player is this far ahead are already decided
+        static const int DECIDED_SCORE = 700;
+        // The number of plies over which the game's material swing is measured
+        static const int SWING_PLIES = 6;
+
+    private:
+        PuzzleOptions options_;
+        std::ostream& out_;
+
+        std::atomic<uint64_t> positions_;
+        std::atomic<uint64_t> filtered_;
+        std::atomic<uint64_t> quiet_;
+        std::atomic<uint64_t> candidates_;
+        std::atomic<uint64_t> puzzles_;
+
+        /**
+         * @brief The cheap filters: determines whether the position on `board` may hold a tactic
+         * @param swing The game's material swing towards the player to move, in centipawns
+         */
+        bool mayHoldTactic(ChessBoard& board, const int& swing) const;
+
+        /**
+         * @brief Searches the two best moves of the position on `board`
+         * @return True if the best move is unique and winning. `line` is then set to its
+         *         principal variation and `score` / `gap` to its score and lead.
+         */
+        bool findUniqueWin(ChessBoard& board, Search& search, const uint64_t& nodes,
+                           std::vector<Move>& line, int& score, int& gap) const;
+
+        /**
+         * @brief Verifies a candidate with deeper searches and builds its solution line
+         * @return The solution (empty if the candidate was not confirmed).
+         * @post `board` is left in the same position it was passed in.
+         */
+        std::vector<Move> verify(ChessBoard& board, Search& search, const Move& candidate, int& score, int& gap) const;
+
+        /**
+         * @brief Mines every position of `game`
+         * @return One JSON line per puzzle found.
+         */
+        std::string mine(const GameRecord& game, EngineContext& engine);
+
+    public:
+        /**
+         * @brief Constructs a miner that writes its JSON lines to `out`
+         */
+        PuzzleMiner(std::ostream& out, const PuzzleOptions& options);
+
+        /**
+         * @brief Mines every game read from the PGN stream `in`
+         * @return The number of games read.
+         */
+        size_t run(std::istream& in);
+
+        /**
+         * @brief Gets how many positions each stage let through so far
+         */
+        PuzzleStats stats() const;
+};
@@ -0,0 +1,462 @@
+#include "Search.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Evaluation.hpp"
+#include "Profiler.hpp"
+
+/**
+ * @brief Constructs a search that stores its results in `table`
+ */
+Search::Search(TranspositionTable& table) : table_{table}, stop_{false}, nodes_{0}, pondering_{false}, budget_start_{0} {}
+
+/**
+ * @brief Scores the position on `board` with a capture-only search, ie. the static
+ *        evaluation once every pending exchange has been played out.
+ * @return The score from the point of view of the player to move.
+ * @post `board` is left in the same position it was passed in.
+ */
+int Search::quiescenceScore(ChessBoard& board) {
+    // Unlimited, and without starting a new table generation as a full search would
+    limits_ = SearchLimits();
+    pondering_ = false;
+    nodes_ = 0;
+    stop_ = false;
+    return quiescence(board, -INFINITE_SCORE, INFINITE_SCORE, 0, stats_.slot(0));
+}
+
+/**
+ * @brief Asks a running search to stop as soon as possible. Safe to call from any thread.
+ */
+void Search::stop() {
+    stop_ = true;
+}
+
+/**
+ * @brief Tells a pondering search that the expected move was played: the search
+ *        carries on with everything it has learned, and its time budget starts now.
+ *        Safe to call from any thread.
+ */
+void Search::ponderhit() {
+    budget_start_ = std::chrono::steady_clock::now().time_since_epoch().count();
+    pondering_ = false;
+}
+
+/**
+ * @brief Determines whether the search is pondering (ie. ponderhit() has not been called yet)
+ */
+bool Search::isPondering() const {
+    return pondering_;
+}
+
+/**
+ * @brief Gets the number of nodes searched by the last (or current) search
+ */
+uint64_t Search::nodes() const {
+    return nodes_;
+}
+
+/**
+ * @brief Gets the statistics of the last (or current) search
+ */
+const SearchStats& Search::stats() const {
+    return stats_;
+}
+
+/**
+ * @brief Adds the memory used by the search itself (not its table) to `report`
+ */
+void Search::reportMemory(MemoryReport& report) const {
+    report.add("search", sizeof(Search));
+    stats_.reportMemory(report);
+}
+
+/**
+ * @brief Determines whether `score` means a forced mate for either player
+ */
+bool Search::isMateScore(const int& score) {
+    return std::abs(score) >= MATE_SCORE - MAX_PLY && std::abs(score) <= MATE_SCORE;
+}
+
+/**
+ * @brief Converts a score between "relative to the root" and "relative to this node",
+ *        which is how mate scores are kept in the table
+ */
+int Search::scoreToTable(const int& score, const int& ply) {
+    if (score >= MATE_SCORE - MAX_PLY) { return score + ply; }
+    if (score <= -MATE_SCORE + MAX_PLY) { return score - ply; }
+    return score;
+}
+
+int Search::scoreFromTable(const int& score, const int& ply) {
+    if (score >= MATE_SCORE - MAX_PLY) { return score - ply; }
+    if (score <= -MATE_SCORE + MAX_PLY) { return score + ply; }
+    return score;
+}
+
+/**
+ * @brief Counts a node and raises `stop_` once a limit is reached
+ */
+void Search::countNode() {
+    uint64_t count = ++nodes_;
+    if (limits_.nodes && count >= limits_.nodes) { stop_ = true; }
+
+    // Read the clock every 64 nodes: at this engine's speed that still stops a search within
+    // a few milliseconds of its budget, which deadline-driven callers (SearchScheduler) rely on
+    if ((count & 63) == 0 && limits_.movetime && !limits_.infinite && !pondering_) {
+        std::chrono::steady_clock::time_point budget_start{std::chrono::steady_clock::duration(budget_start_.load())};
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - budget_start);
+        if (elapsed.count() >= limits_.movetime) { stop_ = true; }
+    }
+
+    // A SIGUSR1 asked for the statistics of the running search
+    if ((count & 1023) == 0 && SearchStats::takeDumpRequest()) {
+        std::cerr << stats_.toJSON() << std::endl;
+    }
+}
+
+/**
+ * @brief Sorts `moves` so the table's best move comes first,
+ *        then captures by most valuable victim / least valuable attacker
+ */
+void Search::orderMoves(const ChessBoard& board, std::vector<Move>& moves, const TranspositionTable::Entry* hint) const {
+    auto priority = [&board, &hint](const Move& move) {
+        if (hint && hint->has_move && move.getOriginalPosition() == hint->from && move.getTargetPosition() == hint->to) {
+            return 1000000;
+        }
+        if (!move.getCapturedPiece()) { return 0; }
+
+        int victim = Evaluation::PIECE_VALUES[board.pieceKind(move.getCapturedPiece()) % 6];
+        int attacker = Evaluation::PIECE_VALUES[board.pieceKind(move.getMovedPiece()) % 6];
+        return 10000 + 10 * victim - attacker / 10;
+    };
+
+    std::vector<std::pair<int, size_t>> keys(moves.size());
+    for (size_t i = 0; i < moves.size(); i++) { keys[i] = {priority(moves[i]), i}; }
+    std::stable_sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::vector<Move> ordered;
+    ordered.reserve(moves.size());
+    for (const auto& key : keys) { ordered.push_back(moves[key.second]); }
+    moves.swap(ordered);
+}
+
+/**
+ * @brief Searches captures only, until the position is quiet
+ */
+int Search::quiescence(ChessBoard& board, int alpha, int beta, const int& ply, SearchStats::Slot& stats) {
+    PROFILE_ZONE("quiescence");
+    countNode();
+    SearchStats::Slot::bump(stats.qnodes);
+    if (stop_) { return 0; }
+
+    // The player to move may "stand pat" instead of capturing
+    int best = Evaluation::evaluate(board);
+    if (best >= beta || ply >= MAX_PLY) { return best; }
+    alpha = std::max(alpha, best);
+
+    std::vector<Move> moves = board.generateMoves();
+    moves.erase(std::remove_if(moves.begin(), moves.end(), [](const Move& move) { return !move.getCapturedPiece(); }), moves.end());
+    orderMoves(board, moves, nullptr);
+
+    for (const Move& move : moves) {
+        board.makeMove(move);
+        int score = -quiescence(board, -beta, -alpha, ply + 1, stats);
+        board.unmakeMove();
+        if (stop_) { return 0; }
+
+        if (score > best) {
+            best = score;
+            if (score > alpha) { alpha = score; }
+            if (alpha >= beta) { break; }
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief Negamax alpha-beta search of the position on `board`
+ * @param ply The distance from the root, used to score mates by their distance
+ * @param stats The statistics slot of the calling thread
+ * @return The score from the point of view of the player to move.
+ *         Meaningless if the search was stopped.
+ */
+int Search::negamax(ChessBoard& board, const int& depth, int alpha, int beta, const int& ply, SearchStats::Slot& stats) {
+    if (depth <= 0) { return quiescence(board, alpha, beta, ply, stats); }
+
+    countNode();
+    SearchStats::Slot::bump(stats.nodes);
+    if (stop_) { return 0; }
+    if (ply >= MAX_PLY) { return Evaluation::evaluate(board); }
+
+    const int alpha_original = alpha;
+    const uint64_t key = board.getHash();
+
+    // Use the stored result if it was searched at least as deep
+    TranspositionTable::Entry entry;
+    bool hit = table_.probe(key, entry);
+    SearchStats::Slot::bump(stats.tt_probes);
+    if (hit) { SearchStats::Slot::bump(stats.tt_hits); }
+    if (hit && entry.depth >= depth) {
+        int score = scoreFromTable(entry.score, ply);
+        if (entry.bound == TranspositionTable::BOUND_LOWER) { alpha = std::max(alpha, score); }
+        if (entry.bound == TranspositionTable::BOUND_UPPER) { beta = std::min(beta, score); }
+        if (entry.bound == TranspositionTable::BOUND_EXACT || alpha >= beta) {
+            SearchStats::Slot::bump(stats.tt_cutoffs);
+            return score;
+        }
+    }
+
+    std::vector<Move> moves = board.generateMoves();
+    if (moves.empty()) { return board.isInCheck() ? -MATE_SCORE + ply : 0; }
+    orderMoves(board, moves, hit ? &entry : nullptr);
+
+    int best = -INFINITE_SCORE;
+    size_t best_index = 0;
+    for (size_t i = 0; i < moves.size(); i++) {
+        board.makeMove(moves[i]);
+        int score = -negamax(board, depth - 1, -beta, -alpha, ply + 1, stats);
+        board.unmakeMove();
+        if (stop_) { return 0; }
+
+        if (score > best) {
+            best = score;
+            best_index = i;
+            if (score > alpha) { alpha = score; }
+            if (alpha >= beta) {
+                SearchStats::Slot::bump(stats.beta_cutoffs);
+                SearchStats::Slot::bump(stats.cutoff_index[std::min<size_t>(i, SearchStats::CUTOFF_BUCKETS - 1)]);
+                break;
+            }
+        }
+    }
+
+    TranspositionTable::Bound bound = (best >= beta) ? TranspositionTable::BOUND_LOWER
+        : (best > alpha_original) ? TranspositionTable::BOUND_EXACT
+        : TranspositionTable::BOUND_UPPER;
+    table_.store(key, scoreToTable(best, ply), depth, bound, &moves[best_index]);
+    return best;
+}
+
+/**
+ * @brief Follows the best moves stored in the table after playing `first`
+ * @return The principal variation, starting with `first`.
+ */
+std::vector<Move> Search::principalVariation(ChessBoard& board, const Move& first, const int& max_length) const {
+    std::vector<Move> pv = {first};
+    board.makeMove(first);
+
+    TranspositionTable::Entry entry;
+    while (static_cast<int>(pv.size()) < max_length && table_.probe(board.getHash(), entry) && entry.has_move) {
+        std::vector<Move> moves = board.generateMoves();
+        auto stored = std::find_if(moves.begin(), moves.end(), [&entry](const Move& move) {
+            return move.getOriginalPosition() == entry.from && move.getTargetPosition() == entry.to;
+        });
+        if (stored == moves.end()) { break; }
+
+        pv.push_back(*stored);
+        board.makeMove(*stored);
+    }
+
+    for (size_t i = 0; i < pv.size(); i++) { board.unmakeMove(); }
+    return pv;
+}
+
+/**
+ * @brief Searches the position on `board` until a limit is reached or stop() is called.
+ *
+ * @param on_iteration Called after every completed iteration (may be empty)
+ * @return The best lines of the last completed iteration, best first.
+ *         Empty if the player to move has no legal moves.
+ * @post `board` is left in the same position it was passed in.
+ */
+std::vector<PVLine> Search::run(ChessBoard& board, const SearchLimits& limits,
+                                const std::function<void(const SearchReport&)>& on_iteration) {
+    prepare(limits);
+    return think(board, on_iteration);
+}
+
+/**
+ * @brief The two halves of run(), for searches started on another thread:
+ *        prepare() resets the limits, clock and stop / ponder state and should be
+ *        called before the thread starts, so an early stop() or ponderhit() is not lost.
+ *        think() then searches `board` under those limits.
+ */
+void Search::prepare(const SearchLimits& limits) {
+    limits_ = limits;
+    start_ = std::chrono::steady_clock::now();
+    budget_start_ = start_.time_since_epoch().count();
+    pondering_ = limits.ponder;
+    nodes_ = 0;
+    stop_ = false;
+    stats_.reset(limits.threads);
+    table_.newSearch();
+}
+
+std::vector<PVLine> Search::think(ChessBoard& board, const std::function<void(const SearchReport&)>& on_iteration) {
+    PROFILE_ZONE("search");
+    const SearchLimits limits = limits_;
+
+    std::vector<Move> root_moves = board.generateMoves();
+    if (root_moves.empty()) { return {}; }
+
+    // The table is kept between searches, so a position searched before (eg. while
+    // pondering on the previous move) starts from its previous best move
+    TranspositionTable::Entry root_entry;
+    bool root_hit = table_.probe(board.getHash(), root_entry);
+    orderMoves(board, root_moves, root_hit ? &root_entry : nullptr);
+
+    const size_t line_count = std::clamp<size_t>(limits.multipv, 1, root_moves.size());
+    const int thread_count = std::max(1, limits.threads);
+
+    // Boards are not thread safe, so every extra thread searches its own copy. Only a
+    // thread new to this Search allocates one; the others are re-seated on the position.
+    const Position position = board.getPosition();
+    thread_boards_.resize(thread_count - 1);
+    for (auto& thread_board : thread_boards_) {
+        if (thread_board) { thread_board->setPosition(position); }
+        else { thread_board = std::make_unique<ChessBoard>(board); }
+    }
+
+    std::vector<PVLine> lines;
+    for (int depth = 1; depth <= limits.depth; depth++) {
+        if (!searchIteration(board, thread_boards_, depth, line_count, root_moves, lines)) { break; }
+
+        // A first iteration cut short still fills `lines`, but is not reported as an iteration
+        if (on_iteration && lines.front().depth == depth) {
+            SearchReport report;
+            report.depth = depth;
+            report.nodes = nodes_;
+            report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count();
+            report.lines = lines;
+            on_iteration(report);
+        }
+
+        if (stop_) { break; }
+    }
+
+    return lines;
+}
+
+/**
+ * @brief Searches every root move `depth` plies deep, on `board` and on `thread_boards`
+ *        (one extra thread each), then re-orders `root_moves` best first and fills `lines`
+ * @return False if the iteration was stopped and `lines` already held an earlier one,
+ *         which is then left as it was.
+ */
+bool Search::searchIteration(ChessBoard& board, const std::vector<std::unique_ptr<ChessBoard>>& thread_boards, const int& depth,
+                             const size_t& line_count, std::vector<Move>& root_moves, std::vector<PVLine>& lines) {
+    const uint64_t nodes_before = nodes_;
+    std::vector<int> scores(root_moves.size(), -INFINITE_SCORE);
+    std::vector<int> top_scores; // The best exact scores so far, descending, at most `line_count`
+    std::mutex top_mutex;
+    std::atomic<size_t> next{0};
+
+    // Each worker claims the next root move. A move only needs an exact score if it
+    // can enter the top `line_count`, so it is searched with alpha = the worst of those.
+    auto worker = [&](ChessBoard& thread_board, SearchStats::Slot& stats) {
+        while (true) {
+            size_t i = next++;
+            if (i >= root_moves.size()) { return; }
+
+            int alpha = -INFINITE_SCORE;
+            {
+                std::lock_guard<std::mutex> guard(top_mutex);
+                if (top_scores.size() == line_count) { alpha = top_scores.back(); }
+            }
+
+            thread_board.makeMove(root_moves[i]);
+            int score = -negamax(thread_board, depth - 1, -INFINITE_SCORE, -alpha, 1, stats);
+            thread_board.unmakeMove();
+            if (stop_) { return; }
+
+            std::lock_guard<std::mutex> guard(top_mutex);
+            scores[i] = score;
+            if (score > alpha) {
+                top_scores.insert(std::upper_bound(top_scores.begin(), top_scores.end(), score, std::greater<int>()), score);
+                if (top_scores.size() > line_count) { top_scores.pop_back(); }
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < thread_boards.size(); t++) {
+        workers.emplace_back(worker, std::ref(*thread_boards[t]), std::ref(stats_.slot(static_cast<int>(t) + 1)));
+    }
+    worker(board, stats_.slot(0));
+    for (auto& thread : workers) { thread.join(); }
+
+    // An interrupted iteration is only used if there is nothing better to report
+    if (stop_ && !lines.empty()) { return false; }
+    stats_.recordIteration(depth, nodes_ - nodes_before);
+    const bool completed = !stop_;
+
+    // The moves the stop came before get the static evaluation after them, rather than
+    // a score no search returned (real scores are always above -INFINITE_SCORE)
+    if (!completed) {
+        for (size_t i = 0; i < root_moves.size(); i++) {
+            if (scores[i] > -INFINITE_SCORE) { continue; }
+            board.makeMove(root_moves[i]);
+            scores[i] = -Evaluation::evaluate(board);
+            board.unmakeMove();
+        }
+    }
+
+    // Re-order the root moves by score, so the next iteration starts with the best ones
+    std::vector<size_t> order(root_moves.size());
+    for (size_t i = 0; i < order.size(); i++) { order[i] = i; }
+    std::stable_sort(order.begin(), order.end(), [&scores](const size_t& a, const size_t& b) { return scores[a] > scores[b]; });
+
+    std::vector<Move> reordered;
+    for (const size_t& i : order) { reordered.push_back(root_moves[i]); }
+    root_moves.swap(reordered);
+
+    lines.clear();
+    for (size_t k = 0; k < line_count; k++) {
+        PVLine line;
+        line.score = scores[order[k]];
+        line.depth = completed ? depth : 0;
+        line.moves = principalVariation(board, root_moves[k], depth);
+        lines.push_back(line);
+    }
+    return true;
+}
+
+/**
+ * @brief Searches one more iteration of `progress` on `board`, single threaded, under
+ *        `limits` (whose depth is ignored). The table's generation is left alone, as any
+ *        number of resumable searches may share the table at once.
+ * @return True if the iteration completed: `progress` then holds its lines.
+ *         False if it was stopped (the lines are then those of the last completed
+ *         iteration, or of the interrupted first one), or there are no legal moves.
+ */
+bool Search::resume(ChessBoard& board, SearchProgress& progress, const SearchLimits& limits) {
+    PROFILE_ZONE("search");
+    limits_ = limits;
+    limits_.threads = 1;
+    limits_.ponder = false;
+    start_ = std::chrono::steady_clock::now();
+    budget_start_ = start_.time_since_epoch().count();
+    pondering_ = false;
+    nodes_ = 0;
+    stop_ = false;
+    stats_.reset(1);
+
+    if (progress.depth == 0 && progress.root_moves.empty()) {
+        progress.root_moves = board.generateMoves();
+        TranspositionTable::Entry root_entry;
+        bool root_hit = table_.probe(board.getHash(), root_entry);
+        orderMoves(board, progress.root_moves, root_hit ? &root_entry : nullptr);
+    }
+    if (progress.root_moves.empty()) { return false; }
+
+    const size_t line_count = std::clamp<size_t>(limits_.multipv, 1, progress.root_moves.size());
+    if (!searchIteration(board, {}, progress.depth + 1, line_count, progress.root_moves, progress.lines) || stop_) { return false; }
+    progress.depth++;
+    return true;
+}
@@ -0,0 +1,228 @@
+/**
+ * @class Search
+ * @brief Iterative-deepening alpha-beta search over a ChessBoard.
+ *
+ * Every iteration searches all root moves one ply deeper than the last and reports
+ * the `multipv` best of them, each with an exact score and a principal variation.
+ * Root moves are split across threads: each thread searches its own copy of the
+ * board, and all of them share one TranspositionTable.
+ *
+ * With MultiPV K, a root move only needs an exact score if it can enter the top K,
+ * so each root move is searched with alpha set to the K-th best score found so far.
+ * This keeps K > 1 close to the cost of a single-PV search.
+ *
+ * A search can also be run one iteration at a time with resume(), keeping its state in
+ * a SearchProgress between iterations (see SearchScheduler).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ChessBoard.hpp"
+#include "SearchStats.hpp"
+#include "TranspositionTable.hpp"
+
+/**
+ * The limits a search runs under. A search stops at whichever limit is reached first.
+ */
+struct SearchLimits {
+    int depth = 64;          // The deepest iteration to search
+    uint64_t nodes = 0;      // The node budget, or 0 for none
+    int64_t movetime = 0;    // The time budget in milliseconds, or 0 for none
+    bool infinite = false;   // Search until stop() is called (ignores `movetime`)
+    int multipv = 1;         // The number of best root moves to report
+    int threads = 1;         // The number of threads the root moves are split across
+    bool ponder = false;     // Ignore `movetime` until ponderhit() is called
+};
+
+/**
+ * One of the best root moves, with its score and principal variation.
+ */
+struct PVLine {
+    int score = 0;           // In centipawns, from the root player's point of view
+    std::vector<Move> moves; // The principal variation, starting with the root move
+    int depth = 0;           // The completed iteration the score comes from. 0 if the search was
+                             // stopped during the first one: the score is then that of a partly
+                             // searched iteration, or a static evaluation
+};
+
+/**
+ * A search run one iteration at a time with Search::resume(), so it can be set aside
+ * between iterations and picked up again, by any Search sharing the same table.
+ */
+struct SearchProgress {
+    std::vector<Move> root_moves; // Best first, after the first iteration
+    std::vector<PVLine> lines;    // The best lines of the last completed iteration
+    int depth = 0;                // The last completed iteration
+};
+
+/**
+ * The result of one completed iteration.
+ */
+struct SearchReport {
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t elapsed = 0;       // Milliseconds since the search started
+    std::vector<PVLine> lines; // Best line first
+};
+
+class Search {
+    public:
+        static const int INFINITE_SCORE = 32000;
+        // Mate in `n` plies scores MATE_SCORE - n
+        static const int MATE_SCORE = 30000;
+        static const int MAX_PLY = 128;
+
+    private:
+        TranspositionTable& table_;
+        SearchLimits limits_;
+        std::chrono::steady_clock::time_point start_;
+
+        std::atomic<bool> stop_;
+        std::atomic<uint64_t> nodes_;
+
+        // While pondering the time budget is not running. It starts counting at
+        // `budget_start_` (in steady_clock ticks) once ponderhit() is called.
+        std::atomic<bool> pondering_;
+        std::atomic<int64_t> budget_start_;
+
+        SearchStats stats_;
+
+        // The boards of the extra threads, kept between searches and re-seated on each
+        // search's position with setPosition(), which copies it and allocates nothing
+        std::vector<std::unique_ptr<ChessBoard>> thread_boards_;
+
+        /**
+         * @brief Counts a node and raises `stop_` once a limit is reached
+         */
+        void countNode();
+
+        /**
+         * @brief Negamax alpha-beta search of the position on `board`
+         * @param ply The distance from the root, used to score mates by their distance
+         * @param stats The statistics slot of the calling thread
+         * @return The score from the point of view of the player to move.
+         *         Meaningless if the search was stopped.
+         */
+        int negamax(ChessBoard& board, const int& depth, int alpha, int beta, const int& ply, SearchStats::Slot& stats);
+
+        /**
+         * @brief Searches captures only, until the position is quiet
+         */
+        int quiescence(ChessBoard& board, int alpha, int beta, const int& ply, SearchStats::Slot& stats);
+
+        /**
+         * @brief Searches every root move `depth` plies deep, on `board` and on `thread_boards`
+         *        (one extra thread each), then re-orders `root_moves` best first and fills `lines`
+         * @return False if the iteration was stopped and `lines` already held an earlier one,
+         *         which is then left as it was.
+         */
+        bool searchIteration(ChessBoard& board, const std::vector<std::unique_ptr<ChessBoard>>& thread_boards, const int& depth,
+                             const size_t& line_count, std::vector<Move>& root_moves, std::vector<PVLine>& lines);
+
+        /**
+         * @brief Sorts `moves` so the table's best move comes first,
+         *        then captures by most valuable victim / least valuable attacker
+         */
+        void orderMoves(const ChessBoard& board, std::vector<Move>& moves, const TranspositionTable::Entry* hint) const;
+
+        /**
+         * @brief Follows the best moves stored in the table after playing `first`
+         * @return The principal variation, starting with `first`.
+         */
+        std::vector<Move> principalVariation(ChessBoard& board, const Move& first, const int& max_length) const;
+
+        /**
+         * @brief Converts a score between "relative to the root" and "relative to this node",
+         *        which is how mate scores are kept in the table
+         */
+        static int scoreToTable(const int& score, const int& ply);
+        static int scoreFromTable(const int& score, const int& ply);
+
+    public:
+        /**
+         * @brief Constructs a search that stores its results in `table`
+         */
+        Search(TranspositionTable& table);
+
+        /**
+         * @brief Searches the position on `board` until a limit is reached or stop() is called.
+         *
+         * @param on_iteration Called after every completed iteration (may be empty)
+         * @return The best lines of the last completed iteration, best first.
+         *         Empty if the player to move has no legal moves.
+         * @post `board` is left in the same position it was passed in.
+         */
+        std::vector<PVLine> run(ChessBoard& board, const SearchLimits& limits,
+                                const std::function<void(const SearchReport&)>& on_iteration = nullptr);
+
+        /**
+         * @brief The two halves of run(), for searches started on another thread:
+         *        prepare() resets the limits, clock and stop / ponder state and should be
+         *        called before the thread starts, so an early stop() or ponderhit() is not lost.
+         *        think() then searches `board` under those limits.
+         */
+        void prepare(const SearchLimits& limits);
+        std::vector<PVLine> think(ChessBoard& board, const std::function<void(const SearchReport&)>& on_iteration = nullptr);
+
+        /**
+         * @brief Searches one more iteration of `progress` on `board`, single threaded, under
+         *        `limits` (whose depth is ignored). The table's generation is left alone, as any
+         *        number of resumable searches may share the table at once.
+         * @return True if the iteration completed: `progress` then holds its lines.
+         *         False if it was stopped (the lines are then those of the last completed
+         *         iteration, or of the interrupted first one), or there are no legal moves.
+         */
+        bool resume(ChessBoard& board, SearchProgress& progress, const SearchLimits& limits);
+
+        /**
+         * @brief Scores the position on `board` with a capture-only search, ie. the static
+         *        evaluation once every pending exchange has been played out.
+         * @return The score from the point of view of the player to move.
+         * @post `board` is left in the same position it was passed in.
+         */
+        int quiescenceScore(ChessBoard& board);
+
+        /**
+         * @brief Asks a running search to stop as soon as possible. Safe to call from any thread.
+         */
+        void stop();
+
+        /**
+         * @brief Tells a pondering search that the expected move was played: the search
+         *        carries on with everything it has learned, and its time budget starts now.
+         *        Safe to call from any thread.
+         */
+        void ponderhit();
+
+        /**
+         * @brief Determines whether the search is pondering (ie. ponderhit() has not been called yet)
+         */
+        bool isPondering() const;
+
+        /**
+         * @brief Gets the number of nodes searched by the last (or current) search
+         */
+        uint64_t nodes() const;
+
+        /**
+         * @brief Gets the statistics of the last (or current) search
+         */
+        const SearchStats& stats() const;
+
+        /**
+         * @brief Adds the memory used by the search itself (not its table) to `report`
+         */
+        void reportMemory(MemoryReport& report) const;
+
+        /**
+         * @brief Determines whether `score` means a forced mate for either player
+         */
+        static bool isMateScore(const int& score);
+};
@@ -0,0 +1,192 @@
+#include "SearchScheduler.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Constructs a scheduler with `workers` threads sharing a table of `megabytes` MiB.
+ *        Every search is answered `margin_ms` milliseconds before its deadline at the latest
+ *        (the time a search may take to notice it has to stop).
+ */
+SearchScheduler::SearchScheduler(const int& workers, const size_t& megabytes, const int64_t& margin_ms)
+    : table_{megabytes}, margin_{margin_ms * 1000}, pending_{0}, stopping_{false}, answered_{0}, late_{0} {
+    for (int i = 0; i < std::max(1, workers); i++) { workers_.emplace_back([this]() { work(); }); }
+}
+
+/**
+ * @brief Stops the workers once their current iterations end. Searches not answered
+ *        yet are dropped without a callback.
+ */
+SearchScheduler::~SearchScheduler() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) { worker.join(); }
+    for (const auto& entry : earliest_) { delete entry.second; }
+}
+
+/**
+ * @brief Puts a search back in line for a worker
+ * @pre mutex_ is held.
+ */
+void SearchScheduler::enqueue(Job* job) {
+    earliest_.emplace(job->deadline, job);
+    shallowest_.emplace(job->progress.depth, job->deadline, job);
+}
+
+/**
+ * @brief Takes a search out of line
+ * @pre mutex_ is held.
+ */
+void SearchScheduler::dequeue(Job* job) {
+    earliest_.erase({job->deadline, job});
+    shallowest_.erase({job->progress.depth, job->deadline, job});
+}
+
+/**
+ * @brief Queues a search of `position` that must be answered within `budget_ms`
+ *        milliseconds, no deeper than `max_depth`. `callback` gets the result.
+ */
+void SearchScheduler::submit(const uint64_t& game, const Position& position, const int64_t& budget_ms,
+                             const Callback& callback, int max_depth) {
+    // The board is built here rather than on a worker, which may be busy with a search
+    Job* job = new Job(game, position);
+    job->submitted = Clock::now();
+    job->deadline = job->submitted + std::chrono::milliseconds(budget_ms);
+    job->max_depth = max_depth;
+    job->callback = callback;
+
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        enqueue(job);
+        pending_++;
+    }
+    wake_.notify_one();
+}
+
+/**
+ * @brief Runs searches until the scheduler is destroyed
+ */
+void SearchScheduler::work() {
+    Search search(table_);
+    while (true) {
+        Job* job = nullptr;
+        bool answer = false;
+        int64_t slice_us = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || !earliest_.empty(); });
+            if (stopping_) { return; }
+
+            const auto now = Clock::now();
+            auto left = [this, &now](const Job* queued) {
+                return std::chrono::duration_cast<std::chrono::microseconds>(queued->deadline - now - margin_).count();
+            };
+
+            Job* earliest = earliest_.begin()->second;
+            const int64_t earliest_left = left(earliest);
+            if (earliest_left <= 0) {
+                job = earliest;
+                answer = true;
+            } else {
+                // The shallowest search whose next iteration fits before the earliest deadline.
+                // One that can not fit before its own deadline any more is answered instead.
+                for (const auto& entry : shallowest_) {
+                    Job* candidate = std::get<2>(entry);
+                    const int64_t own_left = left(candidate);
+                    const int64_t estimate = candidate->progress.depth ? candidate->last_iteration_us * BRANCHING : 0;
+                    if (candidate->progress.depth >= candidate->max_depth || estimate > own_left) {
+                        job = candidate;
+                        answer = true;
+                        break;
+                    }
+                    if (estimate <= earliest_left) {
+                        job = candidate;
+                        slice_us = std::min(own_left, earliest_left);
+                        break;
+                    }
+                }
+                // Nothing fits before the earliest deadline: that search will get no deeper
+                if (!job) {
+                    job = earliest;
+                    answer = true;
+                }
+            }
+            dequeue(job);
+        }
+        if (answer) {
+            finish(job);
+            continue;
+        }
+
+        SearchLimits limits;
+        limits.movetime = std::max<int64_t>(1, slice_us / 1000);
+        auto start = Clock::now();
+        search.resume(job->board, job->progress, limits);
+        job->last_iteration_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        job->slices++;
+        if (job->progress.root_moves.empty()) {
+            finish(job);
+            continue;
+        }
+
+        // Set aside at the iteration boundary (or, if it was stopped, to be answered when due)
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            enqueue(job);
+        }
+        wake_.notify_one();
+    }
+}
+
+/**
+ * @brief Answers `job` with the best it has found, and deletes it
+ */
+void SearchScheduler::finish(Job* job) {
+    std::unique_ptr<Job> owned(job);
+    Result result;
+    result.game = job->game;
+    result.depth = job->progress.depth;
+    result.slices = job->slices;
+    if (!job->progress.lines.empty()) {
+        result.line = job->progress.lines.front();
+    } else {
+        // Not even one iteration: the moves as ordered for the search (by the table's best move first)
+        if (job->progress.root_moves.empty()) { job->progress.root_moves = job->board.generateMoves(); }
+        if (!job->progress.root_moves.empty()) { result.line.moves.push_back(job->progress.root_moves.front()); }
+    }
+
+    const auto now = Clock::now();
+    result.latency_us = std::chrono::duration_cast<std::chrono::microseconds>(now - job->submitted).count();
+    result.late = now > job->deadline;
+    answered_++;
+    if (result.late) { late_++; }
+    if (job->callback) { job->callback(result); }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (--pending_ == 0) { idle_.notify_all(); }
+}
+
+/**
+ * @brief Waits until every submitted search has been answered, including those
+ *        submitted by the callbacks meanwhile
+ */
+void SearchScheduler::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+/**
+ * @brief Gets the number of searches answered, and how many of them were late
+ */
+std::pair<uint64_t, uint64_t> SearchScheduler::counts() const {
+    return {answered_, late_};
+}
+
+/**
+ * @brief Gets the number of worker threads
+ */
+int SearchScheduler::workerCount() const {
+    return static_cast<int>(workers_.size());
+}
@@ -0,0 +1,158 @@
+/**
+ * @class SearchScheduler
+ * @brief Finds moves for many games at once on a fixed pool of worker threads, each
+ *        move before its own deadline.
+ *
+ * Every submitted position becomes a resumable search (see Search::resume()) that is
+ * run one iteration at a time, and set aside between iterations. All the searches
+ * share one TranspositionTable.
+ *
+ * Deadlines come first: a worker answers the search with the earliest deadline as soon
+ * as that deadline is less than a safety margin away, and an iteration of any search is
+ * given no more time than is left before the earliest deadline, so the worker is back
+ * in time to answer it. Within that, iterations are handed out shallowest search first
+ * (earliest deadline first among equals), so all the games get their first iterations
+ * before any game gets a deep one. Plain earliest-deadline-first would let the first of
+ * many games with the same budget deepen until its deadline and leave the others none.
+ *
+ * An iteration that probably does not fit (it is estimated at BRANCHING times the last
+ * one) is not started: the search is answered right away if it does not fit before its
+ * own deadline, and otherwise another search runs meanwhile. The answer is the best line
+ * of the last completed iteration, or the first of the ordered moves if not even one
+ * iteration could be run in time, so every game gets a move.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "ChessBoard.hpp"
+#include "Position.hpp"
+#include "Search.hpp"
+#include "TranspositionTable.hpp"
+
+class SearchScheduler {
+    public:
+        /**
+         * The move found for a submitted position.
+         */
+        struct Result {
+            uint64_t game = 0;       // As passed to submit()
+            PVLine line;             // The best line found; no moves if the position has none
+            int depth = 0;           // The deepest completed iteration
+            int slices = 0;          // The iterations run (completed or not)
+            int64_t latency_us = 0;  // From submit() to the result
+            bool late = false;       // Whether the result came after the deadline
+        };
+
+        // Receives a result, on a worker thread
+        using Callback = std::function<void(const Result& result)>;
+
+        // How much longer the next iteration is expected to take than the last one
+        static const int BRANCHING = 4;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Job {
+            uint64_t game;
+            ChessBoard board;
+            SearchProgress progress;
+            Clock::time_point submitted;
+            Clock::time_point deadline;
+            int max_depth;
+            int slices = 0;
+            int64_t last_iteration_us = 0;
+            Callback callback;
+
+            Job(const uint64_t& id, const Position& position) : game{id}, board{position} {}
+        };
+
+        TranspositionTable table_;
+        std::chrono::microseconds margin_;
+
+        // The searches waiting for a worker (each in both), owned by the scheduler
+        std::mutex mutex_;                     // Guards the fields below, up to workers_
+        std::condition_variable wake_;
+        std::condition_variable idle_;
+        std::set<std::pair<Clock::time_point, Job*>> earliest_;          // By deadline
+        std::set<std::tuple<int, Clock::time_point, Job*>> shallowest_;  // By depth, then deadline
+        uint64_t pending_;                     // Submitted and not answered yet
+        bool stopping_;
+
+        std::vector<std::thread> workers_;
+        std::atomic<uint64_t> answered_;
+        std::atomic<uint64_t> late_;
+
+        /**
+         * @brief Puts a search back in line for a worker
+         * @pre mutex_ is held.
+         */
+        void enqueue(Job* job);
+
+        /**
+         * @brief Takes a search out of line
+         * @pre mutex_ is held.
+         */
+        void dequeue(Job* job);
+
+        /**
+         * @brief Runs searches until the scheduler is destroyed
+         */
+        void work();
+
+        /**
+         * @brief Answers `job` with the best it has found, and deletes it
+         */
+        void finish(Job* job);
+
+    public:
+        /**
+         * @brief Constructs a scheduler with `workers` threads sharing a table of `megabytes` MiB.
+         *        Every search is answered `margin_ms` milliseconds before its deadline at the latest
+         *        (the time a search may take to notice it has to stop).
+         */
+        SearchScheduler(const int& workers, const size_t& megabytes, const int64_t& margin_ms = 20);
+
+        /**
+         * @brief Stops the workers once their current iterations end. Searches not answered
+         *        yet are dropped without a callback.
+         */
+        ~SearchScheduler();
+
+        SearchScheduler(const SearchScheduler& other) = delete;
+        SearchScheduler& operator=(const SearchScheduler& other) = delete;
+
+        /**
+         * @brief Queues a search of `position` that must be answered within `budget_ms`
+         *        milliseconds, no deeper than `max_depth`. `callback` gets the result.
+         */
+        void submit(const uint64_t& game, const Position& position, const int64_t& budget_ms,
+                    const Callback& callback, int max_depth = Search::MAX_PLY);
+
+        /**
+         * @brief Waits until every submitted search has been answered, including those
+         *        submitted by the callbacks meanwhile
+         */
+        void waitIdle();
+
+        /**
+         * @brief Gets the number of searches answered, and how many of them were late
+         */
+        std::pair<uint64_t, uint64_t> counts() const;
+
+        /**
+         * @brief Gets the number of worker threads
+         */
+        int workerCount() const;
+};
@@ -0,0 +1,140 @@
+#include "SearchStats.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    // Raised by the SIGUSR1 handler (a lock-free atomic is safe to write from a signal handler)
+    std::atomic<bool> dump_requested{false};
+
+    void requestDump(int) {
+        dump_requested.store(true, std::memory_order_relaxed);
+    }
+
+    double percent(const uint64_t& part, const uint64_t& whole) {
+        return whole ? 100.0 * part / whole : 0.0;
+    }
+}
+
+/**
+ * @brief Constructs statistics with a single slot
+ */
+SearchStats::SearchStats() : slots_{new Slot[1]}, slot_count_{1} {}
+
+/**
+ * @brief Zeroes every counter and makes room for `threads` search threads
+ * @pre No search is running.
+ */
+void SearchStats::reset(const int& threads) {
+    slot_count_ = std::max(1, threads);
+    slots_.reset(new Slot[slot_count_]);
+    iteration_nodes_.clear();
+}
+
+/**
+ * @brief Gets the slot of search thread `index` (0 to the `threads` passed to reset())
+ */
+SearchStats::Slot& SearchStats::slot(const int& index) {
+    return slots_[index];
+}
+
+/**
+ * @brief Records that the iteration of `depth` searched `nodes` nodes
+ * @pre Only called from the thread running the search.
+ */
+void SearchStats::recordIteration(const int& depth, const uint64_t& nodes) {
+    if (static_cast<int>(iteration_nodes_.size()) <= depth) { iteration_nodes_.resize(depth + 1, 0); }
+    iteration_nodes_[depth] = nodes;
+}
+
+/**
+ * @brief Sums every slot
+ */
+SearchStats::Totals SearchStats::totals() const {
+    Totals totals;
+    for (int i = 0; i < slot_count_; i++) {
+        const Slot& slot = slots_[i];
+        totals.nodes += slot.nodes.load(std::memory_order_relaxed);
+        totals.qnodes += slot.qnodes.load(std::memory_order_relaxed);
+        totals.tt_probes += slot.tt_probes.load(std::memory_order_relaxed);
+        totals.tt_hits += slot.tt_hits.load(std::memory_order_relaxed);
+        totals.tt_cutoffs += slot.tt_cutoffs.load(std::memory_order_relaxed);
+        totals.beta_cutoffs += slot.beta_cutoffs.load(std::memory_order_relaxed);
+        for (int b = 0; b < CUTOFF_BUCKETS; b++) {
+            totals.cutoff_index[b] += slot.cutoff_index[b].load(std::memory_order_relaxed);
+        }
+    }
+    return totals;
+}
+
+/**
+ * @brief Gets the effective branching factor of the iteration of `depth`
+ *        (its nodes over those of the previous iteration), or 0 if unknown
+ */
+double SearchStats::branchingFactor(const int& depth) const {
+    if (depth < 2 || depth >= static_cast<int>(iteration_nodes_.size()) || !iteration_nodes_[depth - 1]) { return 0.0; }
+    return static_cast<double>(iteration_nodes_[depth]) / iteration_nodes_[depth - 1];
+}
+
+/**
+ * @brief Formats the main ratios as a UCI "info string" line
+ */
+std::string SearchStats::toInfo() const {
+    Totals totals = this->totals();
+    int last = static_cast<int>(iteration_nodes_.size()) - 1;
+
+    std::ostringstream info;
+    info << std::fixed << std::setprecision(1)
+         << "info string stats nodes " << totals.nodes << " qnodes " << totals.qnodes
+         << " tthit " << percent(totals.tt_hits, totals.tt_probes) << "%"
+         << " ttcut " << percent(totals.tt_cutoffs, totals.tt_probes) << "%"
+         << " firstcut " << percent(totals.cutoff_index[0], totals.beta_cutoffs) << "%"
+         << std::setprecision(2) << " ebf " << branchingFactor(last);
+    return info.str();
+}
+
+/**
+ * @brief Formats every counter as a single-line JSON object
+ */
+std::string SearchStats::toJSON() const {
+    Totals totals = this->totals();
+
+    std::ostringstream json;
+    json << "{\"threads\":" << slot_count_ << ",\"nodes\":" << totals.nodes << ",\"qnodes\":" << totals.qnodes
+         << ",\"tt_probes\":" << totals.tt_probes << ",\"tt_hits\":" << totals.tt_hits << ",\"tt_cutoffs\":" << totals.tt_cutoffs
+         << ",\"beta_cutoffs\":" << totals.beta_cutoffs << ",\"cutoff_index\":[";
+    for (int b = 0; b < CUTOFF_BUCKETS; b++) {
+        json << (b ? "," : "") << totals.cutoff_index[b];
+    }
+    json << "],\"iterations\":[";
+    for (size_t depth = 1; depth < iteration_nodes_.size(); depth++) {
+        json << (depth > 1 ? "," : "") << "{\"depth\":" << depth << ",\"nodes\":" << iteration_nodes_[depth]
+             << ",\"ebf\":" << std::fixed << std::setprecision(3) << branchingFactor(depth) << "}";
+    }
+    json << "]}";
+    return json.str();
+}
+
+/**
+ * @brief Adds the memory used by the statistics' slots to `report`, as "search"
+ */
+void SearchStats::reportMemory(MemoryReport& report) const {
+    report.add("search", slot_count_ * sizeof(Slot) + iteration_nodes_.capacity() * sizeof(uint64_t), 0);
+}
+
+/**
+ * @brief Installs a SIGUSR1 handler that requests a statistics dump from every running search
+ */
+void SearchStats::installSignalHandler() {
+    std::signal(SIGUSR1, requestDump);
+}
+
+/**
+ * @brief Takes a pending dump request, if there is one
+ * @return True if a dump was requested (only one caller sees each request).
+ */
+bool SearchStats::takeDumpRequest() {
+    return dump_requested.load(std::memory_order_relaxed) && dump_requested.exchange(false);
+}
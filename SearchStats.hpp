@@ -0,0 +1,132 @@
+/**
+ * @class SearchStats
+ * @brief Counters that show how well a search is pruning and ordering its moves.
+ *
+ * Every search thread counts into its own slot. Each slot starts on its own cache line, so
+ * threads never write to the same line, and counting is a plain (relaxed) load and store:
+ * no locked instruction is needed, yet the counters can be read by another thread at any time.
+ * Totals are only aggregated on demand.
+ *
+ * The counters: nodes and quiescence nodes, transposition table probes / hits / cutoffs,
+ * beta cutoffs with a histogram of the index of the move that caused them (the first move
+ * should cause most of them), and the nodes of every iteration, which give the effective
+ * branching factor by depth.
+ *
+ * A SIGUSR1 handler can be installed that asks the running searches to dump their
+ * statistics as JSON (see Search: the dump is written from the search itself, as a signal
+ * handler can not safely format output).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MemoryReport.hpp"
+
+class SearchStats {
+    public:
+        // Cutoffs by move index: 0, 1, ... CUTOFF_BUCKETS - 2, and the last bucket for every later move
+        static const int CUTOFF_BUCKETS = 8;
+
+        /**
+         * The counters of one search thread, alone on its cache line(s).
+         */
+        struct alignas(64) Slot {
+            std::atomic<uint64_t> nodes{0};
+            std::atomic<uint64_t> qnodes{0};
+            std::atomic<uint64_t> tt_probes{0};
+            std::atomic<uint64_t> tt_hits{0};
+            std::atomic<uint64_t> tt_cutoffs{0};
+            std::atomic<uint64_t> beta_cutoffs{0};
+            std::atomic<uint64_t> cutoff_index[CUTOFF_BUCKETS] = {};
+
+            /**
+             * @brief Adds one to `counter`. Only the slot's own thread may call it.
+             */
+            static void bump(std::atomic<uint64_t>& counter) {
+                counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        };
+
+        /**
+         * The sums over every slot.
+         */
+        struct Totals {
+            uint64_t nodes = 0;
+            uint64_t qnodes = 0;
+            uint64_t tt_probes = 0;
+            uint64_t tt_hits = 0;
+            uint64_t tt_cutoffs = 0;
+            uint64_t beta_cutoffs = 0;
+            uint64_t cutoff_index[CUTOFF_BUCKETS] = {};
+        };
+
+    private:
+        std::unique_ptr<Slot[]> slots_;
+        int slot_count_;
+        std::vector<uint64_t> iteration_nodes_; // Nodes searched by the iteration of each depth (index 0 unused)
+
+    public:
+        /**
+         * @brief Constructs statistics with a single slot
+         */
+        SearchStats();
+
+        /**
+         * @brief Zeroes every counter and makes room for `threads` search threads
+         * @pre No search is running.
+         */
+        void reset(const int& threads);
+
+        /**
+         * @brief Gets the slot of search thread `index` (0 to the `threads` passed to reset())
+         */
+        Slot& slot(const int& index);
+
+        /**
+         * @brief Records that the iteration of `depth` searched `nodes` nodes
+         * @pre Only called from the thread running the search.
+         */
+        void recordIteration(const int& depth, const uint64_t& nodes);
+
+        /**
+         * @brief Sums every slot
+         */
+        Totals totals() const;
+
+        /**
+         * @brief Gets the effective branching factor of the iteration of `depth`
+         *        (its nodes over those of the previous iteration), or 0 if unknown
+         */
+        double branchingFactor(const int& depth) const;
+
+        /**
+         * @brief Formats the main ratios as a UCI "info string" line
+         */
+        std::string toInfo() const;
+
+        /**
+         * @brief Formats every counter as a single-line JSON object
+         */
+        std::string toJSON() const;
+
+        /**
+         * @brief Adds the memory used by the statistics' slots to `report`, as "search"
+         */
+        void reportMemory(MemoryReport& report) const;
+
+        /**
+         * @brief Installs a SIGUSR1 handler that requests a statistics dump from every running search
+         */
+        static void installSignalHandler();
+
+        /**
+         * @brief Takes a pending dump request, if there is one
+         * @return True if a dump was requested (only one caller sees each request).
+         */
+        static bool takeDumpRequest();
+};
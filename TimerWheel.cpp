@@ -0,0 +1,161 @@
+#include "TimerWheel.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Constructs an empty wheel whose time starts at tick `now`
+ */
+TimerWheel::TimerWheel(const uint64_t& now) : free_{NIL}, now_{now}, armed_{0} {
+    std::fill(std::begin(heads_), std::end(heads_), NIL);
+}
+
+/**
+ * @brief Links an armed timer into the slot its deadline falls in
+ */
+void TimerWheel::place(const uint32_t& index) {
+    Timer& timer = timers_[index];
+
+    // Slots are relative to the next tick to process
+    const uint64_t base = now_ + 1;
+    const uint64_t horizon = uint64_t(1) << (SLOT_BITS * LEVELS);
+    uint64_t expires = std::max(timer.deadline, base);
+    if (expires - base >= horizon) { expires = base + horizon - 1; }
+
+    int level = 0;
+    while ((expires - base) >> (SLOT_BITS * (level + 1))) { level++; }
+    const int slot = level * SLOTS + static_cast<int>((expires >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+    timer.slot = static_cast<uint16_t>(slot);
+    timer.prev = NIL;
+    timer.next = heads_[slot];
+    if (heads_[slot] != NIL) { timers_[heads_[slot]].prev = index; }
+    heads_[slot] = index;
+}
+
+/**
+ * @brief Unlinks a timer from its slot
+ */
+void TimerWheel::unlink(const uint32_t& index) {
+    Timer& timer = timers_[index];
+    if (timer.prev != NIL) { timers_[timer.prev].next = timer.next; }
+    else { heads_[timer.slot] = timer.next; }
+    if (timer.next != NIL) { timers_[timer.next].prev = timer.prev; }
+}
+
+/**
+ * @brief Moves the timers of slot `slot` of level `level` into the lower levels
+ */
+void TimerWheel::cascade(const int& level, const int& slot) {
+    uint32_t index = heads_[level * SLOTS + slot];
+    heads_[level * SLOTS + slot] = NIL;
+    while (index != NIL) {
+        const uint32_t next = timers_[index].next;
+        place(index);
+        index = next;
+    }
+}
+
+/**
+ * @brief Arms a timer that expires at tick `deadline` (at the next advance if that has passed)
+ * @return Its id, to cancel it.
+ */
+TimerWheel::TimerId TimerWheel::arm(const uint64_t& deadline, const uint64_t& payload) {
+    uint32_t index;
+    if (free_ != NIL) {
+        index = free_;
+        free_ = timers_[index].next;
+    } else {
+        index = static_cast<uint32_t>(timers_.size());
+        timers_.emplace_back();
+    }
+
+    Timer& timer = timers_[index];
+    timer.deadline = deadline;
+    timer.payload = payload;
+    timer.armed = true;
+    place(index);
+    armed_++;
+    return index | (static_cast<TimerId>(timer.generation) << 32);
+}
+
+/**
+ * @brief Cancels a timer
+ * @return False if it has already expired or been canceled.
+ */
+bool TimerWheel::cancel(const TimerId& id) {
+    const uint32_t index = static_cast<uint32_t>(id);
+    if (id == NONE || index >= timers_.size()) { return false; }
+
+    Timer& timer = timers_[index];
+    if (!timer.armed || timer.generation != static_cast<uint32_t>(id >> 32)) { return false; }
+
+    unlink(index);
+    timer.armed = false;
+    timer.generation++;
+    timer.next = free_;
+    free_ = index;
+    armed_--;
+    return true;
+}
+
+/**
+ * @brief Advances the time to tick `now`, appending the payloads of the timers that
+ *        expire to `expired` (in deadline order, give or take the ticks of one slot)
+ * @return The number of timers that expired.
+ */
+size_t TimerWheel::advance(const uint64_t& now, std::vector<uint64_t>& expired) {
+    size_t count = 0;
+    while (now_ < now) {
+        // Nothing to expire or cascade: jump straight to the end
+        if (!armed_) {
+            now_ = now;
+            break;
+        }
+
+        const uint64_t tick = now_ + 1;
+        for (int level = 1; level < LEVELS; level++) {
+            // The wheel below has just turned over, so its next span comes down from this level
+            if ((tick >> (SLOT_BITS * (level - 1))) & (SLOTS - 1)) { break; }
+            cascade(level, static_cast<int>((tick >> (SLOT_BITS * level)) & (SLOTS - 1)));
+        }
+
+        const int slot = static_cast<int>(tick & (SLOTS - 1));
+        uint32_t index = heads_[slot];
+        heads_[slot] = NIL;
+        while (index != NIL) {
+            Timer& timer = timers_[index];
+            const uint32_t next = timer.next;
+            expired.push_back(timer.payload);
+            timer.armed = false;
+            timer.generation++;
+            timer.next = free_;
+            free_ = index;
+            armed_--;
+            count++;
+            index = next;
+        }
+        now_ = tick;
+    }
+    return count;
+}
+
+/**
+ * @brief Gets the current tick
+ */
+uint64_t TimerWheel::now() const {
+    return now_;
+}
+
+/**
+ * @brief Gets the number of armed timers
+ */
+size_t TimerWheel::size() const {
+    return armed_;
+}
+
+/**
+ * @brief Adds the memory used by the timers to `report`, as "timers"
+ */
+void TimerWheel::reportMemory(MemoryReport& report) const {
+    report.add("timers", sizeof(*this) + timers_.capacity() * sizeof(Timer), armed_);
+}
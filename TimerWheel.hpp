@@ -0,0 +1,110 @@
+/**
+ * @class TimerWheel
+ * @brief Holds a large number of timers, with constant time arm and cancel and expiry
+ *        in batches as time advances.
+ *
+ * A hierarchical timing wheel: LEVELS wheels of SLOTS slots each, where a slot of level l
+ * spans SLOTS^l ticks. A timer goes into the lowest level whose range covers its
+ * deadline; when the wheel below has turned once, the next slot of the level above is
+ * emptied into the lower levels ("cascaded"), so every timer is moved at most LEVELS - 1
+ * times before it expires. Timers live in one pool and the slots are intrusive doubly
+ * linked lists of pool indices, so arming and canceling allocate nothing once the pool
+ * has grown.
+ *
+ * Time is counted in ticks, whose length is up to the owner. Deadlines more than
+ * SLOTS^LEVELS ticks ahead expire at that horizon instead.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "MemoryReport.hpp"
+
+class TimerWheel {
+    public:
+        // Names an armed timer: its pool index in the low 32 bits and the index's generation above
+        typedef uint64_t TimerId;
+
+        static const int LEVELS = 4;
+        static const int SLOT_BITS = 8;
+        static const int SLOTS = 1 << SLOT_BITS;
+
+        // Never the id of a timer
+        static const TimerId NONE = ~uint64_t(0);
+
+    private:
+        static const uint32_t NIL = ~uint32_t(0);
+
+        struct Timer {
+            uint64_t deadline = 0;
+            uint64_t payload = 0;
+            uint32_t prev = NIL;
+            uint32_t next = NIL;     // Also links the free timers
+            uint32_t generation = 0; // Bumped every time the timer expires or is canceled
+            uint16_t slot = 0;       // level * SLOTS + slot index, while armed
+            bool armed = false;
+        };
+
+        std::vector<Timer> timers_;
+        uint32_t free_;
+        uint32_t heads_[LEVELS * SLOTS];
+        uint64_t now_;
+        size_t armed_;
+
+        /**
+         * @brief Links an armed timer into the slot its deadline falls in
+         */
+        void place(const uint32_t& index);
+
+        /**
+         * @brief Unlinks a timer from its slot
+         */
+        void unlink(const uint32_t& index);
+
+        /**
+         * @brief Moves the timers of slot `slot` of level `level` into the lower levels
+         */
+        void cascade(const int& level, const int& slot);
+
+    public:
+        /**
+         * @brief Constructs an empty wheel whose time starts at tick `now`
+         */
+        explicit TimerWheel(const uint64_t& now = 0);
+
+        /**
+         * @brief Arms a timer that expires at tick `deadline` (at the next advance if that has passed)
+         * @return Its id, to cancel it.
+         */
+        TimerId arm(const uint64_t& deadline, const uint64_t& payload);
+
+        /**
+         * @brief Cancels a timer
+         * @return False if it has already expired or been canceled.
+         */
+        bool cancel(const TimerId& id);
+
+        /**
+         * @brief Advances the time to tick `now`, appending the payloads of the timers that
+         *        expire to `expired` (in deadline order, give or take the ticks of one slot)
+         * @return The number of timers that expired.
+         */
+        size_t advance(const uint64_t& now, std::vector<uint64_t>& expired);
+
+        /**
+         * @brief Gets the current tick
+         */
+        uint64_t now() const;
+
+        /**
+         * @brief Gets the number of armed timers
+         */
+        size_t size() const;
+
+        /**
+         * @brief Adds the memory used by the timers to `report`, as "timers"
+         */
+        void reportMemory(MemoryReport& report) const;
+};
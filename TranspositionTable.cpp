@@ -0,0 +1,162 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+
+#include "AllocationTracker.hpp"
+#include "Profiler.hpp"
+
+namespace {
+    /*
+    Layout of a packed slot:
+        bits  0-5  : from square (row * 8 + col)
+        bits  6-11 : to square
+        bit   12   : has move
+        bits 13-14 : bound
+        bits 16-23 : depth
+        bits 24-31 : generation
+        bits 32-47 : score (as a 16 bit two's complement integer)
+    */
+    int unpackDepth(const uint64_t& data) { return static_cast<int>((data >> 16) & 0xFF); }
+    uint8_t unpackGeneration(const uint64_t& data) { return static_cast<uint8_t>((data >> 24) & 0xFF); }
+}
+
+/**
+ * @brief Constructs a table that uses `megabytes` MiB
+ */
+TranspositionTable::TranspositionTable(const size_t& megabytes) : slot_count_{0}, generation_{0} {
+    resize(megabytes);
+}
+
+/**
+ * @brief Reallocates the table to use `megabytes` MiB
+ * @post All entries are removed
+ * @pre No search is using the table
+ */
+void TranspositionTable::resize(const size_t& megabytes) {
+    // Keep an even number of slots, as slots are used in pairs
+    slot_count_ = std::max<size_t>(2, ((megabytes << 20) / sizeof(Slot)) & ~static_cast<size_t>(1));
+    slots_.reset(new Slot[slot_count_]);
+    clear();
+}
+
+/**
+ * @brief Removes every entry
+ * @pre No search is using the table
+ */
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < slot_count_; i++) {
+        slots_[i].checked_key.store(0, std::memory_order_relaxed);
+        slots_[i].data.store(0, std::memory_order_relaxed);
+    }
+    generation_ = 0;
+}
+
+/**
+ * @brief Marks the start of a new search: entries stored before now are considered stale
+ */
+void TranspositionTable::newSearch() {
+    generation_++;
+}
+
+/**
+ * @brief Packs a result into one 64 bit word
+ */
+uint64_t TranspositionTable::pack(const int& score, const int& depth, const Bound& bound, const Move* best_move) const {
+    uint64_t data = 0;
+    if (best_move) {
+        Square from = best_move->getOriginalPosition();
+        Square to = best_move->getTargetPosition();
+        data |= static_cast<uint64_t>(from.first * 8 + from.second);
+        data |= static_cast<uint64_t>(to.first * 8 + to.second) << 6;
+        data |= 1ULL << 12;
+    }
+    data |= static_cast<uint64_t>(bound) << 13;
+    data |= static_cast<uint64_t>(std::clamp(depth, 0, 255)) << 16;
+    data |= static_cast<uint64_t>(generation_) << 24;
+    data |= static_cast<uint64_t>(static_cast<uint16_t>(static_cast<int16_t>(score))) << 32;
+    return data;
+}
+
+/**
+ * @brief Looks up the position with the given key
+ * @param entry Set to the stored result if found
+ * @return True if the position was found.
+ */
+bool TranspositionTable::probe(const uint64_t& key, Entry& entry) const {
+    PROFILE_ZONE("tt_probe");
+    NO_ALLOC_SCOPE("tt_probe");
+    size_t index = static_cast<size_t>(key % slot_count_) & ~static_cast<size_t>(1);
+    for (size_t i = index; i < index + 2; i++) {
+        uint64_t data = slots_[i].data.load(std::memory_order_relaxed);
+        uint64_t checked_key = slots_[i].checked_key.load(std::memory_order_relaxed);
+        if ((checked_key ^ data) != key || data == 0) { continue; }
+
+        entry.has_move = (data >> 12) & 1;
+        entry.from = {static_cast<int>(data & 63) / 8, static_cast<int>(data & 63) % 8};
+        entry.to = {static_cast<int>((data >> 6) & 63) / 8, static_cast<int>((data >> 6) & 63) % 8};
+        entry.bound = static_cast<Bound>((data >> 13) & 3);
+        entry.depth = unpackDepth(data);
+        entry.score = static_cast<int16_t>(static_cast<uint16_t>(data >> 32));
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Stores a search result for the position with the given key.
+ *        Each key maps to a bucket of two slots: the slot already holding the key is
+ *        overwritten, otherwise the shallower / staler of the two is replaced.
+ *
+ * @param score The score, which must fit in 16 bits.
+ * @param depth The depth searched, in [0, 255].
+ * @param best_move The best move found, or nullptr if there is none.
+ */
+void TranspositionTable::store(const uint64_t& key, const int& score, const int& depth, const Bound& bound, const Move* best_move) {
+    NO_ALLOC_SCOPE("tt_store");
+    size_t index = static_cast<size_t>(key % slot_count_) & ~static_cast<size_t>(1);
+
+    // Stale entries count as 4 plies shallower per search they have survived
+    auto worth = [this](const uint64_t& data) {
+        uint8_t age = static_cast<uint8_t>(generation_ - unpackGeneration(data));
+        return unpackDepth(data) - 4 * static_cast<int>(age);
+    };
+
+    // Prefer the slot already holding this key, then an empty slot, then the least valuable one
+    size_t victim = index + 2;
+    for (size_t i = index; i < index + 2 && victim == index + 2; i++) {
+        uint64_t data = slots_[i].data.load(std::memory_order_relaxed);
+        if ((slots_[i].checked_key.load(std::memory_order_relaxed) ^ data) == key) { victim = i; }
+    }
+    if (victim == index + 2) {
+        uint64_t first = slots_[index].data.load(std::memory_order_relaxed);
+        uint64_t second = slots_[index + 1].data.load(std::memory_order_relaxed);
+        if (first == 0) { victim = index; }
+        else if (second == 0) { victim = index + 1; }
+        else { victim = (worth(second) < worth(first)) ? index + 1 : index; }
+    }
+
+    uint64_t data = pack(score, depth, bound, best_move);
+    slots_[victim].checked_key.store(key ^ data, std::memory_order_relaxed);
+    slots_[victim].data.store(data, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Estimates how full the table is by sampling the first slots
+ * @return The number of slots used by the current search, per thousand.
+ */
+int TranspositionTable::hashfull() const {
+    size_t samples = std::min<size_t>(1000, slot_count_);
+    int used = 0;
+    for (size_t i = 0; i < samples; i++) {
+        uint64_t data = slots_[i].data.load(std::memory_order_relaxed);
+        if (data && unpackGeneration(data) == generation_) { used++; }
+    }
+    return static_cast<int>(used * 1000 / samples);
+}
+
+/**
+ * @brief Adds the memory used by the table to `report`
+ */
+void TranspositionTable::reportMemory(MemoryReport& report) const {
+    report.add("transposition table", sizeof(TranspositionTable) + slot_count_ * sizeof(Slot));
+}
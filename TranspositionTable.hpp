@@ -0,0 +1,103 @@
+/**
+ * @class TranspositionTable
+ * @brief A fixed-size hash table of search results, shared by all search threads.
+ *
+ * Each slot holds two 64 bit words: the packed result, and the position key XOR-ed
+ * with that result. Threads read and write slots without locks; a slot torn by two
+ * concurrent writers no longer validates (key ^ data != key) and is treated as a miss.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "MemoryReport.hpp"
+#include "Move.hpp"
+
+class TranspositionTable {
+    public:
+        // How the stored score relates to the true score of the position
+        enum Bound : uint8_t { BOUND_NONE = 0, BOUND_UPPER = 1, BOUND_LOWER = 2, BOUND_EXACT = 3 };
+
+        /**
+         * A decoded slot, as returned by probe().
+         */
+        struct Entry {
+            int score = 0;
+            int depth = 0;
+            Bound bound = BOUND_NONE;
+            bool has_move = false; // Whether `from` / `to` hold the best move found
+            Square from;
+            Square to;
+        };
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> checked_key; // key ^ data
+            std::atomic<uint64_t> data;
+        };
+
+        std::unique_ptr<Slot[]> slots_;
+        size_t slot_count_;
+        uint8_t generation_; // Bumped by newSearch(), so entries from older searches are replaced first
+
+        /**
+         * @brief Packs a result into one 64 bit word
+         */
+        uint64_t pack(const int& score, const int& depth, const Bound& bound, const Move* best_move) const;
+
+    public:
+        /**
+         * @brief Constructs a table that uses `megabytes` MiB
+         */
+        TranspositionTable(const size_t& megabytes = 16);
+
+        /**
+         * @brief Reallocates the table to use `megabytes` MiB
+         * @post All entries are removed
+         * @pre No search is using the table
+         */
+        void resize(const size_t& megabytes);
+
+        /**
+         * @brief Removes every entry
+         * @pre No search is using the table
+         */
+        void clear();
+
+        /**
+         * @brief Marks the start of a new search: entries stored before now are considered stale
+         */
+        void newSearch();
+
+        /**
+         * @brief Looks up the position with the given key
+         * @param entry Set to the stored result if found
+         * @return True if the position was found.
+         */
+        bool probe(const uint64_t& key, Entry& entry) const;
+
+        /**
+         * @brief Stores a search result for the position with the given key.
+         *        Each key maps to a bucket of two slots: the slot already holding the key is
+         *        overwritten, otherwise the shallower / staler of the two is replaced.
+         *
+         * @param score The score, which must fit in 16 bits.
+         * @param depth The depth searched, in [0, 255].
+         * @param best_move The best move found, or nullptr if there is none.
+         */
+        void store(const uint64_t& key, const int& score, const int& depth, const Bound& bound, const Move* best_move);
+
+        /**
+         * @brief Estimates how full the table is by sampling the first slots
+         * @return The number of slots used by the current search, per thousand.
+         */
+        int hashfull() const;
+
+        /**
+         * @brief Adds the memory used by the table to `report`
+         */
+        void reportMemory(MemoryReport& report) const;
+};
@@ -0,0 +1,267 @@
+#include "UCI.hpp"
+
+#include "Notation.hpp"
+
+/**
+ * @brief Constructs a front-end that writes its replies to `out`
+ */
+UCI::UCI(std::ostream& out) : table_{16}, search_{table_}, threads_{1}, multipv_{1}, infinite_{false}, pondering_{false}, out_{out} {}
+
+/**
+ * @brief Destructor.
+ * @post Any running search is stopped and joined.
+ */
+UCI::~UCI() {
+    stopSearch();
+}
+
+/**
+ * @brief Writes one line to `out_` and flushes it
+ */
+void UCI::send(const std::string& line) {
+    std::lock_guard<std::mutex> guard(out_mutex_);
+    out_ << line << std::endl;
+}
+
+/**
+ * @brief Stops the running search (if any) and waits for it to report its best move
+ */
+void UCI::stopSearch() {
+    if (!search_thread_.joinable()) { return; }
+    search_.stop();
+    endPonder();
+    search_thread_.join();
+}
+
+/**
+ * @brief Ends pondering (if active), letting the search thread send its best move
+ */
+void UCI::endPonder() {
+    {
+        std::lock_guard<std::mutex> guard(ponder_mutex_);
+        pondering_ = false;
+    }
+    ponder_cv_.notify_all();
+}
+
+/**
+ * @brief Formats a score as "cp <centipawns>" or "mate <moves>"
+ */
+std::string UCI::formatScore(const int& score) {
+    if (!Search::isMateScore(score)) { return "cp " + std::to_string(score); }
+
+    // Mate scores count plies; UCI counts moves, negative when being mated
+    int plies = Search::MATE_SCORE - std::abs(score);
+    int moves = (plies + 1) / 2;
+    return "mate " + std::to_string(score > 0 ? moves : -moves);
+}
+
+/**
+ * @brief Formats an iteration's lines as "info" lines
+ */
+void UCI::report(const SearchReport& report) {
+    int64_t nps = report.elapsed ? static_cast<int64_t>(report.nodes * 1000 / report.elapsed) : 0;
+    for (size_t i = 0; i < report.lines.size(); i++) {
+        std::ostringstream info;
+        info << "info depth " << report.depth << " multipv " << (i + 1)
+             << " score " << formatScore(report.lines[i].score)
+             << " nodes " << report.nodes << " nps " << nps << " time " << report.elapsed
+             << " hashfull " << table_.hashfull() << " pv";
+        for (const Move& move : report.lines[i].moves) { info << " " << move.toUCI(); }
+        send(info.str());
+    }
+    send(search_.stats().toInfo());
+}
+
+/**
+ * @brief Handles "setoption name <name> value <value>"
+ */
+void UCI::setOption(std::istringstream& args) {
+    std::string token, name, value;
+    args >> token; // "name"
+    while (args >> token && token != "value") { name += (name.empty() ? "" : " ") + token; }
+    args >> value;
+
+    try {
+        if (name == "Hash") {
+            table_.resize(std::max(1, std::stoi(value)));
+        } else if (name == "Threads") {
+            threads_ = std::max(1, std::stoi(value));
+        } else if (name == "MultiPV") {
+            multipv_ = std::max(1, std::stoi(value));
+        } else if (name == "Ponder") {
+            // Nothing to configure: pondering is driven by "go ponder"
+        } else {
+            send("info string unknown option " + name);
+        }
+    } catch (const std::exception&) {
+        send("info string invalid value for " + name);
+    }
+}
+
+/**
+ * @brief Handles "position [startpos | fen <fen>] [moves <move> ...]"
+ * @return False if the position or one of the moves was invalid.
+ */
+bool UCI::position(std::istringstream& args) {
+    std::string token, fen;
+    args >> token;
+    if (token == "startpos") {
+        fen = ChessBoard::STARTING_FEN;
+        args >> token; // "moves", if any
+    } else if (token == "fen") {
+        while (args >> token && token != "moves") { fen += (fen.empty() ? "" : " ") + token; }
+    } else {
+        return false;
+    }
+
+    if (!board_.loadFEN(fen)) {
+        send("info string invalid fen " + fen);
+        return false;
+    }
+
+    while (args >> token) {
+        std::vector<Move> moves = board_.generateMoves();
+        int index = Notation::findMove(board_, moves, token);
+        if (index < 0) {
+            send("info string illegal move " + token);
+            return false;
+        }
+        board_.makeMove(moves[index]);
+    }
+    return true;
+}
+
+/**
+ * @brief Handles "go [depth d] [nodes n] [movetime ms] [wtime ms] [btime ms] [winc ms] [binc ms] [movestogo n] [infinite] [ponder]"
+ */
+void UCI::go(std::istringstream& args) {
+    SearchLimits limits;
+    limits.multipv = multipv_;
+    limits.threads = threads_;
+
+    int64_t time_left[2] = {0, 0};
+    int64_t increment[2] = {0, 0};
+    int moves_to_go = 30;
+
+    std::string token;
+    while (args >> token) {
+        if (token == "depth") { args >> limits.depth; }
+        else if (token == "nodes") { args >> limits.nodes; }
+        else if (token == "movetime") { args >> limits.movetime; }
+        else if (token == "infinite") { limits.infinite = true; }
+        else if (token == "ponder") { limits.ponder = true; }
+        else if (token == "wtime") { args >> time_left[0]; }
+        else if (token == "btime") { args >> time_left[1]; }
+        else if (token == "winc") { args >> increment[0]; }
+        else if (token == "binc") { args >> increment[1]; }
+        else if (token == "movestogo") { args >> moves_to_go; }
+    }
+
+    // Spend an even share of the remaining clock, plus most of the increment
+    int side = board_.isPlayerOneTurn() ? 0 : 1;
+    if (!limits.movetime && time_left[side] > 0) {
+        limits.movetime = std::max<int64_t>(1, time_left[side] / std::max(1, moves_to_go) + increment[side] * 3 / 4);
+        limits.movetime = std::min(limits.movetime, std::max<int64_t>(1, time_left[side] - 50));
+    }
+
+    // The clock only starts for a ponder search once "ponderhit" arrives, so the
+    // budget computed above (for the position after the expected move) still applies
+    {
+        std::lock_guard<std::mutex> guard(ponder_mutex_);
+        pondering_ = limits.ponder;
+    }
+    infinite_ = limits.infinite;
+    search_.prepare(limits);
+
+    search_thread_ = std::thread([this]() {
+        std::vector<PVLine> lines = search_.think(board_, [this](const SearchReport& iteration) { report(iteration); });
+
+        // A ponder search that finished early waits for "ponderhit" or "stop" before answering
+        {
+            std::unique_lock<std::mutex> lock(ponder_mutex_);
+            ponder_cv_.wait(lock, [this]() { return !pondering_; });
+        }
+
+        if (lines.empty()) {
+            send("bestmove 0000");
+            return;
+        }
+
+        std::string bestmove = "bestmove " + lines[0].moves[0].toUCI();
+        if (lines[0].moves.size() > 1) { bestmove += " ponder " + lines[0].moves[1].toUCI(); }
+        send(bestmove);
+    });
+}
+
+/**
+ * @brief Handles a single command line
+ * @return False if the command was "quit".
+ */
+bool UCI::execute(const std::string& command) {
+    std::istringstream args(command);
+    std::string token;
+    if (!(args >> token)) { return true; }
+
+    if (token == "uci") {
+        send("id name ChessProject");
+        send("id author ChessProject developers");
+        send("option name Hash type spin default 16 min 1 max 4096");
+        send("option name Threads type spin default 1 min 1 max 256");
+        send("option name MultiPV type spin default 1 min 1 max 256");
+        send("option name Ponder type check default false");
+        send("uciok");
+    } else if (token == "isready") {
+        send("readyok");
+    } else if (token == "setoption") {
+        stopSearch();
+        setOption(args);
+    } else if (token == "ucinewgame") {
+        stopSearch();
+        table_.clear();
+    } else if (token == "position") {
+        stopSearch();
+        position(args);
+    } else if (token == "go") {
+        stopSearch();
+        go(args);
+    } else if (token == "ponderhit") {
+        search_.ponderhit();
+        endPonder();
+    } else if (token == "stop") {
+        stopSearch();
+    } else if (token == "d") {
+        stopSearch();
+        send(board_.toFEN());
+    } else if (token == "memstats") {
+        stopSearch();
+        MemoryReport report;
+        board_.reportMemory(report);
+        table_.reportMemory(report);
+        search_.reportMemory(report);
+        std::stringstream lines;
+        report.write(lines, "info string memory ");
+        for (std::string line; std::getline(lines, line);) { send(line); }
+    } else if (token == "quit") {
+        stopSearch();
+        return false;
+    } else {
+        send("info string unknown command " + token);
+    }
+    return true;
+}
+
+/**
+ * @brief Reads and handles commands from `in` until "quit" or the end of the input
+ */
+void UCI::loop(std::istream& in) {
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!execute(line)) { return; }
+    }
+
+    // Let a search started by the last command finish before returning, unless it is
+    // pondering or infinite (which would never finish on their own)
+    if (search_.isPondering() || infinite_) { stopSearch(); }
+    if (search_thread_.joinable()) { search_thread_.join(); }
+}
@@ -0,0 +1,120 @@
+/**
+ * @class UCI
+ * @brief A Universal Chess Interface (UCI) front-end for the engine.
+ *
+ * Reads commands line by line ("uci", "position", "go", "stop", ...) and writes
+ * the engine's replies. Searches run on a background thread, so "stop" and "quit"
+ * are handled while the engine is thinking.
+ *
+ * Supported options: Hash (MiB), Threads, MultiPV and Ponder. With MultiPV K, every
+ * iteration reports K "info ... multipv i ..." lines.
+ *
+ * Pondering: "go ponder" searches the position after the move the engine expects
+ * the opponent to play, without a running clock. "ponderhit" turns it into a normal
+ * search (keeping everything learned so far) and "stop" abandons it. The
+ * transposition table is kept between moves, so a ponder miss still reuses whatever
+ * the ponder search learned about the position actually reached.
+ *
+ * Moves are written in coordinate notation (see Move::toUCI()) and positions in the
+ * FEN conventions of ChessBoard::loadFEN(). Incoming moves may also be given in SAN.
+ *
+ * Debugging commands outside the protocol: "d" prints the position as FEN and "memstats"
+ * the memory used by the board, the table and the search, as "info string memory" lines.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "ChessBoard.hpp"
+#include "Search.hpp"
+#include "TranspositionTable.hpp"
+
+class UCI {
+    private:
+        ChessBoard board_;
+        TranspositionTable table_;
+        Search search_;
+        std::thread search_thread_;
+
+        int threads_;
+        int multipv_;
+        bool infinite_; // The last "go" was "go infinite", which only ends on "stop"
+
+        // While pondering, the best move must not be sent until "ponderhit" or "stop"
+        bool pondering_;
+        std::mutex ponder_mutex_;
+        std::condition_variable ponder_cv_;
+
+        /**
+         * @brief Ends pondering (if active), letting the search thread send its best move
+         */
+        void endPonder();
+
+        std::ostream& out_;
+        std::mutex out_mutex_; // The search thread and the command loop both write to `out_`
+
+        /**
+         * @brief Writes one line to `out_` and flushes it
+         */
+        void send(const std::string& line);
+
+        /**
+         * @brief Stops the running search (if any) and waits for it to report its best move
+         */
+        void stopSearch();
+
+        /**
+         * @brief Handles "setoption name <name> value <value>"
+         */
+        void setOption(std::istringstream& args);
+
+        /**
+         * @brief Handles "position [startpos | fen <fen>] [moves <move> ...]"
+         * @return False if the position or one of the moves was invalid.
+         */
+        bool position(std::istringstream& args);
+
+        /**
+         * @brief Handles "go [depth d] [nodes n] [movetime ms] [wtime ms] [btime ms] [winc ms] [binc ms] [movestogo n] [infinite] [ponder]"
+         */
+        void go(std::istringstream& args);
+
+        /**
+         * @brief Formats an iteration's lines as "info" lines
+         */
+        void report(const SearchReport& report);
+
+    public:
+        /**
+         * @brief Constructs a front-end that writes its replies to `out`
+         */
+        UCI(std::ostream& out = std::cout);
+
+        /**
+         * @brief Destructor.
+         * @post Any running search is stopped and joined.
+         */
+        ~UCI();
+
+        /**
+         * @brief Reads and handles commands from `in` until "quit" or the end of the input
+         */
+        void loop(std::istream& in);
+
+        /**
+         * @brief Handles a single command line
+         * @return False if the command was "quit".
+         */
+        bool execute(const std::string& command);
+
+        /**
+         * @brief Formats a score as "cp <centipawns>" or "mate <moves>"
+         */
+        static std::string formatScore(const int& score);
+};
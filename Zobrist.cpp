@@ -0,0 +1,53 @@
+#include "Zobrist.hpp"
+
+namespace {
+    /*
+    Keys are generated once from a fixed seed so hashes are identical between runs.
+    */
+    struct ZobristTable {
+        uint64_t pieces[Zobrist::PIECE_KINDS][64];
+        uint64_t side;
+
+        ZobristTable() {
+            uint64_t state = 0x9E3779B97F4A7C15ULL;
+            // splitmix64
+            auto next = [&state]() {
+                uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                return z ^ (z >> 31);
+            };
+
+            for (int kind = 0; kind < Zobrist::PIECE_KINDS; kind++) {
+                for (int square = 0; square < 64; square++) {
+                    pieces[kind][square] = next();
+                }
+            }
+            side = next();
+        }
+    };
+
+    const ZobristTable& table() {
+        static const ZobristTable keys;
+        return keys;
+    }
+}
+
+/**
+ * Gets the key for a piece kind standing on the cell (row, col).
+ *
+ * @param kind The piece kind index, in [0, PIECE_KINDS)
+ * @param row The row of the cell, in [0, 8)
+ * @param col The column of the cell, in [0, 8)
+ * @return The 64 bit key for that piece on that cell.
+ */
+uint64_t Zobrist::pieceKey(const int& kind, const int& row, const int& col) {
+    return table().pieces[kind][row * 8 + col];
+}
+
+/**
+ * Gets the key that is XOR-ed into the hash when it is Player Two's turn.
+ */
+uint64_t Zobrist::sideKey() {
+    return table().side;
+}
@@ -0,0 +1,34 @@
+/**
+ * @brief Zobrist keys used to hash board positions.
+ *
+ * Every (piece kind, square) pair and the side to move is assigned a fixed
+ * pseudo-random 64 bit key. A position's hash is the XOR of the keys of
+ * everything on the board, which lets ChessBoard update it incrementally.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace Zobrist {
+    /*
+    Piece kinds are indexed 0-5 for Player One (PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING)
+    and 6-11 for Player Two, in the same order.
+    */
+    const int PIECE_KINDS = 12;
+
+    /**
+     * Gets the key for a piece kind standing on the cell (row, col).
+     *
+     * @param kind The piece kind index, in [0, PIECE_KINDS)
+     * @param row The row of the cell, in [0, 8)
+     * @param col The column of the cell, in [0, 8)
+     * @return The 64 bit key for that piece on that cell.
+     */
+    uint64_t pieceKey(const int& kind, const int& row, const int& col);
+
+    /**
+     * Gets the key that is XOR-ed into the hash when it is Player Two's turn.
+     */
+    uint64_t sideKey();
+};
@@ -0,0 +1,296 @@
+/*
+Client simulator for load-testing the game server:
+`clientsim [--tcp port | --unix path] [--games N] [--plies P] [--concurrent C] [--spectators S]
+           [--clock ms]`
+
+Opens C pairs of connections. Each pair plays one game at a time, the first
+connection creating it and the second joining it, until N games have been played.
+Both clients follow the game by applying the moves the server reports, and the one
+to move answers with a pseudo-random legal move (seeded by the game and ply, so runs
+are repeatable). A game stops at checkmate, stalemate or after P plies, when Player
+One resigns it.
+
+With a clock, the games are timed (ms milliseconds each, no increment) and the
+games lost on time are counted.
+
+With S spectators, S more connections watch every game of the first pair and count
+the updates they receive.
+
+Reports the moves per second and the round-trip latency of a move (from sending it
+to the mover receiving the "moved" line) as p50 / p99 / max.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "MoveGenerator.hpp"
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    const int DEFAULT_PORT = 7070;
+
+    /*
+    One connection to the server, playing one side of its pair's games.
+    */
+    struct Client {
+        int fd = -1;
+        int pair = 0;
+        bool player_one = false;
+        bool spectator = false;
+        std::string input;
+    };
+
+    /*
+    The game a pair of clients is playing.
+    */
+    struct Table {
+        uint64_t game = 0;
+        Position position{};
+        uint32_t plies = 0;
+        bool playing = false;
+        Clock::time_point sent[2];  // When the last move of Player One (and Two) was sent
+    };
+
+    /*
+    Connects to the server, TCP if `path` is empty.
+    */
+    int connectTo(const int& port, const std::string& path) {
+        int fd = ::socket(path.empty() ? AF_INET : AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) { return -1; }
+
+        int result;
+        if (path.empty()) {
+            int no_delay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(static_cast<uint16_t>(port));
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            result = ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        } else {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+            result = ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        }
+        if (result < 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    /*
+    Writes a whole line (the socket is blocking).
+    */
+    bool sendLine(const Client& client, const std::string& line) {
+        const std::string text = line + "\n";
+        size_t written = 0;
+        while (written < text.size()) {
+            ssize_t sent = ::send(client.fd, text.data() + written, text.size() - written, MSG_NOSIGNAL);
+            if (sent <= 0) { return false; }
+            written += sent;
+        }
+        return true;
+    }
+
+    double percentile(const std::vector<double>& sorted, const double& fraction) {
+        if (sorted.empty()) { return 0; }
+        return sorted[std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()))];
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int port = 0;
+    std::string path;
+    int games = 1000;
+    uint32_t plies = 40;
+    int concurrent = 16;
+    int spectators = 0;
+    int64_t clock_ms = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--tcp" && i + 1 < argc) { port = std::stoi(argv[++i]); }
+        else if (arg == "--unix" && i + 1 < argc) { path = argv[++i]; }
+        else if (arg == "--games" && i + 1 < argc) { games = std::stoi(argv[++i]); }
+        else if (arg == "--plies" && i + 1 < argc) { plies = std::stoul(argv[++i]); }
+        else if (arg == "--concurrent" && i + 1 < argc) { concurrent = std::stoi(argv[++i]); }
+        else if (arg == "--spectators" && i + 1 < argc) { spectators = std::stoi(argv[++i]); }
+        else if (arg == "--clock" && i + 1 < argc) { clock_ms = std::stoll(argv[++i]); }
+        else {
+            std::cerr << "Usage: clientsim [--tcp port | --unix path] [--games N] [--plies P] [--concurrent C] [--spectators S] [--clock ms]" << std::endl;
+            return 2;
+        }
+    }
+    if (!port && path.empty()) { port = DEFAULT_PORT; }
+    concurrent = std::max(1, std::min(concurrent, games));
+
+    int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<Client> clients(2 * concurrent + spectators);
+    std::vector<Table> tables(concurrent);
+    for (size_t i = 0; i < clients.size(); i++) {
+        clients[i].fd = connectTo(port, path);
+        if (clients[i].fd < 0) {
+            std::cerr << "clientsim: can not connect: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        clients[i].spectator = (i >= static_cast<size_t>(2 * concurrent));
+        clients[i].pair = clients[i].spectator ? 0 : i / 2;
+        clients[i].player_one = !clients[i].spectator && (i % 2 == 0);
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = i;
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, clients[i].fd, &event);
+    }
+
+    int started = 0;
+    int finished = 0;
+    uint64_t moves = 0;
+    uint64_t rejected = 0;
+    uint64_t updates = 0;
+    uint64_t flagged = 0;
+    std::vector<double> latencies;
+
+    // The client to move plays a legal move, or Player One resigns once the game is long enough
+    auto play = [&](const int& pair) {
+        Table& table = tables[pair];
+        Client& mover = clients[2 * pair + (table.position.player_one_turn ? 0 : 1)];
+        MoveGenerator::MoveList legal;
+        if (table.plies >= plies || MoveGenerator::generate(table.position, legal) == 0) {
+            sendLine(clients[2 * pair], "resign " + std::to_string(table.game));
+            return;
+        }
+        uint64_t seed = (table.game * 0x9E3779B97F4A7C15ULL) ^ (table.plies * 0xBF58476D1CE4E5B9ULL);
+        MoveGenerator::MoveWord move = legal.moves[(seed >> 33) % legal.size];
+        table.sent[table.position.player_one_turn ? 0 : 1] = Clock::now();
+        sendLine(mover, "move " + std::to_string(table.game) + " " + MoveGenerator::toUCI(move));
+    };
+
+    // Starts the next game of a pair, if any is left
+    auto next = [&](const int& pair) {
+        tables[pair].playing = false;
+        if (started < games) {
+            started++;
+            sendLine(clients[2 * pair], clock_ms ? "new " + std::to_string(clock_ms) : "new");
+        }
+    };
+
+    auto begin = Clock::now();
+    for (int pair = 0; pair < concurrent; pair++) { next(pair); }
+
+    epoll_event events[64];
+    while (finished < games) {
+        int count = ::epoll_wait(epoll_fd, events, 64, -1);
+        if (count < 0 && errno == EINTR) { continue; }
+        if (count < 0) { break; }
+
+        for (int e = 0; e < count; e++) {
+            Client& client = clients[events[e].data.u32];
+            Table& table = tables[client.pair];
+
+            char buffer[4096];
+            ssize_t received = ::read(client.fd, buffer, sizeof(buffer));
+            if (received <= 0) {
+                std::cerr << "clientsim: the server closed the connection" << std::endl;
+                return 1;
+            }
+            client.input.append(buffer, received);
+
+            size_t start = 0;
+            size_t end;
+            while ((end = client.input.find('\n', start)) != std::string::npos) {
+                const std::string text = client.input.substr(start, end - start);
+                std::istringstream line(text);
+                start = end + 1;
+
+                std::string kind;
+                uint64_t game = 0;
+                line >> kind >> game;
+
+                if (client.spectator) {
+                    if (kind == "delta") { updates++; }
+                } else if (kind == "game" && client.player_one) {
+                    if (client.pair == 0) {
+                        for (size_t i = 2 * concurrent; i < clients.size(); i++) { sendLine(clients[i], "watch " + std::to_string(game)); }
+                    }
+                    table.game = game;
+                    table.position = MoveGenerator::startingPosition();
+                    table.plies = 0;
+                    table.playing = true;
+                    sendLine(clients[2 * client.pair + 1], "join " + std::to_string(game));
+                } else if (kind == "start" && client.player_one) {
+                    play(client.pair);
+                } else if (kind == "moved" && game == table.game && table.playing) {
+                    std::string uci, status;
+                    uint32_t ply;
+                    line >> ply >> uci >> status;
+                    MoveGenerator::MoveWord move;
+                    MoveGenerator::parseUCI(uci, move);
+
+                    // Both clients see the move: the mover times it, and the first to read it follows it
+                    const bool by_player_one = (ply % 2 == 1);
+                    if (client.player_one == by_player_one) {
+                        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - table.sent[by_player_one ? 0 : 1]).count());
+                    }
+                    if (ply == table.plies + 1) {
+                        moves++;
+                        MoveGenerator::apply(table.position, move);
+                        table.plies = ply;
+                        if (status != "active") {
+                            finished++;
+                            next(client.pair);
+                        } else {
+                            play(client.pair);
+                        }
+                    }
+                } else if (kind == "rejected") {
+                    rejected++;
+                    sendLine(clients[2 * client.pair], "resign " + std::to_string(game));
+                } else if (kind == "ended" && client.player_one && game == table.game && table.playing) {
+                    std::string reason;
+                    line >> reason;
+                    if (reason == "time") { flagged++; }
+                    finished++;
+                    next(client.pair);
+                } else if (kind == "error") {
+                    std::cerr << "clientsim: " << text << std::endl;
+                }
+            }
+            client.input.erase(0, start);
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    for (Client& client : clients) {
+        sendLine(client, "quit");
+        ::close(client.fd);
+    }
+    ::close(epoll_fd);
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "Games: " << finished << ", moves: " << moves << " (" << rejected << " rejected), time (s): " << elapsed
+              << ", moves/second: " << static_cast<uint64_t>(elapsed > 0 ? moves / elapsed : 0) << std::endl;
+    if (clock_ms) { std::cout << "Games lost on time: " << flagged << std::endl; }
+    if (spectators) { std::cout << "Spectator updates received: " << updates << std::endl; }
+    std::cout << "Move latency (us): p50 " << percentile(latencies, 0.50) << ", p99 " << percentile(latencies, 0.99)
+              << ", max " << (latencies.empty() ? 0 : latencies.back()) << std::endl;
+    return rejected ? 1 : 0;
+}
@@ -1,5 +1,30 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <tuple>
+
 #include "pieces_module.hpp"
 #include "ChessBoard.hpp"
+#include "AllocationTracker.hpp"
+#include "Annotator.hpp"
+#include "Benchmark.hpp"
+#include "EpdSuite.hpp"
+#include "GameManager.hpp"
+#include "MatchRunner.hpp"
+#include "MateSolver.hpp"
+#include "MoveLog.hpp"
+#include "MoveValidator.hpp"
+#include "PerfCounters.hpp"
+#include "PositionView.hpp"
+#include "Profiler.hpp"
+#include "PuzzleMiner.hpp"
+#include "Search.hpp"
+#include "SearchScheduler.hpp"
+#include "TimerWheel.hpp"
+#include "UCI.hpp"
 /*Notes: 
 1. Remember to remove the destructor on ChessPiece hpp. Comment out line 73
 2. I implemeted a getter for playerOne turn
@@ -8,7 +33,1004 @@
 
 */
 
-int main() {
+/**
+ * @brief Proves a forced mate for the side to move: `main mate "<fen>" [max mate in] [threads]`
+ * @return The process exit code: 0 if a mate was found, 1 if not, 2 on bad input.
+ */
+int solveMate(int argc, char* argv[]) {
+    ChessBoard board;
+    if (!board.loadFEN(argv[2])) {
+        std::cout << "Invalid FEN: " << argv[2] << std::endl;
+        return 2;
+    }
+
+    int max_mate_in = (argc > 3) ? std::stoi(argv[3]) : 5;
+    int threads = (argc > 4) ? std::stoi(argv[4]) : 1;
+
+    MateSolver solver(64, threads);
+    MateResult result = solver.solve(board, max_mate_in);
+    if (!result.found) {
+        std::cout << "No mate in " << max_mate_in << " found (" << result.nodes << " nodes)" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Mate in " << result.mate_in << " (" << result.nodes << " nodes):" << std::endl;
+    for (const Move& move : result.line) {
+        std::cout << "  " << move.toString() << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * @brief Annotates a PGN corpus as JSON lines: `main annotate <games.pgn | -> [nodes per position] [threads]`
+ * @return The process exit code: 0 on success, 2 if the input could not be opened.
+ */
+int annotateGames(int argc, char* argv[]) {
+    AnnotatorOptions options;
+    options.nodes = (argc > 3) ? std::stoull(argv[3]) : options.nodes;
+    options.threads = (argc > 4) ? std::stoi(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::ifstream file;
+    if (std::string(argv[2]) != "-") {
+        file.open(argv[2]);
+        if (!file) {
+            std::cerr << "Cannot open " << argv[2] << std::endl;
+            return 2;
+        }
+    }
+
+    Annotator annotator(std::cout, options);
+    size_t games = annotator.run(file.is_open() ? file : std::cin);
+    std::cerr << "Annotated " << games << " games" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Mines tactical puzzles from a PGN corpus as JSON lines: `main puzzles <games.pgn | -> [verify nodes] [threads]`
+ * @return The process exit code: 0 on success, 2 if the input could not be opened.
+ */
+int minePuzzles(int argc, char* argv[]) {
+    PuzzleOptions options;
+    options.verify_nodes = (argc > 3) ? std::stoull(argv[3]) : options.verify_nodes;
+    options.threads = (argc > 4) ? std::stoi(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::ifstream file;
+    if (std::string(argv[2]) != "-") {
+        file.open(argv[2]);
+        if (!file) {
+            std::cerr << "Cannot open " << argv[2] << std::endl;
+            return 2;
+        }
+    }
+
+    PuzzleMiner miner(std::cout, options);
+    size_t games = miner.run(file.is_open() ? file : std::cin);
+    PuzzleStats stats = miner.stats();
+    std::cerr << "Mined " << games << " games: " << stats.positions << " positions, "
+              << stats.filtered << " passed filters, " << stats.quiet << " passed quiescence, "
+              << stats.candidates << " candidates, " << stats.puzzles << " puzzles" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Plays a match between two engine configurations (see EngineConfig::parse()):
+ *        `main match <engine A> <engine B> [games] [concurrency] [openings.epd | openings.pgn]`
+ * @return The process exit code: 0 on success, 2 if the arguments or openings could not be read.
+ */
+int playMatch(int argc, char* argv[]) {
+    EngineConfig a, b;
+    a.name = "A";
+    b.name = "B";
+    if (!EngineConfig::parse(argv[2], a) || !EngineConfig::parse(argv[3], b)) {
+        std::cerr << "Engines are configured as key=value lists, eg. name=base,nodes=20000,depth=64,movetime=0,hash=4" << std::endl;
+        return 2;
+    }
+
+    MatchOptions options;
+    options.games = (argc > 4) ? std::stoi(argv[4]) : options.games;
+    options.concurrency = (argc > 5) ? std::stoi(argv[5]) : std::max(1u, std::thread::hardware_concurrency());
+
+    MatchRunner match(a, b, options);
+    if (argc > 6) {
+        std::ifstream file(argv[6]);
+        if (!file || match.loadOpenings(file) == 0) {
+            std::cerr << "Cannot read openings from " << argv[6] << std::endl;
+            return 2;
+        }
+    }
+
+    MatchResult result = match.run(std::cout);
+    std::cout << "Score of " << a.name << " vs " << b.name << ": +" << result.wins << " =" << result.draws
+              << " -" << result.losses << " (" << result.games() << " games)" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Elo difference: " << result.elo << " +/- " << result.elo_error << std::endl;
+    std::cout << "SPRT (" << options.elo0 << ", " << options.elo1 << "): LLR " << result.llr << " ["
+              << result.lower_bound << ", " << result.upper_bound << "] - "
+              << (result.llr >= result.upper_bound ? "H1 accepted" : result.llr <= result.lower_bound ? "H0 accepted" : "inconclusive")
+              << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Runs an EPD test suite, searching every position under the given limits (see EngineConfig::parse()):
+ *        `main epd <suite.epd> [limits, eg. movetime=1000] [threads]`
+ * @return The process exit code: 0 on success, 2 if the arguments or suite could not be read.
+ */
+int runSuite(int argc, char* argv[]) {
+    EngineConfig engine;
+    engine.nodes = 0;
+    engine.movetime = 1000;
+    if (argc > 3 && !EngineConfig::parse(argv[3], engine)) {
+        std::cerr << "Limits are given as key=value lists, eg. nodes=100000,depth=10,movetime=0,hash=16" << std::endl;
+        return 2;
+    }
+    int threads = (argc > 4) ? std::stoi(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::ifstream file(argv[2]);
+    EpdSuite suite(engine, threads);
+    if (!file || suite.load(file) == 0) {
+        std::cerr << "Cannot read test positions from " << argv[2] << std::endl;
+        return 2;
+    }
+
+    EpdSummary summary = suite.run(std::cout);
+    std::cout << "Solved " << summary.solved << "/" << summary.positions << std::endl;
+    std::cout << "Time to solution: p50 " << summary.p50_time << " ms, p90 " << summary.p90_time
+              << " ms, max " << summary.max_time << " ms" << std::endl;
+    std::cout << "Nodes " << summary.nodes << ", search time " << summary.elapsed << " ms, "
+              << summary.nps << " nps" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Searches the benchmark positions to a fixed depth: `main bench [depth]`.
+ *        The total node count is a signature that speed-only changes must not alter.
+ * @param nodes Set to the total node count
+ * @return The process exit code (always 0).
+ */
+int runBench(int argc, char* argv[], uint64_t& nodes) {
+    int depth = (argc > 2) ? std::stoi(argv[2]) : Benchmark::DEFAULT_DEPTH;
+    Benchmark::BenchResult result = Benchmark::run(depth, std::cerr);
+    nodes = result.nodes;
+
+    std::cerr << "Total time (ms) : " << result.elapsed << std::endl;
+    std::cerr << "Nodes searched  : " << result.nodes << std::endl;
+    std::cerr << "Nodes/second    : " << result.nps << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Counts the leaf nodes of the legal move tree, with the count below every root move:
+ *        `main perft <depth> [fen]`
+ * @param nodes Set to the number of leaf nodes
+ * @return The process exit code: 0 on success, 2 if the FEN is invalid.
+ */
+int runPerft(int argc, char* argv[], uint64_t& nodes) {
+    ChessBoard board;
+    if (argc > 3 && !board.loadFEN(argv[3])) {
+        std::cerr << "Invalid FEN: " << argv[3] << std::endl;
+        return 2;
+    }
+    int depth = std::stoi(argv[2]);
+
+    auto start = std::chrono::steady_clock::now();
+    nodes = (depth < 1) ? 1 : 0;
+    for (const Move& move : (depth < 1) ? std::vector<Move>() : board.generateMoves()) {
+        board.makeMove(move);
+        uint64_t count = board.perft(depth - 1);
+        board.unmakeMove();
+
+        std::cout << move.toUCI() << ": " << count << std::endl;
+        nodes += count;
+    }
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Nodes: " << nodes << std::endl;
+    std::cout << "Time (ms): " << elapsed << std::endl;
+    std::cout << "Nodes/second: " << (elapsed ? nodes * 1000 / elapsed : 0) << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Searches one position to a fixed depth: `main search <depth> [fen] [threads]`
+ * @param nodes Set to the number of nodes searched
+ * @return The process exit code: 0 on success, 2 if the FEN is invalid.
+ */
+int runSearch(int argc, char* argv[], uint64_t& nodes) {
+    ChessBoard board;
+    if (argc > 3 && !board.loadFEN(argv[3])) {
+        std::cerr << "Invalid FEN: " << argv[3] << std::endl;
+        return 2;
+    }
+
+    SearchLimits limits;
+    limits.depth = std::stoi(argv[2]);
+    limits.threads = (argc > 4) ? std::stoi(argv[4]) : 1;
+
+    TranspositionTable table(16);
+    Search search(table);
+    SearchStats::installSignalHandler();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<PVLine> lines = search.run(board, limits);
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    nodes = search.nodes();
+
+    std::cout << "Best move: " << (lines.empty() ? "(none)" : lines[0].moves[0].toUCI())
+              << ", score " << (lines.empty() ? 0 : lines[0].score) << std::endl;
+    std::cout << "Nodes: " << nodes << ", time (ms): " << elapsed
+              << ", nodes/second: " << (elapsed ? nodes * 1000 / elapsed : 0) << std::endl;
+    std::cout << "Statistics: " << search.stats().toJSON() << std::endl;
+    return 0;
+}
+
+// A command that reports the number of nodes it worked through
+typedef int (*Workload)(int argc, char* argv[], uint64_t& nodes);
+
+/**
+ * @brief Gets the workload named argv[1] (perft, bench or search), or nullptr if there is none
+ *        with enough arguments. Used by the commands that wrap another one, like `main perf`.
+ */
+Workload findWorkload(int argc, char* argv[]) {
+    const std::string command = argv[1];
+    if (command == "perft" && argc > 2) { return runPerft; }
+    if (command == "search" && argc > 2) { return runSearch; }
+    if (command == "bench") { return runBench; }
+    return nullptr;
+}
+
+/**
+ * @brief Runs perft, bench or a search under hardware performance counters, and reports
+ *        the counts per node: `main perf <perft | bench | search> [arguments of that command]`
+ * @return The exit code of the command, or 2 if there is no such command.
+ */
+int measureCounters(int argc, char* argv[]) {
+    // The command sees its own name as argv[1], as if run directly
+    Workload workload = findWorkload(argc - 1, argv + 1);
+    if (!workload) {
+        std::cerr << "Usage: main perf <perft <depth> [fen] | bench [depth] | search <depth> [fen] [threads]>" << std::endl;
+        return 2;
+    }
+
+    PerfCounters counters;
+    bool counting = counters.open();
+    if (!counting) { std::cerr << "Hardware counters unavailable: " << counters.error() << std::endl; }
+
+    uint64_t nodes = 0;
+    counters.start();
+    int code = workload(argc - 1, argv + 1, nodes);
+    counters.stop();
+
+    if (counting) { counters.report(std::cerr, nodes); }
+    return code;
+}
+
+/**
+ * @brief Runs perft, bench or a search and reports the heap allocations it made, in total and
+ *        per node: `main allocs <perft | bench | search> [arguments of that command]`
+ * @return The exit code of the command, or 2 if there is no such command.
+ */
+int countAllocations(int argc, char* argv[]) {
+    Workload workload = findWorkload(argc - 1, argv + 1);
+    if (!workload) {
+        std::cerr << "Usage: main allocs <perft <depth> [fen] | bench [depth] | search <depth> [fen] [threads]>" << std::endl;
+        return 2;
+    }
+    if (!AllocationTracker::ENABLED) {
+        std::cerr << "Allocation tracking is compiled out: rebuild with `make clean && make TRACK_ALLOCATIONS=1`" << std::endl;
+        return 2;
+    }
+
+    uint64_t nodes = 0;
+    AllocationTracker::Counts before = AllocationTracker::process();
+    int code = workload(argc - 1, argv + 1, nodes);
+    AllocationTracker::Counts after = AllocationTracker::process();
+
+    uint64_t allocations = after.allocations - before.allocations;
+    uint64_t bytes = after.bytes - before.bytes;
+    std::cerr << "Heap allocations over " << nodes << " nodes:" << std::endl
+              << "  allocations   " << allocations << " (" << std::fixed << std::setprecision(2)
+              << (nodes ? static_cast<double>(allocations) / nodes : 0.0) << " / node)" << std::endl
+              << "  bytes         " << bytes << " (" << (nodes ? static_cast<double>(bytes) / nodes : 0.0) << " / node)" << std::endl
+              << "  deallocations " << after.deallocations - before.deallocations << std::endl
+              << "  violations    " << after.violations - before.violations << std::endl;
+    return code;
+}
+
+/**
+ * @brief Reports the memory footprint of a board, of a game and of an engine, by category:
+ *        `main --memstats [hash megabytes] [plies]`
+ *        The game is a board after `plies` moves (100 by default), so its history is included.
+ * @return The process exit code.
+ */
+int reportMemory(int argc, char* argv[]) {
+    const size_t megabytes = (argc > 2) ? std::stoul(argv[2]) : 16;
+    const int plies = (argc > 3) ? std::stoi(argv[3]) : 100;
+
+    MemoryReport board_report;
+    ChessBoard board;
+    board.reportMemory(board_report);
+    std::cout << "Board (starting position), bytes:" << std::endl;
+    board_report.write(std::cout, "  ");
+
+    // Any legal moves will do, as long as the game is long enough
+    int played = 0;
+    for (; played < plies; played++) {
+        std::vector<Move> moves = board.generateMoves();
+        if (moves.empty()) { break; }
+        board.makeMove(moves[(played * 7) % moves.size()]);
+    }
+    MemoryReport game_report;
+    board.reportMemory(game_report);
+    std::cout << "Game (board after " << played << " plies), bytes:" << std::endl;
+    game_report.write(std::cout, "  ");
+
+    MemoryReport engine_report;
+    TranspositionTable table(megabytes);
+    Search search(table);
+    table.reportMemory(engine_report);
+    search.reportMemory(engine_report);
+    std::cout << "Engine (" << megabytes << " MB hash, without its board), bytes:" << std::endl;
+    engine_report.write(std::cout, "  ");
+    return 0;
+}
+
+/**
+ * @brief Load-tests the game host: starts `games` games over `shards` worker shards and plays
+ *        `plies` random legal moves in each (fewer if a game ends first), every move submitted
+ *        from the callback of the previous one: `main host <games> [shards] [plies]`
+ * @return The process exit code.
+ */
+int hostGames(int argc, char* argv[]) {
+    const int games = std::stoi(argv[2]);
+    const int shards = (argc > 3) ? std::stoi(argv[3]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const uint32_t plies = (argc > 4) ? std::stoul(argv[4]) : 40;
+
+    GameManager manager(shards);
+    std::atomic<uint64_t> moves{0};
+    std::atomic<uint64_t> rejected{0};
+
+    // Picks a pseudo-random legal move, seeded by the game and ply so runs are repeatable
+    auto pickMove = [](const Position& position, const GameManager::GameId& id, const uint32_t& ply, MoveGenerator::MoveWord& move) {
+        MoveGenerator::MoveList legal;
+        if (MoveGenerator::generate(position, legal) == 0) { return false; }
+        uint64_t seed = (id * 0x9E3779B97F4A7C15ULL) ^ (ply * 0xBF58476D1CE4E5B9ULL);
+        move = legal.moves[(seed >> 33) % legal.size];
+        return true;
+    };
+
+    std::function<void(const GameManager::MoveOutcome&)> next;
+    next = [&](const GameManager::MoveOutcome& outcome) {
+        if (outcome.result != GameManager::MoveResult::ACCEPTED) {
+            rejected++;
+            return;
+        }
+        moves++;
+        MoveGenerator::MoveWord move;
+        if (outcome.status == GameManager::Status::ACTIVE && outcome.plies < plies
+            && pickMove(outcome.position, outcome.game, outcome.plies, move)) {
+            manager.submitMove(outcome.game, move, next);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    const Position initial = MoveGenerator::startingPosition();
+    for (int i = 0; i < games; i++) {
+        GameManager::GameId id = manager.createGame(initial);
+        MoveGenerator::MoveWord move;
+        if (plies > 0 && pickMove(initial, id, 0, move)) { manager.submitMove(id, move, next); }
+    }
+    manager.waitIdle();
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    MemoryReport report;
+    manager.reportMemory(report);
+    std::cout << "Games: " << manager.liveGames() << " on " << manager.shardCount() << " shards" << std::endl;
+    std::cout << "Moves played: " << moves << " (" << rejected << " rejected), time (ms): " << elapsed
+              << ", moves/second: " << (elapsed ? moves * 1000 / elapsed : 0) << std::endl;
+    std::cout << "Memory, bytes:" << std::endl;
+    report.write(std::cout, "  ");
+    std::cout << "Per game: " << (games ? report.total() / games : 0) << " bytes" << std::endl;
+    return rejected ? 1 : 0;
+}
+
+/**
+ * @brief Validates a batch of (position, move) requests on a MoveValidator, and compares with
+ *        a ChessBoard built per request: `main validate <requests> [threads]`
+ *        The positions come from pseudo-random games; one move in four is random, so mostly illegal.
+ * @return 0, or 1 if the validator and the boards disagree.
+ */
+int validateMoves(int argc, char* argv[]) {
+    const size_t count = std::stoul(argv[2]);
+    const int threads = (argc > 3) ? std::stoi(argv[3]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    std::vector<MoveValidator::Request> requests;
+    requests.reserve(count);
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    auto random = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return seed;
+    };
+    Position position = MoveGenerator::startingPosition();
+    while (requests.size() < count) {
+        MoveGenerator::MoveList legal;
+        if (MoveGenerator::generate(position, legal) == 0 || random() % 60 == 0) {
+            position = MoveGenerator::startingPosition();
+            continue;
+        }
+        const MoveGenerator::MoveWord move = (random() % 4 == 0) ? static_cast<MoveGenerator::MoveWord>(random() & 0xFFF)
+                                                                 : legal.moves[random() % legal.size];
+        requests.push_back({position, move});
+        MoveGenerator::apply(position, legal.moves[random() % legal.size]);
+    }
+
+    MoveValidator validator(threads);
+    std::vector<MoveValidator::Result> results;
+    auto start = std::chrono::steady_clock::now();
+    validator.validate(requests, results);
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // The same checks with a heap-built board per request, on one thread
+    size_t legal = 0;
+    size_t mismatches = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < requests.size(); i++) {
+        ChessBoard board(requests[i].position);
+        bool board_legal = false;
+        for (const Move& move : board.generateMoves()) {
+            if (MoveGenerator::pack(move) == requests[i].move) {
+                board_legal = board.makeMove(move);
+                break;
+            }
+        }
+        if (board_legal) { legal++; }
+        if (board_legal != results[i].legal || (board_legal && board.getHash() != results[i].hash)) { mismatches++; }
+    }
+    int64_t board_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Requests: " << requests.size() << " (" << legal << " legal) on " << validator.threadCount() << " threads" << std::endl;
+    std::cout << "Validator, time (us): " << elapsed << ", requests/second: " << (elapsed ? requests.size() * 1000000 / elapsed : 0) << std::endl;
+    std::cout << "ChessBoard per request, time (us): " << board_elapsed << ", requests/second: "
+              << (board_elapsed ? requests.size() * 1000000 / board_elapsed : 0) << std::endl;
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    return mismatches ? 1 : 0;
+}
+
+/**
+ * @brief Simulates the clocks of many timed games on a TimerWheel: every game has a flag
+ *        timer, and each move cancels the mover's and arms the opponent's, while time advances
+ *        one tick (10 ms) per `games` / 100 moves: `main timers <games> [moves]`
+ * @return 0
+ */
+int simulateClocks(int argc, char* argv[]) {
+    const size_t games = std::stoul(argv[2]);
+    const size_t moves = (argc > 3) ? std::stoul(argv[3]) : games * 10;
+    const size_t moves_per_tick = std::max<size_t>(1, games / 100);
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    auto random = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return seed;
+    };
+
+    // Clocks of 1 to 10 minutes, in 10 ms ticks
+    TimerWheel wheel;
+    std::vector<TimerWheel::TimerId> flags(games);
+    for (size_t game = 0; game < games; game++) { flags[game] = wheel.arm(6000 + random() % 54000, game); }
+
+    std::vector<uint64_t> expired;
+    size_t flagged = 0;
+    int64_t move_ns = 0;
+    int64_t tick_ns = 0;
+    for (size_t move = 0; move < moves; move++) {
+        auto start = std::chrono::steady_clock::now();
+        const size_t game = random() % games;
+        if (wheel.cancel(flags[game])) { flags[game] = wheel.arm(wheel.now() + 100 + random() % 6000, game); }
+        move_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        if (move % moves_per_tick == 0) {
+            start = std::chrono::steady_clock::now();
+            flagged += wheel.advance(wheel.now() + 1, expired);
+            tick_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            expired.clear();
+        }
+    }
+
+    MemoryReport report;
+    wheel.reportMemory(report);
+    const size_t ticks = (moves + moves_per_tick - 1) / moves_per_tick;
+    std::cout << "Games: " << games << ", moves: " << moves << ", ticks: " << ticks << " (" << wheel.now() * 10 / 1000 << " s of game time)" << std::endl;
+    std::cout << "Flags fallen: " << flagged << ", clocks still running: " << wheel.size() << std::endl;
+    std::cout << "Per move (cancel + arm), ns: " << (moves ? move_ns / static_cast<int64_t>(moves) : 0)
+              << ", per tick, ns: " << (ticks ? tick_ns / static_cast<int64_t>(ticks) : 0) << std::endl;
+    std::cout << "Memory, bytes: " << report.total() << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Plays self-driving games with a write-ahead log attached, checkpointing every
+ *        100 ms, then recovers them into a new manager from the snapshot and the log (whose
+ *        tail is torn on purpose) and compares: `main wal <directory> <games> [plies] [shards]`
+ * @return 0, 1 if a recovered game differs, or 2 if the log can not be written or read.
+ */
+int replayLog(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: main wal <directory> <games> [plies] [shards]" << std::endl;
+        return 2;
+    }
+    const std::string directory = argv[2];
+    const size_t games = std::stoul(argv[3]);
+    const uint32_t plies = (argc > 4) ? std::stoul(argv[4]) : 40;
+    const int shards = (argc > 5) ? std::stoi(argv[5]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    // Start from an empty log
+    for (const uint64_t& segment : MoveLog::listSegments(directory)) { std::remove(MoveLog::segmentPath(directory, segment).c_str()); }
+    std::remove((directory + "/snapshot.bin").c_str());
+
+    struct Final {
+        Position position;
+        uint32_t plies;
+        bool live;
+    };
+    std::vector<GameManager::GameId> ids(games);
+    std::vector<Final> finals(games);
+    uint64_t records;
+    uint64_t commits;
+    int checkpoints = 0;
+    int64_t elapsed;
+    {
+        MoveLog log;
+        if (!log.open(directory)) {
+            std::cerr << "Cannot open the log: " << log.error() << std::endl;
+            return 2;
+        }
+        GameManager manager(shards);
+        manager.setLog(&log);
+
+        std::atomic<size_t> finished{0};
+        std::function<void(const GameManager::MoveOutcome&)> next;
+        next = [&](const GameManager::MoveOutcome& outcome) {
+            MoveGenerator::MoveList legal;
+            if (outcome.result == GameManager::MoveResult::ACCEPTED && outcome.status == GameManager::Status::ACTIVE
+                && outcome.plies < plies && MoveGenerator::generate(outcome.position, legal) > 0) {
+                uint64_t seed = (outcome.game * 0x9E3779B97F4A7C15ULL) ^ (outcome.plies * 0xBF58476D1CE4E5B9ULL);
+                manager.submitMove(outcome.game, legal.moves[(seed >> 33) % legal.size], next);
+                return;
+            }
+            // Every fourth game is ended, so recovery sees slots freed too
+            if ((outcome.game >> 8) % 4 == 0) { manager.endGame(outcome.game); }
+            finished++;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        const Position initial = MoveGenerator::startingPosition();
+        for (size_t i = 0; i < games; i++) {
+            ids[i] = manager.createGame(initial);
+            MoveGenerator::MoveList legal;
+            if (plies > 0 && MoveGenerator::generate(initial, legal) > 0) {
+                manager.submitMove(ids[i], legal.moves[(ids[i] * 0x9E3779B97F4A7C15ULL >> 33) % legal.size], next);
+            } else {
+                finished++;
+            }
+        }
+        while (finished < games) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (finished < games) {
+                if (!manager.checkpoint()) {
+                    std::cerr << "Checkpoint failed: " << manager.error() << std::endl;
+                    return 2;
+                }
+                checkpoints++;
+            }
+        }
+        manager.waitIdle();
+        elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        for (size_t i = 0; i < games; i++) {
+            GameManager::Status status;
+            finals[i].live = manager.getGame(ids[i], finals[i].position, finals[i].plies, status);
+        }
+        std::tie(records, commits) = log.counts();
+    }
+
+    // A crash in the middle of a write leaves a torn record at the end of the last segment
+    const std::vector<uint64_t> segments = MoveLog::listSegments(directory);
+    if (!segments.empty()) {
+        std::ofstream torn(MoveLog::segmentPath(directory, segments.back()), std::ios::binary | std::ios::app);
+        torn << "torn record";
+    }
+
+    GameManager recovered(shards);
+    GameManager::RecoveryStats stats;
+    auto start = std::chrono::steady_clock::now();
+    if (!recovered.recover(directory, stats)) {
+        std::cerr << "Recovery failed: " << recovered.error() << std::endl;
+        return 2;
+    }
+    int64_t recovery_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < games; i++) {
+        Final found{};
+        GameManager::Status status;
+        found.live = recovered.getGame(ids[i], found.position, found.plies, status);
+        if (found.live != finals[i].live || (found.live && (found.plies != finals[i].plies || !(found.position == finals[i].position)))) {
+            mismatches++;
+        }
+    }
+
+    std::cout << "Games: " << games << " on " << shards << " shards, time (ms): " << elapsed << ", checkpoints: " << checkpoints << std::endl;
+    std::cout << "Records logged: " << records << ", commits: " << commits << ", records per fsync: "
+              << std::fixed << std::setprecision(1) << (commits ? static_cast<double>(records) / commits : 0.0) << std::endl;
+    std::cout << "Recovered " << recovered.liveGames() << " games: " << stats.snapshot_games << " from the snapshot, "
+              << stats.records << " log records read, " << stats.replayed << " replayed, " << stats.rejected << " rejected" << std::endl;
+    std::cout << "Recovery time (us): " << recovery_us << std::endl;
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    return mismatches ? 1 : 0;
+}
+
+/**
+ * @brief Checkpoints boards of pseudo-random games as binary snapshots and restores them,
+ *        against a FEN round trip: `main snapshot <boards> [plies]`
+ *        Restores go into the boards a second time over, as a host restoring checkpoints would.
+ * @return 0, or 1 if a restored board differs (position, hash or history).
+ */
+int snapshotBoards(int argc, char* argv[]) {
+    const size_t count = std::stoul(argv[2]);
+    const int plies = (argc > 3) ? std::stoi(argv[3]) : 60;
+
+    // Play the games on Positions, then on boards, so their histories are real
+    std::vector<std::unique_ptr<ChessBoard>> boards;
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < count; i++) {
+        boards.push_back(std::make_unique<ChessBoard>());
+        Position position = MoveGenerator::startingPosition();
+        for (int ply = 0; ply < plies; ply++) {
+            MoveGenerator::MoveList legal;
+            if (MoveGenerator::generate(position, legal) == 0) { break; }
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            const MoveGenerator::MoveWord move = legal.moves[seed % legal.size];
+            const int from = MoveGenerator::fromSquare(move);
+            const int to = MoveGenerator::toSquare(move);
+            boards.back()->makeMove(Move({from / 8, from % 8}, {to / 8, to % 8}, nullptr));
+            MoveGenerator::apply(position, move);
+        }
+    }
+
+    std::vector<std::string> fens(count);
+    std::vector<uint64_t> hashes(count);
+    std::vector<std::string> snapshots(count);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) { snapshots[i] = boards[i]->toSnapshot(); }
+    int64_t save_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        fens[i] = boards[i]->toFEN();
+        hashes[i] = boards[i]->getHash();
+        bytes += snapshots[i].size();
+    }
+
+    // Text restores rebuild every piece (and lose the history)
+    std::vector<std::unique_ptr<ChessBoard>> text_boards;
+    for (size_t i = 0; i < count; i++) { text_boards.push_back(std::make_unique<ChessBoard>()); }
+    AllocationTracker::Counts before = AllocationTracker::process();
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) { text_boards[i]->loadFEN(fens[i]); }
+    int64_t fen_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    const uint64_t fen_allocations = AllocationTracker::process().allocations - before.allocations;
+
+    size_t failed = 0;
+    for (size_t i = 0; i < count; i++) { failed += !boards[i]->loadSnapshot(snapshots[(i + 1) % count]); }
+    before = AllocationTracker::process();
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) { failed += !boards[i]->loadSnapshot(snapshots[i]); }
+    int64_t load_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    const uint64_t load_allocations = AllocationTracker::process().allocations - before.allocations;
+
+    // Restored boards must match, and take their history back to the starting position
+    size_t mismatches = failed;
+    for (size_t i = 0; i < count; i++) {
+        ChessBoard& board = *boards[i];
+        std::string diff;
+        if (board.toFEN() != fens[i] || board.getHash() != hashes[i] || !board.verifyState(diff)) { mismatches++; }
+        while (board.unmakeMove()) {}
+        if (board.toFEN() != ChessBoard::STARTING_FEN || !board.verifyState(diff)) { mismatches++; }
+    }
+
+    auto perBoard = [count](const int64_t& us) { return count ? us * 1000 / static_cast<int64_t>(count) : 0; };
+    std::cout << "Boards: " << count << " after " << plies << " plies, snapshot bytes: " << (count ? bytes / count : 0) << " per board" << std::endl;
+    std::cout << "Snapshot, ns per board: " << perBoard(save_us) << std::endl;
+    std::cout << "Restore from snapshot, ns per board: " << perBoard(load_us);
+    if (AllocationTracker::ENABLED) { std::cout << ", allocations per board: " << std::fixed << std::setprecision(2) << (count ? static_cast<double>(load_allocations) / count : 0.0); }
+    std::cout << std::endl << "Restore from FEN, ns per board: " << perBoard(fen_us);
+    if (AllocationTracker::ENABLED) { std::cout << ", allocations per board: " << std::fixed << std::setprecision(2) << (count ? static_cast<double>(fen_allocations) / count : 0.0); }
+    std::cout << std::endl << "Mismatches: " << mismatches << std::endl;
+    return mismatches ? 1 : 0;
+}
+
+/**
+ * @brief Plays a game on a ChessBoard while `readers` threads keep reading its position,
+ *        first through a PositionView and then through a mutex held for every move:
+ *        `main views <readers> [moves]`
+ *        Every read is checked for consistency: its hash must match its squares and side
+ *        to move, and its ply count the side to move.
+ * @return 0, or 1 if a reader saw a torn position.
+ */
+int readViews(int argc, char* argv[]) {
+    const int readers = std::stoi(argv[2]);
+    const size_t moves = (argc > 3) ? std::stoul(argv[3]) : 20000;
+
+    auto consistent = [](const Position& position, const uint32_t& plies) {
+        uint64_t hash = position.player_one_turn ? 0 : Zobrist::sideKey();
+        for (int square = 0; square < 64; square++) {
+            if (position.squares[square] != Position::EMPTY) { hash ^= Zobrist::pieceKey(position.squares[square], square / 8, square % 8); }
+        }
+        return hash == position.hash && (plies % 2 == 0) == position.player_one_turn;
+    };
+
+    for (const bool locked : {false, true}) {
+        PositionView view;
+        std::mutex mutex;
+        Position shared = MoveGenerator::startingPosition();
+        uint32_t shared_plies = 0;
+        view.publish(shared, shared_plies);
+
+        std::atomic<bool> done{false};
+        std::atomic<uint64_t> reads{0};
+        std::atomic<uint64_t> torn{0};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < readers; i++) {
+            threads.emplace_back([&]() {
+                uint64_t count = 0;
+                uint64_t bad = 0;
+                while (!done) {
+                    Position position;
+                    uint32_t plies;
+                    if (locked) {
+                        std::lock_guard<std::mutex> guard(mutex);
+                        position = shared;
+                        plies = shared_plies;
+                    } else {
+                        const PositionView::Snapshot snapshot = view.read();
+                        position = snapshot.position;
+                        plies = snapshot.plies;
+                    }
+                    bad += !consistent(position, plies);
+                    count++;
+                }
+                reads += count;
+                torn += bad;
+            });
+        }
+
+        // The game thread: pseudo-random games, started over when they end
+        ChessBoard board;
+        Position position = MoveGenerator::startingPosition();
+        uint32_t plies = 0;
+        uint64_t seed = 0x9E3779B97F4A7C15ULL;
+        int64_t publish_ns = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t played = 0; played < moves; played++) {
+            MoveGenerator::MoveList legal;
+            if (MoveGenerator::generate(position, legal) == 0 || plies == 200) {
+                board.setPosition(MoveGenerator::startingPosition());
+                position = MoveGenerator::startingPosition();
+                plies = 0;
+                MoveGenerator::generate(position, legal);
+            }
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            const MoveGenerator::MoveWord move = legal.moves[seed % legal.size];
+            const int from = MoveGenerator::fromSquare(move);
+            const int to = MoveGenerator::toSquare(move);
+            board.makeMove(Move({from / 8, from % 8}, {to / 8, to % 8}, nullptr));
+            MoveGenerator::apply(position, move);
+            plies++;
+
+            auto published = std::chrono::steady_clock::now();
+            if (locked) {
+                std::lock_guard<std::mutex> guard(mutex);
+                shared = board.getPosition();
+                shared_plies = plies;
+            } else {
+                board.publish(view);
+            }
+            publish_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - published).count();
+        }
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        done = true;
+        for (std::thread& thread : threads) { thread.join(); }
+
+        std::cout << (locked ? "Mutex:     " : "Seqlock:   ") << moves << " moves in " << elapsed << " ms, publish ns per move: "
+                  << (moves ? publish_ns / static_cast<int64_t>(moves) : 0) << ", reads: " << reads << " ("
+                  << (elapsed ? reads * 1000 / elapsed : 0) << "/s), torn: " << torn << std::endl;
+        if (torn) { return 1; }
+    }
+    return 0;
+}
+
+/**
+ * @brief Plays `games` bot-vs-bot games at once, every move searched under a budget of
+ *        `budget` ms: first on a SearchScheduler with `workers` threads, then with one
+ *        thread per game (each with its own search and table), and reports the move
+ *        latencies of both: `main bots <games> [budget ms] [workers] [plies]`
+ * @return 0
+ */
+int playBots(int argc, char* argv[]) {
+    const size_t games = std::stoul(argv[2]);
+    const int64_t budget = (argc > 3) ? std::stoll(argv[3]) : 100;
+    const int workers = (argc > 4) ? std::stoi(argv[4]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const uint32_t plies = (argc > 5) ? std::stoul(argv[5]) : 10;
+
+    struct Game {
+        Position position;
+        uint32_t plies = 0;
+    };
+    auto report = [budget](const char* name, std::vector<int64_t>& latencies, const uint64_t& depths, const int64_t& elapsed) {
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&latencies](const double& p) {
+            return latencies.empty() ? 0.0 : latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))] / 1000.0;
+        };
+        const size_t late = latencies.end() - std::upper_bound(latencies.begin(), latencies.end(), budget * 1000);
+        std::cout << name << latencies.size() << " moves in " << elapsed << " ms, mean depth "
+                  << std::fixed << std::setprecision(2) << (latencies.empty() ? 0.0 : static_cast<double>(depths) / latencies.size())
+                  << ", latency (ms): p50 " << std::setprecision(1) << percentile(0.5) << ", p99 " << percentile(0.99)
+                  << ", max " << (latencies.empty() ? 0.0 : latencies.back() / 1000.0) << ", late: " << late << std::endl;
+    };
+
+    // Two pseudo-random plies first, so the games do not all search the same positions
+    std::vector<Position> openings(games, MoveGenerator::startingPosition());
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (Position& opening : openings) {
+        for (int ply = 0; ply < 2; ply++) {
+            MoveGenerator::MoveList legal;
+            MoveGenerator::generate(opening, legal);
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            MoveGenerator::apply(opening, legal.moves[seed % legal.size]);
+        }
+    }
+
+    // Scheduled: each result plays its move and submits the game's next position
+    {
+        std::vector<Game> boards(games);
+        std::vector<int64_t> latencies;
+        uint64_t depths = 0;
+        std::mutex mutex;
+        SearchScheduler scheduler(workers, 64);
+
+        std::function<void(const SearchScheduler::Result&)> next;
+        next = [&](const SearchScheduler::Result& result) {
+            Game& game = boards[result.game];
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                latencies.push_back(result.latency_us);
+                depths += result.depth;
+            }
+            if (result.line.moves.empty()) { return; }
+            const Move& move = result.line.moves.front();
+            MoveGenerator::apply(game.position, MoveGenerator::pack(move.getOriginalPosition().first * 8 + move.getOriginalPosition().second,
+                                                                   move.getTargetPosition().first * 8 + move.getTargetPosition().second));
+            if (++game.plies < plies) { scheduler.submit(result.game, game.position, budget, next); }
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < games; i++) {
+            boards[i].position = openings[i];
+            scheduler.submit(i, boards[i].position, budget, next);
+        }
+        scheduler.waitIdle();
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Games: " << games << ", budget: " << budget << " ms per move, " << plies << " plies each" << std::endl;
+        report(("Scheduler (" + std::to_string(scheduler.workerCount()) + " workers): ").c_str(), latencies, depths, elapsed);
+    }
+
+    // One thread per game, each searching with the budget as its move time
+    {
+        std::vector<int64_t> latencies;
+        uint64_t depths = 0;
+        std::mutex mutex;
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < games; i++) {
+            threads.emplace_back([&, i]() {
+                TranspositionTable table(1);
+                Search search(table);
+                ChessBoard board(openings[i]);
+                SearchLimits limits;
+                limits.movetime = budget;
+                for (uint32_t ply = 0; ply < plies; ply++) {
+                    int depth = 0;
+                    auto submitted = std::chrono::steady_clock::now();
+                    std::vector<PVLine> lines = search.run(board, limits, [&depth](const SearchReport& iteration) { depth = iteration.depth; });
+                    int64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - submitted).count();
+                    {
+                        std::lock_guard<std::mutex> guard(mutex);
+                        latencies.push_back(latency);
+                        depths += depth;
+                    }
+                    if (lines.empty()) { break; }
+                    board.makeMove(lines[0].moves[0]);
+                }
+            });
+        }
+        for (std::thread& thread : threads) { thread.join(); }
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        report("Thread per game:         ", latencies, depths, elapsed);
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs perft, bench or a search with the profiler's timing zones, and writes them as a
+ *        Chrome trace and as folded stacks:
+ *        `main trace <trace.json> <stacks.folded> <perft | bench | search> [arguments of that command]`
+ * @return The exit code of the command, or 2 if there is no such command or the outputs can not be written.
+ */
+int traceZones(int argc, char* argv[]) {
+    Workload workload = findWorkload(argc - 3, argv + 3);
+    if (!workload) {
+        std::cerr << "Usage: main trace <trace.json> <stacks.folded> <perft <depth> [fen] | bench [depth] | search <depth> [fen] [threads]>" << std::endl;
+        return 2;
+    }
+    if (!Profiler::ENABLED) {
+        std::cerr << "Timing zones are compiled out: rebuild with `make clean && make PROFILE=1`" << std::endl;
+    }
+
+    std::ofstream trace(argv[2]);
+    std::ofstream folded(argv[3]);
+    if (!trace || !folded) {
+        std::cerr << "Cannot write " << (trace ? argv[3] : argv[2]) << std::endl;
+        return 2;
+    }
+
+    uint64_t nodes = 0;
+    Profiler::reset();
+    int code = workload(argc - 3, argv + 3, nodes);
+
+    size_t zones = Profiler::writeChromeTrace(trace);
+    size_t stacks = Profiler::writeFoldedStacks(folded);
+    std::cerr << "Wrote " << zones << " zones to " << argv[2] << " and " << stacks << " stacks to " << argv[3] << std::endl;
+    return code;
+}
+
+int main(int argc, char* argv[]) {
+
+    if (argc > 2 && std::string(argv[1]) == "mate") { return solveMate(argc, argv); }
+    if (argc > 2 && std::string(argv[1]) == "annotate") { return annotateGames(argc, argv); }
+    if (argc > 2 && std::string(argv[1]) == "puzzles") { return minePuzzles(argc, argv); }
+    if (argc > 3 && std::string(argv[1]) == "match") { return playMatch(argc, argv); }
+    if (argc > 2 && std::string(argv[1]) == "epd") { return runSuite(argc, argv); }
+
+    uint64_t nodes = 0;
+    if (argc > 1 && std::string(argv[1]) == "bench") { return runBench(argc, argv, nodes); }
+    if (argc > 2 && std::string(argv[1]) == "perft") { return runPerft(argc, argv, nodes); }
+    if (argc > 2 && std::string(argv[1]) == "search") { return runSearch(argc, argv, nodes); }
+    if (argc > 2 && std::string(argv[1]) == "perf") { return measureCounters(argc, argv); }
+    if (argc > 2 && std::string(argv[1]) == "allocs") { return countAllocations(argc, argv); }
+    if (argc > 1 && std::string(argv[1]) == "--memstats") { return reportMemory(argc, argv); }
+    if (argc > 2 && std::string(argv[1]) == "host") { return hostGames(argc, argv); }
+    if (argc > 2 && std::string(argv[1]) == "validate") { return validateMoves(argc, argv); }
+    if (argc > 2 && std::string(argv[1]) == "timers") { return simulateClocks(argc, argv); }
+    if (argc > 1 && std::string(argv[1]) == "wal") { return replayLog(argc, argv); }
+    if (argc > 2 && std::string(argv[1]) == "snapshot") { return snapshotBoards(argc, argv); }
+    if (argc > 2 && std::string(argv[1]) == "views") { return readViews(argc, argv); }
+    if (argc > 2 && std::string(argv[1]) == "bots") { return playBots(argc, argv); }
+    if (argc > 4 && std::string(argv[1]) == "trace") { return traceZones(argc, argv); }
+    if (argc > 1 && std::string(argv[1]) == "uci") {
+        SearchStats::installSignalHandler();
+        UCI protocol;
+        protocol.loop(std::cin);
+        return 0;
+    }
 
     ChessBoard board1;
 
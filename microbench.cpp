@@ -0,0 +1,215 @@
+/*
+Micro-benchmarks of the board primitives: `microbench [--json] [--reps N] [--filter text]`
+
+Every benchmark times one primitive in a loop. It is first warmed up, then the
+number of calls per repetition is calibrated so a repetition lasts about
+TARGET_REP_MS. Each of the repetitions gives one nanoseconds-per-call sample, and
+the samples are summarized as min / median / mean / standard deviation / max.
+
+The table is written to stderr. With --json, a JSON report (stable key order, one
+benchmark per line) is written to stdout so runs can be diffed across commits.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "ChessBoard.hpp"
+#include "Evaluation.hpp"
+
+namespace {
+    const double WARMUP_MS = 50.0;
+    const double TARGET_REP_MS = 20.0;
+    const int DEFAULT_REPS = 15;
+
+    // A middlegame with every piece type on the board for both players
+    const std::string BENCH_FEN = "r2kqb1r/ppp2ppp/2n2n2/3ppb2/3P4/2N1BN2/PPP1PPPP/R1K1QB1R w - - 0 1";
+
+    /*
+    Keeps the compiler from optimizing away a result that is never used.
+    */
+    template <typename T>
+    void keep(const T& value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    /*
+    The samples of one benchmark, in nanoseconds per call.
+    */
+    struct Measurement {
+        std::string name;
+        uint64_t calls = 0;           // Calls per repetition
+        std::vector<double> samples;  // One per repetition, sorted
+
+        double median() const { return samples[samples.size() / 2]; }
+
+        double mean() const {
+            double sum = 0;
+            for (double sample : samples) { sum += sample; }
+            return sum / samples.size();
+        }
+
+        double stddev() const {
+            double average = mean();
+            double sum = 0;
+            for (double sample : samples) { sum += (sample - average) * (sample - average); }
+            return std::sqrt(sum / samples.size());
+        }
+    };
+
+    /*
+    Times `calls` calls of `body`, in milliseconds.
+    */
+    double timeCalls(const std::function<void()>& body, const uint64_t& calls) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < calls; i++) { body(); }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /*
+    Warms up, calibrates and measures `body`, which performs `per_body` calls of the primitive.
+    */
+    Measurement measure(const std::string& name, const int& per_body, const int& reps, const std::function<void()>& body) {
+        Measurement measurement;
+        measurement.name = name;
+
+        // Warm up (caches, branch predictors, CPU frequency) while doubling the call count
+        uint64_t calls = 1;
+        double elapsed = 0;
+        for (double warm = 0; warm < WARMUP_MS; warm += elapsed) {
+            elapsed = timeCalls(body, calls);
+            if (elapsed < TARGET_REP_MS) { calls *= 2; }
+        }
+        calls = std::max<uint64_t>(1, static_cast<uint64_t>(calls * TARGET_REP_MS / std::max(elapsed, 1e-3)));
+        measurement.calls = calls * per_body;
+
+        for (int rep = 0; rep < reps; rep++) {
+            double ms = timeCalls(body, calls);
+            measurement.samples.push_back(ms * 1e6 / measurement.calls);
+        }
+        std::sort(measurement.samples.begin(), measurement.samples.end());
+        return measurement;
+    }
+
+    /*
+    Gets a piece of type `type` for Player One on `board` (there is one of every type in BENCH_FEN).
+    */
+    ChessPiece* findPiece(const ChessBoard& board, const std::string& type) {
+        for (int row = 0; row < 8; row++) {
+            for (int col = 0; col < 8; col++) {
+                ChessPiece* piece = board.getCell(row, col);
+                if (piece && piece->getType() == type && board.pieceKind(piece) < 6) { return piece; }
+            }
+        }
+        return nullptr;
+    }
+
+    std::string json(const Measurement& m) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3)
+            << "{\"name\":\"" << m.name << "\",\"calls\":" << m.calls << ",\"reps\":" << m.samples.size()
+            << ",\"ns_per_call\":{\"min\":" << m.samples.front() << ",\"median\":" << m.median()
+            << ",\"mean\":" << m.mean() << ",\"stddev\":" << m.stddev() << ",\"max\":" << m.samples.back() << "}}";
+        return out.str();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool as_json = false;
+    int reps = DEFAULT_REPS;
+    std::string filter;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json") { as_json = true; }
+        else if (arg == "--reps" && i + 1 < argc) { reps = std::max(1, std::stoi(argv[++i])); }
+        else if (arg == "--filter" && i + 1 < argc) { filter = argv[++i]; }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--json] [--reps N] [--filter text]" << std::endl;
+            return 2;
+        }
+    }
+
+    ChessBoard board;
+    board.loadFEN(BENCH_FEN);
+    const std::vector<std::vector<ChessPiece*>> cells = board.getBoardState();
+    const std::vector<Move> legal = board.generateMoves();
+
+    // Every benchmark: its name, the primitive calls per body, and the body
+    std::vector<std::tuple<std::string, int, std::function<void()>>> benchmarks;
+
+    benchmarks.emplace_back("getCell", 64, [&board]() {
+        for (int row = 0; row < 8; row++) {
+            for (int col = 0; col < 8; col++) { keep(board.getCell(row, col)); }
+        }
+    });
+
+    for (const std::string type : {"PAWN", "KNIGHT", "BISHOP", "ROOK", "QUEEN", "KING"}) {
+        const ChessPiece* piece = findPiece(board, type);
+        benchmarks.emplace_back("canMove/" + type, 64, [piece, &cells]() {
+            for (int row = 0; row < 8; row++) {
+                for (int col = 0; col < 8; col++) { keep(piece->canMove(row, col, cells)); }
+            }
+        });
+    }
+
+    // move() validates and moves without changing the turn, so a Knight can go f3 -> h4 -> f3
+    benchmarks.emplace_back("move", 2, [&board]() {
+        keep(board.move(2, 5, 3, 7));
+        keep(board.move(3, 7, 2, 5));
+    });
+
+    benchmarks.emplace_back("makeMove+unmakeMove", static_cast<int>(legal.size()), [&board, &legal]() {
+        for (const Move& move : legal) {
+            board.makeMove(move);
+            board.unmakeMove();
+        }
+    });
+
+    benchmarks.emplace_back("generateMoves", 1, [&board]() { keep(board.generateMoves()); });
+    benchmarks.emplace_back("computeHash", 1, [&board]() { keep(board.computeHash()); });
+    benchmarks.emplace_back("evaluate", 1, [&board]() { keep(Evaluation::evaluate(board)); });
+
+    ChessBoard parsed;
+    benchmarks.emplace_back("loadFEN", 1, [&parsed]() { keep(parsed.loadFEN(BENCH_FEN)); });
+    benchmarks.emplace_back("toFEN", 1, [&board]() { keep(board.toFEN()); });
+
+    // Rendering is measured without the cost of the terminal
+    std::ostringstream sink;
+    benchmarks.emplace_back("display", 1, [&board, &sink]() {
+        std::streambuf* console = std::cout.rdbuf(sink.rdbuf());
+        board.display();
+        std::cout.rdbuf(console);
+        sink.str("");
+    });
+
+    std::vector<Measurement> results;
+    std::cerr << std::left << std::setw(24) << "benchmark" << std::right
+              << std::setw(12) << "min ns" << std::setw(12) << "median ns" << std::setw(12) << "mean ns"
+              << std::setw(10) << "stddev" << std::setw(12) << "max ns" << std::endl;
+    for (const auto& [name, per_body, body] : benchmarks) {
+        if (name.find(filter) == std::string::npos) { continue; }
+
+        Measurement m = measure(name, per_body, reps, body);
+        std::cerr << std::left << std::setw(24) << m.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << m.samples.front() << std::setw(12) << m.median() << std::setw(12) << m.mean()
+                  << std::setw(10) << m.stddev() << std::setw(12) << m.samples.back() << std::endl;
+        results.push_back(m);
+    }
+
+    if (as_json) {
+        std::cout << "{\"fen\":\"" << BENCH_FEN << "\",\"reps\":" << reps << ",\"benchmarks\":[" << std::endl;
+        for (size_t i = 0; i < results.size(); i++) {
+            std::cout << json(results[i]) << (i + 1 < results.size() ? "," : "") << std::endl;
+        }
+        std::cout << "]}" << std::endl;
+    }
+    return 0;
+}
@@ -181,6 +181,15 @@ void ChessPiece::flagMoved() {
     has_moved_ = true;
 }
 
+/**
+* @brief Sets a ChessPiece's `has_moved_` member to the given value
+* @param flag A const reference to a boolean representing whether the piece has moved.
+*     Used to restore the flag when a move is taken back.
+*/
+void ChessPiece::setMoved(const bool& flag) {
+    has_moved_ = flag;
+}
+
 /**
 * @brief Determines whether a ChessPiece has moved on the board
 * @return The value stored in the `has_moved_` member
@@ -167,4 +167,11 @@ class ChessPiece {
     * @brief Sets a ChessPiece's `has_moved_` member to true
     */
    void flagMoved();
+
+   /**
+    * @brief Sets a ChessPiece's `has_moved_` member to the given value
+    * @param flag A const reference to a boolean representing whether the piece has moved.
+    *     Used to restore the flag when a move is taken back.
+    */
+   void setMoved(const bool& flag);
 };
\ No newline at end of file
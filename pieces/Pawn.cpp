@@ -57,7 +57,8 @@ bool Pawn::canMove(const int& target_row, const int& target_col, const std::vect
     int direction = isMovingUp() ? 1 : -1;
     bool can_move_straight = 
         (!target_piece && getColumn() == target_col) && // Is moving straight (and there is noe obstructing piece)
-        ((getRow() + direction == target_row) || (canDoubleJump() && getRow() + direction * 2 == target_row)); // Is moving by 1 or 2 rows (depending on the canDoubleJump flag)
+        ((getRow() + direction == target_row) || (canDoubleJump() && getRow() + direction * 2 == target_row && // Is moving by 1 or 2 rows (depending on the canDoubleJump flag)
+            !board[getRow() + direction][target_col])); // A double jump cannot pass over a piece
 
 
     bool can_capture_diagonal =
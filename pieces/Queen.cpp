@@ -41,11 +41,16 @@ bool Queen::canMove(const int& target_row, const int& target_col, const std::vec
     int row_offset = (dx) ? dx / std::abs(dx) : 0;
     int col_offset = (dy) ? dy / std::abs(dy) : 0;
 
-    // Iterate from the target space to the original space and check if there is any obstructing Chess Piece
-    while ((dx -= row_offset) != 0 && (dy -= col_offset) != 0) {
+    // Iterate from the target space to the original space and check if there is any obstructing Chess Piece.
+    // Both offsets are stepped together so straight lines (where one offset is 0) are walked as well.
+    dx -= row_offset;
+    dy -= col_offset;
+    while (dx != 0 || dy != 0) {
         if (board[getRow() + dx][getColumn() + dy]) {
             return false;
         }
+        dx -= row_offset;
+        dy -= col_offset;
     }
 
     return true;
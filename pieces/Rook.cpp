@@ -91,9 +91,11 @@ bool Rook::canMove(const int& target_row, const int& target_col, const std::vect
     int temp_row = getRow();
     int temp_col = getColumn();
 
-    while (temp_row != target_row || temp_col != target_col) {
+    // The target itself may hold an enemy piece (checked above), so only the cells in between are inspected
+    while (true) {
         temp_row += increment_row;
         temp_col += increment_col;
+        if (temp_row == target_row && temp_col == target_col) { break; }
         if (board[temp_row][temp_col]) { return false; }
     }
 
@@ -0,0 +1,66 @@
+/*
+Game server: `server [--tcp port] [--unix path] [--shards n] [--validators n]`
+
+Serves games with GameServer (see GameServer.hpp for the protocol) until SIGINT or
+SIGTERM. Without --tcp or --unix it listens on TCP port 7070. The shards and the
+move validation workers default to one per hardware thread.
+*/
+
+#include <algorithm>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "GameServer.hpp"
+
+namespace {
+    const int DEFAULT_PORT = 7070;
+
+    GameServer* running_server = nullptr;
+
+    /*
+    Stops the event loop, which then closes every connection.
+    */
+    void handleSignal(int) {
+        if (running_server) { running_server->stop(); }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    GameServer::Options options;
+    options.shards = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    options.validators = options.shards;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--tcp" && i + 1 < argc) { options.port = std::stoi(argv[++i]); }
+        else if (arg == "--unix" && i + 1 < argc) { options.unix_path = argv[++i]; }
+        else if (arg == "--shards" && i + 1 < argc) { options.shards = std::stoi(argv[++i]); }
+        else if (arg == "--validators" && i + 1 < argc) { options.validators = std::stoi(argv[++i]); }
+        else {
+            std::cerr << "Usage: server [--tcp port] [--unix path] [--shards n] [--validators n]" << std::endl;
+            return 2;
+        }
+    }
+    if (!options.port && options.unix_path.empty()) { options.port = DEFAULT_PORT; }
+
+    GameServer server(options);
+    if (!server.start()) {
+        std::cerr << "server: " << server.error() << std::endl;
+        return 1;
+    }
+
+    running_server = &server;
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    std::cerr << "Serving games on";
+    if (options.port) { std::cerr << " 127.0.0.1:" << options.port; }
+    if (!options.unix_path.empty()) { std::cerr << " " << options.unix_path; }
+    std::cerr << " with " << options.shards << " shards and " << options.validators << " validators" << std::endl;
+
+    server.run();
+    running_server = nullptr;
+    return 0;
+}